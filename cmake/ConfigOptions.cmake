@@ -1,4 +1,5 @@
 OPTION(DISABLE_EXAMPLES "Disable Compile examples" OFF)
+OPTION(DISABLE_TOOLS "Disable Compile log tools" OFF)
 OPTION(WITH_JSON_FORMATTING "Enable JSON log formatting." OFF)
 OPTION(WITH_AWS "Enables AWS cloudwatch sink and system logger support" OFF)
 OPTION(WITH_PERFORMANCE_TESTS "Enables Performance tests" OFF)
@@ -0,0 +1,102 @@
+/**
+ * @file clock.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef CLOCK_HPP_
+#define CLOCK_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace octo::logger
+{
+class Clock;
+typedef std::shared_ptr<Clock> ClockPtr;
+
+/**
+ * @brief Source of the record timestamps (ManagerConfig::LoggerOption::CLOCK or Manager::set_clock).
+ */
+class Clock
+{
+  public:
+    using TimePoint = std::chrono::time_point<std::chrono::system_clock>;
+
+    enum class ClockType : std::uint8_t
+    {
+        SYSTEM = 0,
+        // CLOCK_REALTIME_COARSE, the time of the last tick (a few milliseconds resolution) read from the vDSO
+        REALTIME_COARSE = 1,
+        // The invariant TSC, converted to wall time with a calibration that is re-synced once a second
+        TSC = 2,
+    };
+
+  private:
+    static std::atomic<Clock*> active_;
+
+  public:
+    virtual ~Clock() = default;
+
+    [[nodiscard]] virtual TimePoint now() noexcept = 0;
+    // Called in the child after fork, before anything is logged
+    virtual void child_on_fork() noexcept
+    {
+    }
+
+    /**
+     * @brief Creates a clock of the given type, falling back to SYSTEM where it isn't available.
+     */
+    [[nodiscard]] static ClockPtr create(ClockType type);
+
+    /**
+     * @brief The time for a new record, from the active clock.
+     */
+    [[nodiscard]] static TimePoint record_time() noexcept
+    {
+        Clock* const clock = active_.load(std::memory_order_acquire);
+        return clock != nullptr ? clock->now() : std::chrono::system_clock::now();
+    }
+
+    /**
+     * @brief Sets the clock used by record_time, nullptr for std::chrono::system_clock.
+     * The caller keeps the clock alive while it may still be in use (see Manager::set_clock).
+     */
+    static void set_active(Clock* clock) noexcept;
+    [[nodiscard]] static Clock* active() noexcept;
+};
+
+class SystemClock : public Clock
+{
+  public:
+    [[nodiscard]] TimePoint now() noexcept override;
+};
+
+/**
+ * @brief Clock set by hand, for deterministic tests and benchmarks.
+ *
+ * Every call to now() advances the time by step, so records taken one after the other still have increasing
+ * timestamps when step isn't zero.
+ */
+class FakeClock : public Clock
+{
+  private:
+    std::atomic<std::int64_t> now_ns_;
+    std::atomic<std::int64_t> step_ns_;
+
+  public:
+    explicit FakeClock(TimePoint start = TimePoint(), std::chrono::nanoseconds step = std::chrono::nanoseconds(0));
+
+    [[nodiscard]] TimePoint now() noexcept override;
+    void set(TimePoint time) noexcept;
+    void advance(std::chrono::nanoseconds duration) noexcept;
+    void set_step(std::chrono::nanoseconds step) noexcept;
+};
+} // namespace octo::logger
+
+#endif // CLOCK_HPP_
@@ -11,7 +11,10 @@
 
 #ifndef COMPAT_HPP
 #define COMPAT_HPP
+#include <cstdint>
 #include <ctime>
+#include <string>
+#include <string_view>
 #ifdef _WIN32
 #include <cerrno>
 #endif
@@ -23,10 +26,8 @@ namespace octo::logger::compat
 // The reason is that localtime/gmtime internally use __tz_convert, which locks.
 // Upon fork, in rare occasions, the child process may inherit the lock,
 // causing a deadlock if the child process tries to call localtime.
-// To avoid this, we use an internal function that does not lock.
-// This is a partial implementation that matches most needs, but does not handle all use cases, 
-// like daylight saving time, and leap seconds.
-// That is why we use it only in case of utc, with the assumption that the timezone is intentional.
+// To avoid this, we use internal functions that do not lock: gmtime_safe for a fixed offset from UTC,
+// and TimeZone (time-zone.hpp) for the local zone, DST included, loaded from tzdata once.
 void gmtime_safe_internal(time_t time, long timezone, struct tm *tm_time);
 
 inline struct tm *gmtime_safe(const time_t time, struct tm *tm_time)
@@ -36,13 +37,28 @@ inline struct tm *gmtime_safe(const time_t time, struct tm *tm_time)
     return tm_time;
 }
 
-inline struct tm* localtime(time_t const* timep, struct tm* result, bool safe_utc = false)
+// How timestamps are converted to calendar time (USE_SAFE_LOCALTIME_UTC / USE_SAFE_LOCALTIME)
+enum class LocaltimeMode : std::uint8_t
 {
-    if (safe_utc)
+    SYSTEM = 0,     // localtime_r
+    SAFE_UTC = 1,   // gmtime_safe
+    SAFE_LOCAL = 2, // TimeZone::local(), falls back to localtime_s on Windows
+};
+
+// @brief Fork safe local time of the process zone, see TimeZone::local
+struct tm* localtime_safe(time_t time, struct tm* result);
+
+inline struct tm* localtime(time_t const* timep, struct tm* result, LocaltimeMode mode)
+{
+    if (mode == LocaltimeMode::SAFE_UTC)
     {
         return gmtime_safe(*timep, result);
     }
 #ifndef _WIN32
+    if (mode == LocaltimeMode::SAFE_LOCAL)
+    {
+        return localtime_safe(*timep, result);
+    }
     return localtime_r(timep, result);
 #else
     errno = localtime_s(result, timep);
@@ -50,6 +66,41 @@ inline struct tm* localtime(time_t const* timep, struct tm* result, bool safe_ut
 #endif
 }
 
+inline struct tm* localtime(time_t const* timep, struct tm* result, bool safe_utc = false)
+{
+    return localtime(timep, result, safe_utc ? LocaltimeMode::SAFE_UTC : LocaltimeMode::SYSTEM);
+}
+
+// @brief Number of days since 1970-01-01 of a proleptic gregorian date (month is 1-12)
+constexpr std::int64_t days_from_civil(std::int64_t year, unsigned month, unsigned day) noexcept
+{
+    // See http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+    year -= month <= 2;
+    std::int64_t const era = (year >= 0 ? year : year - 399) / 400;
+    auto const yoe = static_cast<unsigned>(year - era * 400);
+    unsigned const doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned const doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+// @brief Fills the calendar fields of tm_time (all but tm_isdst and the zone) from seconds since the epoch
+void civil_from_seconds(std::int64_t seconds, struct tm* tm_time) noexcept;
+
+// @brief The OS level id of the calling thread (the one shown by tools like top/gdb), unlike std::thread::id
+std::uint64_t current_thread_id() noexcept;
+
+// @brief std::this_thread::get_id() as printed by operator<<, formatted once per thread
+std::string const& thread_id_string();
+
+// @brief The name of the calling thread (pthread_getname_np), read once per thread, empty where unsupported
+std::string const& thread_name();
+
+// @brief getpid() as a string, cached process wide, see refresh_process_id
+std::string_view process_id_string() noexcept;
+
+// @brief Re-reads the cached pid, called in the child after fork (Manager::child_on_fork)
+void refresh_process_id() noexcept;
+
 } // namespace octo::logger::compat
 
 #endif // COMPAT_HPP
\ No newline at end of file
@@ -12,50 +12,315 @@
 #ifndef CONTEXT_INFO_HPP_
 #define CONTEXT_INFO_HPP_
 
-#include <unordered_map>
+#include "octo-logger-cpp/context-value.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
 #include <string>
 #include <string_view>
-#include <sstream>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace octo::logger
 {
 
+/**
+ * @brief Key/value pairs attached to records, kept in a flat array sorted by interned key id.
+ *
+ * Keys are interned in a process wide table the first time they are seen, so the entries own nothing but their
+ * values and never borrow the caller's key. Up to INLINE_CAPACITY entries are stored inline, without allocating.
+ * Iteration is in key id order (the order in which the keys were first interned).
+ *
+ * A context may also inherit the entries of an immutable parent (see Logger::with), which its own entries hide. The
+ * container methods only see the context's own entries, the sinks walk the whole chain when they render it.
+ */
 class ContextInfo final
 {
   public:
     typedef std::string_view ContextInfoKey;
-    typedef std::string ContextInfoValue;
-    typedef std::unordered_map<ContextInfoKey, ContextInfoValue> ContextInfoType;
-    typedef std::initializer_list<ContextInfoType::value_type> ContextInfoInitializerList;
+    typedef ContextValue ContextInfoValue;
+    typedef std::uint32_t ContextInfoKeyId;
+    typedef std::pair<ContextInfoKey const, ContextInfoValue> ContextInfoInitializerValue;
+    typedef std::initializer_list<ContextInfoInitializerValue> ContextInfoInitializerList;
+
+    static constexpr std::size_t INLINE_CAPACITY = 6;
+    // The most parents a context has, deeper parents are flattened by set_parent
+    static constexpr std::size_t MAX_CHAIN_DEPTH = 4;
+
+    struct Entry
+    {
+        ContextInfoKeyId id = 0;
+        // Points into the interning table, valid for the lifetime of the process
+        ContextInfoKey key;
+        ContextInfoValue value;
+    };
+
+    /**
+     * @brief The entries rendered for the sinks, built on first use and kept until the context is modified.
+     *
+     * The logger and global contexts change rarely compared to how often they are logged, so sinks splice these
+     * instead of formatting the entries of every record.
+     */
+    struct Fragments
+    {
+        // [key:value] per entry, the plaintext context_info layout
+        std::string plaintext;
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+        // Per entry, in entry order, the key and the value encoded as JSON
+        std::vector<std::string> json_keys;
+        std::vector<std::string> json_values;
+        // false if a key or a value is not valid UTF-8
+        bool json_valid = true;
+#endif
+    };
+
+    class const_iterator
+    {
+      private:
+        Entry const* entry_;
+
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::pair<ContextInfoKey, ContextInfoValue const&> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef value_type reference;
+
+        struct pointer
+        {
+            value_type pair;
+            value_type const* operator->() const
+            {
+                return &pair;
+            }
+        };
+
+        explicit const_iterator(Entry const* entry = nullptr) : entry_(entry)
+        {
+        }
+
+        reference operator*() const
+        {
+            return {entry_->key, entry_->value};
+        }
+        pointer operator->() const
+        {
+            return {**this};
+        }
+        [[nodiscard]] Entry const& entry() const
+        {
+            return *entry_;
+        }
+        const_iterator& operator++()
+        {
+            ++entry_;
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator previous(*this);
+            ++entry_;
+            return previous;
+        }
+        bool operator==(const_iterator const& other) const
+        {
+            return entry_ == other.entry_;
+        }
+        bool operator!=(const_iterator const& other) const
+        {
+            return entry_ != other.entry_;
+        }
+    };
+    typedef const_iterator iterator;
 
   private:
-    ContextInfoType context_info_;
+    std::array<Entry, INLINE_CAPACITY> inline_entries_;
+    // Holds all the entries once there are more than INLINE_CAPACITY
+    std::vector<Entry> heap_entries_;
+    std::uint32_t size_;
+    bool on_heap_;
+    mutable std::atomic<Fragments const*> fragments_;
+    std::shared_ptr<ContextInfo const> parent_;
+
+    [[nodiscard]] Entry* entries();
+    [[nodiscard]] Entry const* entries() const;
+    // The first entry with an id not less than id
+    [[nodiscard]] std::size_t lower_bound(ContextInfoKeyId id) const;
+    [[nodiscard]] Entry const* find(ContextInfoKey key) const;
+    void insert_at(std::size_t pos, ContextInfoKeyId id, ContextInfoKey key, ContextInfoValue value);
+    void set(ContextInfoKeyId id, ContextInfoKey key, ContextInfoValue value, bool overwrite);
+    // Drops the rendered fragments, called by every modification
+    void invalidate();
+
+    // Flattens its entries with insert_at, in id order
+    friend class PersistentContextMap;
 
   public:
-    ~ContextInfo() = default;
-    ContextInfo() = default;
+    ~ContextInfo();
+    ContextInfo();
     /* implicit */ ContextInfo(ContextInfoInitializerList init);
 
-    ContextInfo(ContextInfo&&) = default;
-    ContextInfo& operator=(ContextInfo&&) = default;
-    ContextInfo(ContextInfo const&) = default;
-    ContextInfo& operator=(ContextInfo const&) = default;
+    ContextInfo(ContextInfo&& other) noexcept;
+    ContextInfo& operator=(ContextInfo&& other) noexcept;
+    ContextInfo(ContextInfo const& other);
+    ContextInfo& operator=(ContextInfo const& other);
     [[nodiscard]] bool operator==(ContextInfo const& other) const;
     void update(ContextInfoKey key, ContextInfoValue value);
+    // Sets the entries of other and of its parents, the nearest one of each key
     void update(ContextInfo const& other);
     void erase(ContextInfoKey const& key);
     [[nodiscard]] bool empty() const;
+    [[nodiscard]] std::size_t size() const;
+    // Lock free, unless keys were interned since the last lookup of a key the thread had not seen
     [[nodiscard]] bool contains(ContextInfoKey const& key) const;
     [[nodiscard]] ContextInfoValue at(ContextInfoKey const& key) const;
+    // The entry of a key interned beforehand (see intern), nullptr if there is none, without looking the key up
+    [[nodiscard]] Entry const* entry(ContextInfoKeyId id) const;
     void clear();
-    [[nodiscard]] ContextInfoType::iterator begin();
-    [[nodiscard]] ContextInfoType::iterator end();
-    [[nodiscard]] ContextInfoType::const_iterator begin() const;
-    [[nodiscard]] ContextInfoType::const_iterator end() const;
-    [[nodiscard]] ContextInfoType::const_iterator cbegin() const;
-    [[nodiscard]] ContextInfoType::const_iterator cend() const;
+    [[nodiscard]] const_iterator begin() const;
+    [[nodiscard]] const_iterator end() const;
+    [[nodiscard]] const_iterator cbegin() const;
+    [[nodiscard]] const_iterator cend() const;
+    // Thread safe, concurrent first calls may both render, one of the results is kept
+    [[nodiscard]] Fragments const& fragments() const;
+
+    // nullptr when the context has no parent
+    [[nodiscard]] ContextInfo const* parent() const;
+    // Inherits the entries of parent, flattening its chain if it is already MAX_CHAIN_DEPTH deep
+    void set_parent(std::shared_ptr<ContextInfo const> parent);
+    // The number of parents up the chain
+    [[nodiscard]] std::size_t chain_depth() const;
+    // No entries of its own nor inherited
+    [[nodiscard]] bool chain_empty() const;
+    // Whether the context or one of its parents has the key
+    [[nodiscard]] bool chain_contains(ContextInfoKey const& key) const;
+    // The entries of the whole chain (the nearest one of each key) in a context without a parent
+    [[nodiscard]] ContextInfo flattened() const;
+
+    /**
+     * @brief The id of key in the interning table, adding it if needed.
+     * Lookups are served from a per thread cache, only the first lookup of a key in a thread takes the table lock.
+     */
+    [[nodiscard]] static ContextInfoKeyId intern(ContextInfoKey key, ContextInfoKey* interned_key = nullptr);
+    // Resets the interning table lock in the child after fork (Manager::child_on_fork)
+    static void child_on_fork();
+
+    /**
+     * @brief Calls fn(entry) once per key present in any of contexts, in key id order, with the entry of the first
+     * context (the one with the highest precedence) that has it. A linear merge, there is no hashing involved.
+     * fn may also take (entry, context, index), the context the entry came from and its index there.
+     * The parents of each context follow it. A logger, its parent chain and the global context are merged without
+     * allocating, longer merges (e.g. two child loggers' contexts) allocate their cursors but drop no entry.
+     */
+    template <typename Fn>
+    static void merge(std::initializer_list<ContextInfo const*> contexts, Fn&& fn);
+
+  private:
+    // The links merged without allocating: the record's, the scoped, a logger's chain (MAX_CHAIN_DEPTH + 1) and the
+    // global context
+    static constexpr std::size_t MERGE_CAPACITY = 8;
+
+    // The k-way merge of the links of merge
+    template <typename Fn>
+    static void merge_sources(ContextInfo const* const* sources, std::size_t count, Fn&& fn);
 };
 
+template <typename Fn>
+void ContextInfo::merge(std::initializer_list<ContextInfo const*> contexts, Fn&& fn)
+{
+    ContextInfo const* sources[MERGE_CAPACITY];
+    std::size_t count = 0;
+    for (auto const* context : contexts)
+    {
+        for (ContextInfo const* link = context; link != nullptr; link = link->parent_.get())
+        {
+            if (link->empty())
+            {
+                continue;
+            }
+            if (count == MERGE_CAPACITY)
+            {
+                // More links than the sinks merge (e.g. a child logger's context logged as a record's), they are all
+                // merged from the heap rather than dropped
+                std::vector<ContextInfo const*> all_sources;
+                for (auto const* all_context : contexts)
+                {
+                    for (ContextInfo const* all_link = all_context; all_link != nullptr;
+                         all_link = all_link->parent_.get())
+                    {
+                        if (!all_link->empty())
+                        {
+                            all_sources.push_back(all_link);
+                        }
+                    }
+                }
+                merge_sources(all_sources.data(), all_sources.size(), std::forward<Fn>(fn));
+                return;
+            }
+            sources[count++] = link;
+        }
+    }
+    merge_sources(sources, count, std::forward<Fn>(fn));
+}
+
+template <typename Fn>
+void ContextInfo::merge_sources(ContextInfo const* const* sources, std::size_t count, Fn&& fn)
+{
+    Entry const* stack_cursors[2 * MERGE_CAPACITY];
+    std::vector<Entry const*> heap_cursors;
+    Entry const** cursors = stack_cursors;
+    if (count > MERGE_CAPACITY)
+    {
+        heap_cursors.resize(2 * count);
+        cursors = heap_cursors.data();
+    }
+    Entry const** const ends = cursors + count;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        cursors[i] = sources[i]->entries();
+        ends[i] = sources[i]->entries() + sources[i]->size_;
+    }
+    while (true)
+    {
+        Entry const* winner = nullptr;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (cursors[i] != ends[i] && (winner == nullptr || cursors[i]->id < winner->id))
+            {
+                winner = cursors[i];
+            }
+        }
+        if (winner == nullptr)
+        {
+            return;
+        }
+        ContextInfoKeyId const id = winner->id;
+        if constexpr (std::is_invocable_v<Fn, Entry const&, ContextInfo const&, std::size_t>)
+        {
+            std::size_t source = 0;
+            while (cursors[source] != winner)
+            {
+                ++source;
+            }
+            fn(*winner, *sources[source], static_cast<std::size_t>(winner - sources[source]->entries()));
+        }
+        else
+        {
+            fn(*winner);
+        }
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (cursors[i] != ends[i] && cursors[i]->id == id)
+            {
+                ++cursors[i];
+            }
+        }
+    }
+}
+
 } // namespace octo::logger
 
 #endif
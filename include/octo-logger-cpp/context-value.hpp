@@ -0,0 +1,165 @@
+/**
+ * @file context-value.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef CONTEXT_VALUE_HPP_
+#define CONTEXT_VALUE_HPP_
+
+#include <fmt/format.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+#include <nlohmann/json.hpp>
+#endif // OCTO_LOGGER_WITH_JSON_FORMATTING
+
+namespace octo::logger
+{
+/**
+ * @brief A context value: a string, a signed or unsigned integer, a double or a bool.
+ *
+ * Values keep their type until a sink serializes them, numbers are only formatted (with std::to_chars) then, and the
+ * JSON formats write them as JSON numbers and booleans instead of strings.
+ */
+class ContextValue
+{
+  public:
+    enum class Type : std::uint8_t
+    {
+        STRING = 0,
+        INT64 = 1,
+        UINT64 = 2,
+        DOUBLE = 3,
+        BOOL = 4,
+    };
+
+  private:
+    // Alternatives in the order of Type
+    std::variant<std::string, std::int64_t, std::uint64_t, double, bool> value_;
+
+  public:
+    ContextValue() = default;
+    ContextValue(std::string value) : value_(std::move(value))
+    {
+    }
+    ContextValue(std::string_view value) : value_(std::string(value))
+    {
+    }
+    ContextValue(char const* value) : value_(std::string(value))
+    {
+    }
+    template <typename T,
+              std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && std::is_signed_v<T>, int> = 0>
+    ContextValue(T value) : value_(static_cast<std::int64_t>(value))
+    {
+    }
+    template <typename T,
+              std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && std::is_unsigned_v<T>, int> = 0>
+    ContextValue(T value) : value_(static_cast<std::uint64_t>(value))
+    {
+    }
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+    ContextValue(T value) : value_(static_cast<double>(value))
+    {
+    }
+    template <typename T, std::enable_if_t<std::is_same_v<T, bool>, int> = 0>
+    ContextValue(T value) : value_(value)
+    {
+    }
+
+    [[nodiscard]] Type type() const
+    {
+        return static_cast<Type>(value_.index());
+    }
+    // The alternative of the type, the value is undefined for the other types
+    [[nodiscard]] std::string const& as_string() const
+    {
+        return *std::get_if<std::string>(&value_);
+    }
+    [[nodiscard]] std::int64_t as_int64() const
+    {
+        return *std::get_if<std::int64_t>(&value_);
+    }
+    [[nodiscard]] std::uint64_t as_uint64() const
+    {
+        return *std::get_if<std::uint64_t>(&value_);
+    }
+    [[nodiscard]] double as_double() const
+    {
+        return *std::get_if<double>(&value_);
+    }
+    [[nodiscard]] bool as_bool() const
+    {
+        return *std::get_if<bool>(&value_);
+    }
+
+    /**
+     * @brief Appends the value as text: strings as they are, numbers in their shortest round-trip form, bools as
+     * true/false.
+     */
+    void append_to(std::string& out) const;
+    [[nodiscard]] std::string to_string() const;
+
+    [[nodiscard]] bool operator==(ContextValue const& other) const
+    {
+        return value_ == other.value_;
+    }
+    [[nodiscard]] bool operator!=(ContextValue const& other) const
+    {
+        return !(*this == other);
+    }
+    // Compares with the string form of the value
+    [[nodiscard]] bool operator==(std::string_view other) const;
+    [[nodiscard]] bool operator==(char const* other) const
+    {
+        return *this == std::string_view(other);
+    }
+    [[nodiscard]] bool operator==(std::string const& other) const
+    {
+        return *this == std::string_view(other);
+    }
+};
+
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+inline void to_json(nlohmann::json& j, ContextValue const& value)
+{
+    switch (value.type())
+    {
+        case ContextValue::Type::STRING:
+            j = value.as_string();
+            break;
+        case ContextValue::Type::INT64:
+            j = value.as_int64();
+            break;
+        case ContextValue::Type::UINT64:
+            j = value.as_uint64();
+            break;
+        case ContextValue::Type::DOUBLE:
+            j = value.as_double();
+            break;
+        case ContextValue::Type::BOOL:
+            j = value.as_bool();
+            break;
+    }
+}
+#endif // OCTO_LOGGER_WITH_JSON_FORMATTING
+} // namespace octo::logger
+
+template <>
+struct fmt::formatter<octo::logger::ContextValue> : fmt::formatter<std::string_view>
+{
+    template <typename FormatContext>
+    auto format(octo::logger::ContextValue const& value, FormatContext& ctx) const
+    {
+        return fmt::formatter<std::string_view>::format(value.to_string(), ctx);
+    }
+};
+
+#endif // CONTEXT_VALUE_HPP_
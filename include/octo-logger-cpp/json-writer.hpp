@@ -0,0 +1,95 @@
+/**
+ * @file json-writer.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef JSON_WRITER_HPP_
+#define JSON_WRITER_HPP_
+
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+
+#include "octo-logger-cpp/context-value.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace octo::logger
+{
+/**
+ * @brief Streaming JSON encoder, producing the same bytes as nlohmann::json::dump for objects of strings, numbers and
+ * booleans.
+ *
+ * Keys are written in the order they are given, so callers write them sorted the same as nlohmann::json does.
+ * Strings which are not valid UTF-8 (which nlohmann::json::dump throws on) mark the writer as invalid, in which case the
+ * output should be discarded.
+ */
+class JsonWriter
+{
+  public:
+    // Kernels used to find the bytes that need escaping, ordered by preference
+    enum class ScanKernel : std::uint8_t
+    {
+        SCALAR = 0,
+        SSE2 = 1,
+        AVX2 = 2,
+    };
+
+  private:
+    std::string& out_;
+    int const indent_;
+    int depth_;
+    bool first_member_;
+    bool valid_;
+
+    void write_indent();
+
+  public:
+    explicit JsonWriter(std::string& out, int indent = -1);
+
+    void begin_object();
+    void end_object();
+    void key(std::string_view key);
+    // Writes a key encoded in advance with append_string
+    void encoded_key(std::string_view encoded);
+    void string_value(std::string_view value);
+    void number_value(std::int64_t value);
+    void number_value(std::uint64_t value);
+    // Non-finite values are written as null
+    void number_value(double value);
+    void bool_value(bool value);
+    // Writes the value as its JSON type
+    void context_value(ContextValue const& value);
+    // Appends a value encoded in advance with append_string
+    void encoded_value(std::string_view encoded);
+
+    [[nodiscard]] bool valid() const;
+
+    // The kernel picked at runtime for the CPU, SCALAR when SIMD isn't available for the target
+    [[nodiscard]] static ScanKernel active_scan_kernel();
+    [[nodiscard]] static bool scan_kernel_supported(ScanKernel kernel);
+
+    /**
+     * @brief Appends the value as a quoted and escaped JSON string.
+     * @return false if the value is not valid UTF-8.
+     */
+    static bool append_string(std::string& out, std::string_view value);
+    // Same as append_string, with a given kernel instead of the one picked for the CPU (for tests and benchmarks)
+    static bool append_string(std::string& out, std::string_view value, ScanKernel kernel);
+    // Appends the double the same as nlohmann::json::dump, in the shortest form that reads back the same
+    static void append_number(std::string& out, double value);
+
+    /**
+     * @brief Encodes the value once, for values written with encoded_value.
+     * @return the quoted JSON string, or an empty string if the value is not valid UTF-8.
+     */
+    [[nodiscard]] static std::string encode_string(std::string_view value);
+};
+} // namespace octo::logger
+
+#endif // OCTO_LOGGER_WITH_JSON_FORMATTING
+
+#endif // JSON_WRITER_HPP_
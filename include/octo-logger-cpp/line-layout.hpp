@@ -0,0 +1,420 @@
+/**
+ * @file line-layout.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LINE_LAYOUT_HPP_
+#define LINE_LAYOUT_HPP_
+
+#include "octo-logger-cpp/channel.hpp"
+#include "octo-logger-cpp/log-level.hpp"
+#include "octo-logger-cpp/log.hpp"
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace octo::logger
+{
+/**
+ * @brief What a line layout may need from a record, prepared by the sink.
+ */
+struct LayoutRecord
+{
+    Log const& log;
+    Channel const& channel;
+    // The calendar time of the record, only set when LineLayout::uses_time()
+    struct tm const* timeinfo;
+    std::uint32_t sub_second_ns;
+    std::string_view process_id;
+    std::string_view thread_id;
+    // The formatted context info, empty when there is none, when it is disabled or when the layout doesn't use it
+    std::string_view context_info;
+};
+
+/**
+ * @brief A plaintext line layout declared as a type (see Layout), used in place of LINE_FORMAT and LINE_PATTERN.
+ *
+ * Layouts are registered by name and picked per sink with SinkOption::LINE_LAYOUT:
+ *
+ *     using HotLayout = layout::Layout<layout::Timestamp<layout::Millis>, layout::Level<layout::Short>,
+ *                                      layout::ChannelName, layout::Tid, layout::Message>;
+ *     LineLayout::register_layout("hot", std::make_shared<HotLayout>());
+ *     sink_config.set_option(SinkConfig::SinkOption::LINE_LAYOUT, "hot");
+ */
+class LineLayout
+{
+  public:
+    virtual ~LineLayout() = default;
+
+    [[nodiscard]] virtual bool uses_time() const = 0;
+    [[nodiscard]] virtual bool uses_context_info() const = 0;
+    virtual void append(std::string& out, LayoutRecord const& record) const = 0;
+
+    /**
+     * @brief Registers layout under name, replacing any previous layout with that name.
+     * Sinks look their layout up when they are created, so register it before configuring the manager.
+     */
+    static void register_layout(std::string const& name, std::shared_ptr<LineLayout const> layout);
+    // nullptr if there is no layout with that name
+    [[nodiscard]] static std::shared_ptr<LineLayout const> find_layout(std::string const& name);
+};
+typedef std::shared_ptr<LineLayout const> LineLayoutPtr;
+
+namespace layout
+{
+constexpr std::string_view short_level_name(LogLevel level)
+{
+    switch (level)
+    {
+        case LogLevel::TRACE:
+            return "T";
+        case LogLevel::DEBUG:
+            return "D";
+        case LogLevel::INFO:
+            return "I";
+        case LogLevel::NOTICE:
+            return "N";
+        case LogLevel::WARNING:
+            return "W";
+        case LogLevel::ERROR:
+            return "E";
+        case LogLevel::QUIET:
+            return "Q";
+    }
+    return "";
+}
+
+constexpr std::string_view level_name(LogLevel level)
+{
+    switch (level)
+    {
+        case LogLevel::TRACE:
+            return "trace";
+        case LogLevel::DEBUG:
+            return "debug";
+        case LogLevel::INFO:
+            return "info";
+        case LogLevel::NOTICE:
+            return "notice";
+        case LogLevel::WARNING:
+            return "warning";
+        case LogLevel::ERROR:
+            return "error";
+        case LogLevel::QUIET:
+            return "quiet";
+    }
+    return "";
+}
+
+namespace detail
+{
+template <std::size_t WIDTH>
+inline void write_digits(char* out, std::uint32_t value)
+{
+    for (std::size_t i = WIDTH; i > 0; --i)
+    {
+        out[i - 1] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+inline void append_bracketed(std::string& out, std::string_view value)
+{
+    out += '[';
+    out += value;
+    out += ']';
+}
+} // namespace detail
+
+/*
+ * Fields. Each one writes its part of the line the way the plaintext formats do (brackets included), and reports
+ * MAX_SIZE, the most it writes apart from the variable length strings of the record, which size() adds.
+ */
+
+struct Millis
+{
+    static constexpr std::size_t DIGITS = 3;
+    static constexpr std::uint32_t DIVISOR = 1000000;
+};
+
+struct Micros
+{
+    static constexpr std::size_t DIGITS = 6;
+    static constexpr std::uint32_t DIVISOR = 1000;
+};
+
+struct Nanos
+{
+    static constexpr std::size_t DIGITS = 9;
+    static constexpr std::uint32_t DIVISOR = 1;
+};
+
+// [dd/mm/YYYY HH:MM:SS.fff]
+template <typename Precision = Millis>
+struct Timestamp
+{
+    static constexpr bool USES_TIME = true;
+    static constexpr bool USES_CONTEXT_INFO = false;
+    static constexpr std::size_t MAX_SIZE = 22 + Precision::DIGITS;
+
+    static std::size_t size(LayoutRecord const&)
+    {
+        return 0;
+    }
+
+    static void append(std::string& out, LayoutRecord const& record)
+    {
+        char buffer[MAX_SIZE] = {'[', 0, 0, '/', 0, 0, '/', 0, 0, 0, 0, ' ', 0, 0, ':', 0, 0, ':', 0, 0, '.'};
+        struct tm const& timeinfo = *record.timeinfo;
+        detail::write_digits<2>(buffer + 1, static_cast<std::uint32_t>(timeinfo.tm_mday));
+        detail::write_digits<2>(buffer + 4, static_cast<std::uint32_t>(timeinfo.tm_mon + 1));
+        detail::write_digits<4>(buffer + 7, static_cast<std::uint32_t>(timeinfo.tm_year + 1900));
+        detail::write_digits<2>(buffer + 12, static_cast<std::uint32_t>(timeinfo.tm_hour));
+        detail::write_digits<2>(buffer + 15, static_cast<std::uint32_t>(timeinfo.tm_min));
+        detail::write_digits<2>(buffer + 18, static_cast<std::uint32_t>(timeinfo.tm_sec));
+        detail::write_digits<Precision::DIGITS>(buffer + 21, record.sub_second_ns / Precision::DIVISOR);
+        buffer[MAX_SIZE - 1] = ']';
+        out.append(buffer, MAX_SIZE);
+    }
+};
+
+struct Short
+{
+    static constexpr std::size_t MAX_SIZE = 1;
+
+    static constexpr std::string_view name(LogLevel level)
+    {
+        return short_level_name(level);
+    }
+};
+
+struct Long
+{
+    static constexpr std::size_t MAX_SIZE = 7;
+
+    static constexpr std::string_view name(LogLevel level)
+    {
+        return level_name(level);
+    }
+};
+
+// [I] or [info]
+template <typename Style = Short>
+struct Level
+{
+    static constexpr bool USES_TIME = false;
+    static constexpr bool USES_CONTEXT_INFO = false;
+    static constexpr std::size_t MAX_SIZE = 2 + Style::MAX_SIZE;
+
+    static std::size_t size(LayoutRecord const&)
+    {
+        return 0;
+    }
+
+    static void append(std::string& out, LayoutRecord const& record)
+    {
+        detail::append_bracketed(out, Style::name(record.log.log_level()));
+    }
+};
+
+// [channel]
+struct ChannelName
+{
+    static constexpr bool USES_TIME = false;
+    static constexpr bool USES_CONTEXT_INFO = false;
+    static constexpr std::size_t MAX_SIZE = 2;
+
+    static std::size_t size(LayoutRecord const& record)
+    {
+        return record.channel.channel_name().size();
+    }
+
+    static void append(std::string& out, LayoutRecord const& record)
+    {
+        detail::append_bracketed(out, record.channel.channel_name());
+    }
+};
+
+// [PID(pid)]
+struct Pid
+{
+    static constexpr bool USES_TIME = false;
+    static constexpr bool USES_CONTEXT_INFO = false;
+    static constexpr std::size_t MAX_SIZE = 7;
+
+    static std::size_t size(LayoutRecord const& record)
+    {
+        return record.process_id.size();
+    }
+
+    static void append(std::string& out, LayoutRecord const& record)
+    {
+        out += "[PID(";
+        out += record.process_id;
+        out += ")]";
+    }
+};
+
+// [TID(tid)]
+struct Tid
+{
+    static constexpr bool USES_TIME = false;
+    static constexpr bool USES_CONTEXT_INFO = false;
+    static constexpr std::size_t MAX_SIZE = 7;
+
+    static std::size_t size(LayoutRecord const& record)
+    {
+        return record.thread_id.size();
+    }
+
+    static void append(std::string& out, LayoutRecord const& record)
+    {
+        out += "[TID(";
+        out += record.thread_id;
+        out += ")]";
+    }
+};
+
+// [extra identifier], or nothing when there is none
+struct ExtraId
+{
+    static constexpr bool USES_TIME = false;
+    static constexpr bool USES_CONTEXT_INFO = false;
+    static constexpr std::size_t MAX_SIZE = 2;
+
+    static std::size_t size(LayoutRecord const& record)
+    {
+        return record.log.extra_identifier().size();
+    }
+
+    static void append(std::string& out, LayoutRecord const& record)
+    {
+        if (!record.log.extra_identifier().empty())
+        {
+            detail::append_bracketed(out, record.log.extra_identifier());
+        }
+    }
+};
+
+// [file:line], or nothing for records not logged with the OCTO_LOG_* macros
+struct Source
+{
+    static constexpr bool USES_TIME = false;
+    static constexpr bool USES_CONTEXT_INFO = false;
+    static constexpr std::size_t MAX_SIZE = 13;
+
+    static std::size_t size(LayoutRecord const& record)
+    {
+        return record.log.site() != nullptr ? record.log.site()->file().size() : 0;
+    }
+
+    static void append(std::string& out, LayoutRecord const& record)
+    {
+        LogSite const* const site = record.log.site();
+        if (site == nullptr)
+        {
+            return;
+        }
+        char line[10];
+        std::size_t size = 0;
+        std::uint32_t value = site->line();
+        do
+        {
+            line[sizeof(line) - ++size] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        out += '[';
+        out += site->file();
+        out += ':';
+        out.append(line + sizeof(line) - size, size);
+        out += ']';
+    }
+};
+
+// : message
+struct Message
+{
+    static constexpr bool USES_TIME = false;
+    static constexpr bool USES_CONTEXT_INFO = false;
+    static constexpr std::size_t MAX_SIZE = 2;
+
+    static std::size_t size(LayoutRecord const& record)
+    {
+        return record.log.str().size();
+    }
+
+    static void append(std::string& out, LayoutRecord const& record)
+    {
+        out += ": ";
+        out += record.log.str();
+    }
+};
+
+// The context info on a new line, or nothing
+struct Context
+{
+    static constexpr bool USES_TIME = false;
+    static constexpr bool USES_CONTEXT_INFO = true;
+    static constexpr std::size_t MAX_SIZE = 1;
+
+    static std::size_t size(LayoutRecord const& record)
+    {
+        return record.context_info.size();
+    }
+
+    static void append(std::string& out, LayoutRecord const& record)
+    {
+        if (!record.context_info.empty())
+        {
+            out += '\n';
+            out += record.context_info;
+        }
+    }
+};
+
+/**
+ * @brief A line layout made of the given fields, in order.
+ *
+ * The formatter is generated at compile time, so there is no per-field dispatch, and the line is reserved once from
+ * the fixed field sizes and the lengths of the strings of the record.
+ * Layout<Timestamp<>, Level<>, ChannelName, Pid, Tid, ExtraId, Message, Context> writes the PLAINTEXT_LONG lines.
+ */
+template <typename... Fields>
+class Layout : public LineLayout
+{
+  public:
+    static constexpr bool USES_TIME = (Fields::USES_TIME || ...);
+    static constexpr bool USES_CONTEXT_INFO = (Fields::USES_CONTEXT_INFO || ...);
+    static constexpr std::size_t MAX_FIXED_SIZE = (Fields::MAX_SIZE + ... + 0);
+
+    [[nodiscard]] bool uses_time() const override
+    {
+        return USES_TIME;
+    }
+
+    [[nodiscard]] bool uses_context_info() const override
+    {
+        return USES_CONTEXT_INFO;
+    }
+
+    static void format(std::string& out, LayoutRecord const& record)
+    {
+        out.reserve(out.size() + MAX_FIXED_SIZE + (Fields::size(record) + ... + 0));
+        (Fields::append(out, record), ...);
+    }
+
+    void append(std::string& out, LayoutRecord const& record) const override
+    {
+        format(out, record);
+    }
+};
+} // namespace layout
+} // namespace octo::logger
+
+#endif // LINE_LAYOUT_HPP_
@@ -0,0 +1,97 @@
+/**
+ * @file line-pattern.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LINE_PATTERN_HPP_
+#define LINE_PATTERN_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace octo::logger
+{
+/**
+ * @brief Plaintext layout (SinkOption::LINE_PATTERN), compiled once into a flat list of operations.
+ *
+ * Flags:
+ * - %Y year, %m month, %d day, %H hours, %M minutes, %S seconds, %T same as %H:%M:%S, %z offset from UTC (±HHMM)
+ * - %e milliseconds, %f microseconds, %F nanoseconds
+ * - %L short level (I), %l level (info), %n channel name, %v message
+ * - %P process id, %t thread id, %N thread name (read once per thread)
+ * - %i extra identifier, %I extra identifier in brackets, or nothing when there is none
+ * - %c the context info on a new line, or nothing when there is none or it is disabled
+ * - %s source file name, %# source line, %! function, for records logged with the OCTO_LOG_* macros (nothing for
+ *   the others)
+ * - %% a literal %
+ * Anything else is copied as is.
+ *
+ * Note that octo-log-seek, octo-logq and the time index only understand the predefined layouts.
+ */
+class LinePattern
+{
+  public:
+    static constexpr char const* PLAINTEXT_LONG = "[%d/%m/%Y %H:%M:%S.%e][%L][%n][PID(%P)][TID(%t)]%I: %v%c";
+    static constexpr char const* PLAINTEXT_SHORT = "[MS(%e)][%L][%n][TID(%t)]%I: %v";
+
+    enum class OpType : std::uint8_t
+    {
+        LITERAL,
+        YEAR,
+        MONTH,
+        DAY,
+        HOURS,
+        MINUTES,
+        SECONDS,
+        UTC_OFFSET,
+        MILLISECONDS,
+        MICROSECONDS,
+        NANOSECONDS,
+        LEVEL_SHORT,
+        LEVEL,
+        CHANNEL,
+        MESSAGE,
+        PROCESS_ID,
+        THREAD_ID,
+        THREAD_NAME,
+        EXTRA_ID,
+        EXTRA_ID_BRACKETED,
+        CONTEXT_INFO,
+        SOURCE_FILE,
+        SOURCE_LINE,
+        SOURCE_FUNCTION,
+    };
+
+    struct Op
+    {
+        OpType type;
+        // The text of a LITERAL op, in literals()
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+  private:
+    std::vector<Op> ops_;
+    std::string literals_;
+    bool uses_time_;
+
+    void add_literal(std::string_view text);
+    void add_op(OpType type);
+
+  public:
+    explicit LinePattern(std::string_view pattern);
+
+    [[nodiscard]] std::vector<Op> const& ops() const;
+    [[nodiscard]] std::string_view literal(Op const& op) const;
+    // Whether the calendar time of the record is needed (any of %Y %m %d %H %M %S %T %z)
+    [[nodiscard]] bool uses_time() const;
+};
+} // namespace octo::logger
+
+#endif // LINE_PATTERN_HPP_
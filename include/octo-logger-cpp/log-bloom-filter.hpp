@@ -0,0 +1,66 @@
+/**
+ * @file log-bloom-filter.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LOG_BLOOM_FILTER_HPP_
+#define LOG_BLOOM_FILTER_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace octo::logger
+{
+/**
+ * @brief Bloom filter over the context values of a segment, written by FileSink to "<segment>.bloom" when the segment
+ * is closed (FILE_BLOOM_KEYS).
+ *
+ * Items are key/value pairs, so a session id does not match a tenant with the same value. The extra identifier is
+ * inserted under EXTRA_IDENTIFIER_KEY, apart from the session_id context key.
+ */
+class LogBloomFilter
+{
+  public:
+    // The reserved key of the extra identifier of the records
+    static constexpr std::string_view EXTRA_IDENTIFIER_KEY = "extra_identifier";
+    static std::size_t constexpr DEFAULT_BITS = 64 * 1024;
+    static std::uint32_t constexpr HASHES = 7;
+
+  private:
+    std::vector<std::uint64_t> words_;
+    std::uint64_t bits_;
+    std::uint64_t items_;
+
+    [[nodiscard]] static std::uint64_t hash(std::string_view key, std::string_view value);
+
+  public:
+    explicit LogBloomFilter(std::size_t bits = DEFAULT_BITS);
+
+    [[nodiscard]] static std::string filter_path(std::string const& segment_path);
+
+    void insert(std::string_view key, std::string_view value);
+    [[nodiscard]] bool may_contain(std::string_view key, std::string_view value) const;
+
+    // Number of insertions since created or cleared, a filter with none is not written
+    [[nodiscard]] std::uint64_t items() const;
+    [[nodiscard]] std::uint64_t bits() const;
+    void clear();
+
+    /**
+     * @brief Adds the items of another filter of the same size.
+     * @return false if the sizes differ.
+     */
+    bool merge(LogBloomFilter const& other);
+
+    bool load(std::string const& path);
+    bool save(std::string const& path) const;
+};
+} // namespace octo::logger
+
+#endif // LOG_BLOOM_FILTER_HPP_
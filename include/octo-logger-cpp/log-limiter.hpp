@@ -0,0 +1,247 @@
+/**
+ * @file log-limiter.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LOG_LIMITER_HPP_
+#define LOG_LIMITER_HPP_
+
+#include "octo-logger-cpp/clock.hpp"
+#include "octo-logger-cpp/context-info.hpp"
+#include "octo-logger-cpp/log-site.hpp"
+#include "octo-logger-cpp/logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace octo::logger
+{
+/*
+ * The per site state of the limited OCTO_LOG_* macros (OCTO_LOG_EVERY_N, OCTO_LOG_EVERY_MS and OCTO_LOG_RATE). They are
+ * statics next to the LogSite without constructor arguments (the limits are template parameters), so they are
+ * constant initialized. allow() is lock free, it returns whether the record is logged and, when it is, the number of
+ * records of the statement suppressed since the previous one.
+ */
+
+// The context key of the suppressed count, added to the first record logged after records were suppressed
+inline constexpr auto SUPPRESSED_CONTEXT_KEY = "suppressed";
+
+// The context of a record logged after suppressed records were dropped, empty if there were none
+[[nodiscard]] inline ContextInfo suppressed_context_info(std::uint64_t suppressed)
+{
+    return suppressed == 0 ? ContextInfo() : ContextInfo{{SUPPRESSED_CONTEXT_KEY, suppressed}};
+}
+
+// The first of every N records
+template <std::uint64_t N>
+class EveryNLimiter
+{
+    static_assert(N > 0, "N must be positive");
+
+  private:
+    std::atomic<std::uint64_t> count_{0};
+
+  public:
+    [[nodiscard]] bool allow(std::uint64_t& suppressed)
+    {
+        std::uint64_t const count = count_.fetch_add(1, std::memory_order_relaxed);
+        if (count % N != 0)
+        {
+            return false;
+        }
+        suppressed = count == 0 ? 0 : N - 1;
+        return true;
+    }
+};
+
+// At most one record per interval, on the record timestamps clock (Clock::record_time)
+template <std::int64_t INTERVAL_NS>
+class IntervalLimiter
+{
+    static_assert(INTERVAL_NS > 0, "The interval must be positive");
+
+  private:
+    // The time from which the next record is logged
+    std::atomic<std::int64_t> next_ns_{0};
+    std::atomic<std::uint64_t> suppressed_{0};
+
+  public:
+    [[nodiscard]] bool allow(std::uint64_t& suppressed)
+    {
+        std::int64_t const now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     Clock::record_time().time_since_epoch())
+                                     .count();
+        std::int64_t next = next_ns_.load(std::memory_order_relaxed);
+        // A single thread wins the interval, the others count as suppressed
+        if (now < next || !next_ns_.compare_exchange_strong(next, now + INTERVAL_NS, std::memory_order_relaxed))
+        {
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+};
+
+// count records per period_ns, see OCTO_LOG_RATE
+struct LogRate
+{
+    std::uint64_t count;
+    std::int64_t period_ns;
+};
+
+namespace rate_units
+{
+struct Period
+{
+    std::int64_t ns;
+};
+// The units of OCTO_LOG_RATE, e.g. 50/s
+inline constexpr Period s{1000000000LL};
+inline constexpr Period min{60LL * 1000000000LL};
+
+constexpr LogRate operator/(std::uint64_t count, Period period)
+{
+    return LogRate{count, period.ns};
+}
+} // namespace rate_units
+
+/*
+ * A token bucket of COUNT tokens refilled over PERIOD_NS, so bursts of up to COUNT records are logged.
+ * Kept as the time at which the bucket is full again (the generic cell rate algorithm) in a single atomic.
+ */
+template <std::uint64_t COUNT, std::int64_t PERIOD_NS>
+class RateLimiter
+{
+    static_assert(COUNT > 0 && PERIOD_NS > 0, "The rate must be positive");
+
+  private:
+    // The time a record costs
+    static constexpr std::int64_t EMISSION_NS = std::max<std::int64_t>(PERIOD_NS / COUNT, 1);
+    // How far ahead of now the bucket may be drained
+    static constexpr std::int64_t BURST_NS = PERIOD_NS - EMISSION_NS;
+
+    std::atomic<std::int64_t> full_at_ns_{0};
+    std::atomic<std::uint64_t> suppressed_{0};
+
+  public:
+    [[nodiscard]] bool allow(std::uint64_t& suppressed)
+    {
+        std::int64_t const now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     Clock::record_time().time_since_epoch())
+                                     .count();
+        std::int64_t full_at = full_at_ns_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            std::int64_t const from = std::max(full_at, now);
+            if (from - now > BURST_NS)
+            {
+                suppressed_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (full_at_ns_.compare_exchange_weak(full_at, from + EMISSION_NS, std::memory_order_relaxed))
+            {
+                suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+};
+} // namespace octo::logger
+
+/*
+ * The statement of the limited macros, once the site and octo_logger_limiter_ are declared. The limiter is only
+ * consulted for records whose level is enabled, and the arguments are only formatted for the records it lets through.
+ */
+#define OCTO_LOGGER_LIMITED_LOG_(logger, ...)                                                                          \
+    ::octo::logger::LogSiteState::Mode const octo_logger_site_mode_ = octo_logger_site_state_.mode();                  \
+    std::uint64_t octo_logger_suppressed_ = 0;                                                                         \
+    if ((logger).enabled(octo_logger_site_, octo_logger_site_mode_) &&                                                 \
+        octo_logger_limiter_.allow(octo_logger_suppressed_))                                                           \
+    {                                                                                                                  \
+        (logger)                                                                                                       \
+            .log(octo_logger_site_,                                                                                    \
+                 octo_logger_site_mode_,                                                                               \
+                 "",                                                                                                   \
+                 ::octo::logger::suppressed_context_info(octo_logger_suppressed_))                                     \
+            .formatted(__VA_ARGS__);                                                                                   \
+    }
+
+/*
+ * Logs the first of every n records of the statement, n a constant expression:
+ *
+ *     OCTO_LOG_ERROR_EVERY_N(logger, 100, "write failed: {}", error);
+ */
+#define OCTO_LOG_EVERY_N(logger, level, n, ...)                                                                        \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        OCTO_LOGGER_DECLARE_SITE_(level, __VA_ARGS__);                                                                 \
+        static ::octo::logger::EveryNLimiter<(n)> octo_logger_limiter_;                                                \
+        OCTO_LOGGER_LIMITED_LOG_(logger, __VA_ARGS__)                                                                  \
+    } while (false)
+
+// Logs at most one record of the statement every ms milliseconds, ms a constant expression
+#define OCTO_LOG_EVERY_MS(logger, level, ms, ...)                                                                      \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        OCTO_LOGGER_DECLARE_SITE_(level, __VA_ARGS__);                                                                 \
+        static ::octo::logger::IntervalLimiter<(ms) * 1000000LL> octo_logger_limiter_;                                 \
+        OCTO_LOGGER_LIMITED_LOG_(logger, __VA_ARGS__)                                                                  \
+    } while (false)
+
+/*
+ * Logs at most count records of the statement per period, in bursts of up to count records:
+ *
+ *     OCTO_LOG_INFO_RATE(logger, 50/s, "request from {}", peer);
+ *
+ * The rate is count/s or count/min (see rate_units).
+ */
+#define OCTO_LOG_RATE(logger, level, rate, ...)                                                                        \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        OCTO_LOGGER_DECLARE_SITE_(level, __VA_ARGS__);                                                                 \
+        static constexpr ::octo::logger::LogRate octo_logger_rate_ = []() -> ::octo::logger::LogRate {                 \
+            using namespace ::octo::logger::rate_units;                                                                \
+            return rate;                                                                                               \
+        }();                                                                                                           \
+        static ::octo::logger::RateLimiter<octo_logger_rate_.count, octo_logger_rate_.period_ns> octo_logger_limiter_; \
+        OCTO_LOGGER_LIMITED_LOG_(logger, __VA_ARGS__)                                                                  \
+    } while (false)
+
+#define OCTO_LOG_TRACE_EVERY_N(logger, n, ...) OCTO_LOG_EVERY_N(logger, ::octo::logger::LogLevel::TRACE, n, __VA_ARGS__)
+#define OCTO_LOG_DEBUG_EVERY_N(logger, n, ...) OCTO_LOG_EVERY_N(logger, ::octo::logger::LogLevel::DEBUG, n, __VA_ARGS__)
+#define OCTO_LOG_INFO_EVERY_N(logger, n, ...) OCTO_LOG_EVERY_N(logger, ::octo::logger::LogLevel::INFO, n, __VA_ARGS__)
+#define OCTO_LOG_NOTICE_EVERY_N(logger, n, ...)                                                                        \
+    OCTO_LOG_EVERY_N(logger, ::octo::logger::LogLevel::NOTICE, n, __VA_ARGS__)
+#define OCTO_LOG_WARNING_EVERY_N(logger, n, ...)                                                                       \
+    OCTO_LOG_EVERY_N(logger, ::octo::logger::LogLevel::WARNING, n, __VA_ARGS__)
+#define OCTO_LOG_ERROR_EVERY_N(logger, n, ...) OCTO_LOG_EVERY_N(logger, ::octo::logger::LogLevel::ERROR, n, __VA_ARGS__)
+
+#define OCTO_LOG_TRACE_EVERY_MS(logger, ms, ...)                                                                       \
+    OCTO_LOG_EVERY_MS(logger, ::octo::logger::LogLevel::TRACE, ms, __VA_ARGS__)
+#define OCTO_LOG_DEBUG_EVERY_MS(logger, ms, ...)                                                                       \
+    OCTO_LOG_EVERY_MS(logger, ::octo::logger::LogLevel::DEBUG, ms, __VA_ARGS__)
+#define OCTO_LOG_INFO_EVERY_MS(logger, ms, ...)                                                                        \
+    OCTO_LOG_EVERY_MS(logger, ::octo::logger::LogLevel::INFO, ms, __VA_ARGS__)
+#define OCTO_LOG_NOTICE_EVERY_MS(logger, ms, ...)                                                                      \
+    OCTO_LOG_EVERY_MS(logger, ::octo::logger::LogLevel::NOTICE, ms, __VA_ARGS__)
+#define OCTO_LOG_WARNING_EVERY_MS(logger, ms, ...)                                                                     \
+    OCTO_LOG_EVERY_MS(logger, ::octo::logger::LogLevel::WARNING, ms, __VA_ARGS__)
+#define OCTO_LOG_ERROR_EVERY_MS(logger, ms, ...)                                                                       \
+    OCTO_LOG_EVERY_MS(logger, ::octo::logger::LogLevel::ERROR, ms, __VA_ARGS__)
+
+#define OCTO_LOG_TRACE_RATE(logger, rate, ...) OCTO_LOG_RATE(logger, ::octo::logger::LogLevel::TRACE, rate, __VA_ARGS__)
+#define OCTO_LOG_DEBUG_RATE(logger, rate, ...) OCTO_LOG_RATE(logger, ::octo::logger::LogLevel::DEBUG, rate, __VA_ARGS__)
+#define OCTO_LOG_INFO_RATE(logger, rate, ...) OCTO_LOG_RATE(logger, ::octo::logger::LogLevel::INFO, rate, __VA_ARGS__)
+#define OCTO_LOG_NOTICE_RATE(logger, rate, ...)                                                                        \
+    OCTO_LOG_RATE(logger, ::octo::logger::LogLevel::NOTICE, rate, __VA_ARGS__)
+#define OCTO_LOG_WARNING_RATE(logger, rate, ...)                                                                       \
+    OCTO_LOG_RATE(logger, ::octo::logger::LogLevel::WARNING, rate, __VA_ARGS__)
+#define OCTO_LOG_ERROR_RATE(logger, rate, ...) OCTO_LOG_RATE(logger, ::octo::logger::LogLevel::ERROR, rate, __VA_ARGS__)
+
+#endif // LOG_LIMITER_HPP_
@@ -0,0 +1,90 @@
+/**
+ * @file log-profiler.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LOG_PROFILER_HPP_
+#define LOG_PROFILER_HPP_
+
+#include "octo-logger-cpp/log-site.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace octo::logger
+{
+/**
+ * @brief Counts the records and the formatted bytes of every call site and channel, to find the noisy statements.
+ *
+ * Off by default, while it is off the only cost is a relaxed load per record. When on, each thread counts into its
+ * own cache line padded slots, so the counting threads never share a line; the slots of a thread are merged into a
+ * process wide table when it exits. Records logged without the OCTO_LOG_* macros are counted per channel, without a
+ * site.
+ */
+class LogProfiler
+{
+  public:
+    // The counters of a site in a channel, summed over all the threads
+    struct Entry
+    {
+        // nullptr for the records logged without the OCTO_LOG_* macros
+        LogSite const* site = nullptr;
+        std::string channel;
+        // Records created with their level enabled, and with their level filtered out by the channel
+        std::uint64_t emitted = 0;
+        std::uint64_t filtered = 0;
+        // Formatted by all the sinks
+        std::uint64_t bytes = 0;
+        // Per sink name, sorted by name
+        std::vector<std::pair<std::string, std::uint64_t>> sink_bytes;
+    };
+
+  private:
+    static std::atomic<bool> enabled_;
+
+    static void add(LogSite const* site,
+                    std::string_view channel,
+                    std::string_view sink,
+                    std::uint64_t emitted,
+                    std::uint64_t filtered,
+                    std::uint64_t bytes);
+
+  public:
+    [[nodiscard]] static bool enabled()
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+    // Counting starts and stops at once, the counters are kept
+    static void set_enabled(bool enabled);
+
+    static void count_record(LogSite const* site, std::string_view channel, bool emitted)
+    {
+        add(site, channel, {}, emitted ? 1 : 0, emitted ? 0 : 1, 0);
+    }
+    static void count_bytes(LogSite const* site, std::string_view channel, std::string_view sink, std::size_t bytes)
+    {
+        add(site, channel, sink, 0, 0, bytes);
+    }
+
+    // The noisiest first (by bytes, then emitted and filtered records), at most top_n entries unless it is 0
+    [[nodiscard]] static std::vector<Entry> report(std::size_t top_n = 0);
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+    // {"entries": [{"file", "line", "function", "format", "channel", "emitted", "filtered", "bytes", "sinks"}]}
+    [[nodiscard]] static std::string report_json(std::size_t top_n = 0);
+#endif
+    // Zeroes all the counters
+    static void reset();
+    // Resets the profiler locks in the child after fork (Manager::child_on_fork)
+    static void child_on_fork();
+};
+} // namespace octo::logger
+
+#endif // LOG_PROFILER_HPP_
@@ -0,0 +1,93 @@
+/**
+ * @file log-query.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LOG_QUERY_HPP_
+#define LOG_QUERY_HPP_
+
+#ifndef _WIN32
+
+#include "octo-logger-cpp/log-timestamp-parser.hpp"
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace octo::logger
+{
+/**
+ * @brief Filters the records of FileSink segments (PLAINTEXT_LONG, PLAINTEXT_SHORT or JSON) by level, channel, time
+ * range and substring, the scanner of octo-logq.
+ *
+ * Segments are memory mapped and scanned without copying: the level is read at a fixed offset of the header before
+ * anything else is parsed, and with a substring the scan jumps from one occurrence to the next, only looking at the
+ * records around them. The time range is sought with the segment's LogTimeIndex when it has one.
+ */
+struct LogQuery
+{
+    enum class LineKind : std::uint8_t
+    {
+        PLAINTEXT_LONG,
+        PLAINTEXT_SHORT,
+        JSON,
+        CONTINUATION,
+    };
+
+    struct Result
+    {
+        // The matching records, the ones not handed to the output callback
+        std::string output;
+        std::uint64_t matches = 0;
+        bool opened = false;
+    };
+
+    // Takes the matching records in chunks of about OUTPUT_CHUNK_SIZE bytes, in order, and may move them
+    using OutputCallback = std::function<void(std::string&& chunk)>;
+    static std::size_t constexpr OUTPUT_CHUNK_SIZE = 64 * 1024;
+
+    // Accepted levels by their short name, which is also the first letter of the JSON log_level
+    bool accepted_levels[256] = {};
+    bool filter_level = false;
+    std::string channel;
+    std::optional<std::int64_t> from;
+    std::optional<std::int64_t> to;
+    std::string needle;
+    bool utc = false;
+    // Only the matches are counted, the output is left empty
+    bool count_only = false;
+
+    /**
+     * @brief Accepts the records of the level (trace, debug, info, notice, warning, error) and above.
+     * @return false if the level name is invalid.
+     */
+    bool set_min_level(std::string const& name);
+
+    /*
+     * Scans a whole segment, with its .idx sidecar when there is one and a time range is set. With on_output the
+     * records are handed over as the scan goes instead of being kept in Result::output.
+     */
+    [[nodiscard]] Result scan_segment(std::string const& path, OutputCallback const& on_output = {}) const;
+    // Scans the records of data, which holds whole lines
+    [[nodiscard]] Result scan(std::string_view data, OutputCallback const& on_output = {}) const;
+
+    [[nodiscard]] bool header_matches(std::string_view line, LineKind kind, LogTimestampParser& parser) const;
+
+    // The first occurrence of c or needle in [begin, end), end if there is none
+    [[nodiscard]] static char const* find_byte(char const* begin, char const* end, char c);
+    [[nodiscard]] static char const* find_substring(char const* begin, char const* end, std::string_view needle);
+
+    [[nodiscard]] static LineKind classify(std::string_view line);
+    // The short level name of a header line, 0 if it has none
+    [[nodiscard]] static char level(std::string_view line, LineKind kind);
+    [[nodiscard]] static std::string_view channel_name(std::string_view line, LineKind kind);
+};
+} // namespace octo::logger
+
+#endif
+#endif // LOG_QUERY_HPP_
@@ -0,0 +1,223 @@
+/**
+ * @file log-site.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LOG_SITE_HPP_
+#define LOG_SITE_HPP_
+
+#include "octo-logger-cpp/log-level.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace octo::logger
+{
+/**
+ * @brief The static description of a logging statement, one per OCTO_LOG_* call site.
+ *
+ * The descriptor is a static constexpr of the statement, so everything in it (the file basename, the line, the
+ * function, the level, the format string and the site id) is computed at compile time. The records a site creates
+ * point to it, so sinks get the source location without it being copied into every record.
+ */
+class LogSite
+{
+  private:
+    std::string_view file_;
+    std::uint32_t line_;
+    std::string_view function_;
+    LogLevel level_;
+    std::string_view format_;
+    std::uint64_t id_;
+
+  public:
+    constexpr LogSite(std::string_view file,
+                      std::uint32_t line,
+                      std::string_view function,
+                      LogLevel level,
+                      std::string_view format)
+        : file_(basename(file)),
+          line_(line),
+          function_(function),
+          level_(level),
+          format_(format),
+          id_(make_id(file, line))
+    {
+    }
+
+    // The file name without its directories
+    [[nodiscard]] constexpr std::string_view file() const
+    {
+        return file_;
+    }
+    [[nodiscard]] constexpr std::uint32_t line() const
+    {
+        return line_;
+    }
+    [[nodiscard]] constexpr std::string_view function() const
+    {
+        return function_;
+    }
+    [[nodiscard]] constexpr LogLevel level() const
+    {
+        return level_;
+    }
+    [[nodiscard]] constexpr std::string_view format() const
+    {
+        return format_;
+    }
+    // Hash of the full path and the line, the same in every run of the same build
+    [[nodiscard]] constexpr std::uint64_t id() const
+    {
+        return id_;
+    }
+
+    static constexpr std::string_view basename(std::string_view path)
+    {
+        std::size_t const separator = path.find_last_of("/\\");
+        return separator == std::string_view::npos ? path : path.substr(separator + 1);
+    }
+
+    // FNV-1a of the path, followed by the line
+    static constexpr std::uint64_t make_id(std::string_view path, std::uint32_t line)
+    {
+        std::uint64_t hash = 14695981039346656037ULL;
+        for (char const c : path)
+        {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        }
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            hash = (hash ^ ((line >> shift) & 0xFF)) * 1099511628211ULL;
+        }
+        return hash;
+    }
+};
+
+/**
+ * @brief The runtime state of a call site, a static next to its LogSite.
+ *
+ * Its constructor only takes the address of the descriptor, so it is constant initialized too and the statement has
+ * no static initialization guard. A site adds itself to the process wide site table the first time it runs, and
+ * takes the mode of the last matching rule (see set_mode) then.
+ */
+class LogSiteState
+{
+  public:
+    enum class Mode : std::uint8_t
+    {
+        // The site hasn't run yet
+        UNREGISTERED = 0,
+        // Logged when its level is enabled in the channel
+        DEFAULT = 1,
+        // Always logged, whatever the channel's level
+        ENABLED = 2,
+        // Never logged
+        DISABLED = 3,
+    };
+
+    // What a rule pattern is matched against
+    enum class Match : std::uint8_t
+    {
+        // "file:line" of the site, the file without its directories
+        LOCATION = 0,
+        FUNCTION = 1,
+        FORMAT = 2,
+    };
+
+  private:
+    LogSite const* const site_;
+    std::atomic<Mode> mode_;
+
+    Mode register_site();
+
+  public:
+    constexpr explicit LogSiteState(LogSite const& site) : site_(&site), mode_(Mode::UNREGISTERED)
+    {
+    }
+
+    LogSiteState(LogSiteState const&) = delete;
+    LogSiteState& operator=(LogSiteState const&) = delete;
+
+    [[nodiscard]] LogSite const& site() const
+    {
+        return *site_;
+    }
+
+    // One relaxed load, the site is registered on its first call
+    [[nodiscard]] Mode mode()
+    {
+        Mode const mode = mode_.load(std::memory_order_relaxed);
+        return mode != Mode::UNREGISTERED ? mode : register_site();
+    }
+
+    // Whether a record of level, created by a site of that mode, is logged in a channel of channel_level
+    [[nodiscard]] static constexpr bool enabled(Mode mode, LogLevel level, LogLevel channel_level)
+    {
+        if (level == LogLevel::QUIET || mode == Mode::DISABLED)
+        {
+            return false;
+        }
+        return mode == Mode::ENABLED || level >= channel_level;
+    }
+
+    /**
+     * @brief Sets the mode of the sites whose match field matches the glob pattern (* and ? wildcards), the ones
+     * registered so far and the ones that will register later. Rules apply in the order they are set.
+     * @return the number of registered sites that matched.
+     */
+    static std::size_t set_mode(Match match, std::string_view pattern, Mode mode);
+    // Drops all the rules, every site goes back to DEFAULT
+    static void clear_rules();
+
+    // The sites which ran at least once, in the order they first ran
+    [[nodiscard]] static std::vector<LogSite const*> registered_sites();
+    // Resets the site table lock in the child after fork (Manager::child_on_fork)
+    static void child_on_fork();
+};
+} // namespace octo::logger
+
+// The first of the macro arguments, the format string of the OCTO_LOG_* macros
+#define OCTO_LOGGER_FIRST_ARG_(first, ...) first
+
+/*
+ * Declares the site of the statement (octo_logger_site_ and octo_logger_site_state_) in the enclosing block.
+ */
+#define OCTO_LOGGER_DECLARE_SITE_(level, ...)                                                                          \
+    static constexpr ::octo::logger::LogSite octo_logger_site_(                                                        \
+        __FILE__, __LINE__, __func__, level, OCTO_LOGGER_FIRST_ARG_(__VA_ARGS__, ""));                                 \
+    static ::octo::logger::LogSiteState octo_logger_site_state_(octo_logger_site_)
+
+/*
+ * Logs a fmt formatted message with the location of the statement:
+ *
+ *     OCTO_LOG_INFO(logger, "connected to {} in {}ms", host, elapsed);
+ *
+ * The format string is checked at compile time and the arguments are only formatted if the level is enabled (or the
+ * site is enabled with LogSiteState::set_mode / Manager::set_log_site_mode).
+ */
+#define OCTO_LOG(logger, level, ...)                                                                                   \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        OCTO_LOGGER_DECLARE_SITE_(level, __VA_ARGS__);                                                                 \
+        ::octo::logger::LogSiteState::Mode const octo_logger_site_mode_ = octo_logger_site_state_.mode();              \
+        if (octo_logger_site_mode_ != ::octo::logger::LogSiteState::Mode::DISABLED)                                    \
+        {                                                                                                              \
+            (logger).log(octo_logger_site_, octo_logger_site_mode_).formatted(__VA_ARGS__);                            \
+        }                                                                                                              \
+    } while (false)
+
+#define OCTO_LOG_TRACE(logger, ...) OCTO_LOG(logger, ::octo::logger::LogLevel::TRACE, __VA_ARGS__)
+#define OCTO_LOG_DEBUG(logger, ...) OCTO_LOG(logger, ::octo::logger::LogLevel::DEBUG, __VA_ARGS__)
+#define OCTO_LOG_INFO(logger, ...) OCTO_LOG(logger, ::octo::logger::LogLevel::INFO, __VA_ARGS__)
+#define OCTO_LOG_NOTICE(logger, ...) OCTO_LOG(logger, ::octo::logger::LogLevel::NOTICE, __VA_ARGS__)
+#define OCTO_LOG_WARNING(logger, ...) OCTO_LOG(logger, ::octo::logger::LogLevel::WARNING, __VA_ARGS__)
+#define OCTO_LOG_ERROR(logger, ...) OCTO_LOG(logger, ::octo::logger::LogLevel::ERROR, __VA_ARGS__)
+
+#endif // LOG_SITE_HPP_
@@ -0,0 +1,93 @@
+/**
+ * @file log-time-index.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LOG_TIME_INDEX_HPP_
+#define LOG_TIME_INDEX_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace octo::logger
+{
+/**
+ * @brief Sparse time index written by FileSink next to each segment (FILE_TIME_INDEX_RECORDS / FILE_TIME_INDEX_BYTES).
+ *
+ * The sidecar "<segment>.idx" is a flat array of entries in host byte order. Each entry is a block of consecutive
+ * records of one writer: the offset of its first record, the offset it ends at and the oldest and newest timestamps
+ * in it, so records logged out of order are found in any block. A block is appended once when it starts, as open,
+ * and again when the next one starts or the segment is closed; a block never closed (the writer is still running or
+ * died) may hold any timestamp. Processes sharing the segment (FILE_ATOMIC_APPEND) each write their own blocks, which
+ * overlap in the file.
+ */
+class LogTimeIndex
+{
+  public:
+    struct Entry
+    {
+        std::int64_t min_timestamp_ms;
+        std::int64_t max_timestamp_ms;
+        std::uint64_t offset;
+        // 0 while the block is open
+        std::uint64_t end_offset;
+
+        [[nodiscard]] bool is_open() const
+        {
+            return end_offset == 0;
+        }
+    };
+    static_assert(sizeof(Entry) == 32, "Entry is stored as is in the index file");
+
+    using RecordCallback = std::function<void(std::string_view record)>;
+
+  private:
+    std::vector<Entry> entries_;
+
+  public:
+    LogTimeIndex() = default;
+
+    [[nodiscard]] static std::string index_path(std::string const& segment_path);
+
+    /**
+     * @brief Loads the index of a segment, one entry per block sorted by offset.
+     * @return false if the segment has no index, in which case the whole segment is read.
+     */
+    bool load(std::string const& segment_path);
+
+    [[nodiscard]] std::vector<Entry> const& entries() const;
+
+    /**
+     * @brief Offset to start reading from, all the records before it are older than from_ms.
+     * @return The end of the indexed records if they are all older.
+     */
+    [[nodiscard]] std::uint64_t start_offset(std::int64_t from_ms) const;
+
+    /**
+     * @brief Offset to stop reading at, the records from it onwards are newer than to_ms.
+     * @return std::nullopt to read up to the end of the segment.
+     */
+    [[nodiscard]] std::optional<std::uint64_t> end_offset(std::int64_t to_ms) const;
+
+    /**
+     * @brief Calls on_record for every record of the segment in [from_ms, to_ms], including its continuation lines.
+     * Plaintext timestamps are read as local time unless utc is set, the same as LogTimestampParser.
+     * @return false if the segment could not be opened.
+     */
+    static bool read_range(std::string const& segment_path,
+                           std::int64_t from_ms,
+                           std::int64_t to_ms,
+                           bool utc,
+                           RecordCallback const& on_record);
+};
+} // namespace octo::logger
+
+#endif // LOG_TIME_INDEX_HPP_
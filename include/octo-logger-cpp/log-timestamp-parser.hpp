@@ -0,0 +1,59 @@
+/**
+ * @file log-timestamp-parser.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef LOG_TIMESTAMP_PARSER_HPP_
+#define LOG_TIMESTAMP_PARSER_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace octo::logger
+{
+/**
+ * @brief Reads back the record timestamp from lines written by the PLAINTEXT_LONG and JSON line formats.
+ *
+ * PLAINTEXT_LONG lines start with "[dd/mm/YYYY HH:MM:SS.mmm]" which has no timezone, so it is interpreted as local time,
+ * or as UTC when the parser is created with utc set (for sinks configured with USE_SAFE_LOCALTIME_UTC).
+ * JSON lines carry an ISO 8601 "timestamp" with its UTC offset.
+ * Lines that are neither (e.g. the context_info line of PLAINTEXT_LONG, or a multi-line message) are continuations
+ * of the previous record.
+ */
+class LogTimestampParser
+{
+  public:
+    static std::size_t constexpr PLAINTEXT_TIMESTAMP_SIZE = 25; // "[dd/mm/YYYY HH:MM:SS.mmm]"
+
+  private:
+    bool const utc_;
+    std::int64_t cached_local_hour_;
+    std::int64_t cached_local_offset_;
+
+    [[nodiscard]] std::int64_t local_offset_seconds(std::int64_t civil_seconds);
+
+  public:
+    explicit LogTimestampParser(bool utc = false);
+
+    /**
+     * @brief Milliseconds since the epoch of the record that starts at this line.
+     * @return std::nullopt if the line does not start a record.
+     */
+    [[nodiscard]] std::optional<std::int64_t> parse(std::string_view line);
+    [[nodiscard]] std::optional<std::int64_t> parse_plaintext(std::string_view line);
+    [[nodiscard]] static std::optional<std::int64_t> parse_json(std::string_view line);
+
+    /**
+     * @brief Parses a time given on the command line of the log tools: epoch milliseconds, or a timestamp as it
+     * appears in the logs ("dd/mm/YYYY HH:MM:SS[.mmm]" or "YYYY-MM-DDTHH:MM:SS.mmm±HHMM").
+     */
+    [[nodiscard]] std::optional<std::int64_t> parse_argument(std::string_view argument);
+};
+} // namespace octo::logger
+
+#endif // LOG_TIMESTAMP_PARSER_HPP_
@@ -14,6 +14,7 @@
 
 #include "octo-logger-cpp/context-info.hpp"
 #include "octo-logger-cpp/log-level.hpp"
+#include "octo-logger-cpp/log-site.hpp"
 #include "octo-logger-cpp/logger-test-definitions.hpp"
 #include <fmt/format.h>
 #include <fmt/printf.h>
@@ -40,9 +41,18 @@ class Log
     std::chrono::time_point<std::chrono::system_clock> time_created_;
     std::string extra_identifier_;
     ContextInfo context_info_;
+    // The scoped context of the logging thread (ScopedContext::current), records are dumped on the thread that logs
+    ContextInfo const* scoped_context_;
+    // The statement that created the record, nullptr unless it was logged with the OCTO_LOG_* macros
+    LogSite const* site_;
 
   private:
-    Log(const LogLevel& log_level, std::string_view extra_identifier, ContextInfo&& context_info, const Logger& logger);
+    Log(const LogLevel& log_level,
+        std::string_view extra_identifier,
+        ContextInfo&& context_info,
+        const Logger& logger,
+        LogSite const* site = nullptr,
+        LogSiteState::Mode site_mode = LogSiteState::Mode::DEFAULT);
 
   public:
     virtual ~Log();
@@ -69,6 +79,15 @@ class Log
     {
         return context_info_;
     }
+    [[nodiscard]] LogSite const* site() const
+    {
+        return site_;
+    }
+    // Below context_info() and above the logger's context in precedence
+    ContextInfo const& scoped_context() const
+    {
+        return *scoped_context_;
+    }
 
     template <class T>
     Log& operator<<(const T& value)
@@ -17,6 +17,7 @@
 #include "octo-logger-cpp/context-info.hpp"
 #include "octo-logger-cpp/log.hpp"
 #include "octo-logger-cpp/logger-test-definitions.hpp"
+#include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
@@ -31,11 +32,15 @@ class Logger
     static constexpr auto TenantID = "tenant_id";
 
   private:
-    ContextInfo context_info_;
+    // Shared with the children (see with), copied before it is modified while shared
+    std::shared_ptr<ContextInfo> context_info_;
     ChannelView channel_view_;
 
   private:
+    Logger(ChannelView channel_view, std::shared_ptr<ContextInfo> context_info);
+
     void dump_log(const Log& log) const;
+    [[nodiscard]] ContextInfo& editable_context_info();
 
   public:
     explicit Logger(std::string_view channel);
@@ -48,6 +53,20 @@ class Logger
     Log warning(std::string_view extra_identifier = "", ContextInfo context_info = {}) const;
     Log error(std::string_view extra_identifier = "", ContextInfo context_info = {}) const;
     Log log(Log::LogLevel level, std::string_view extra_identifier = "", ContextInfo context_info = {}) const;
+    // A record of the site's level which points to the site, see OCTO_LOG. The mode overrides the channel level
+    Log log(LogSite const& site,
+            LogSiteState::Mode mode = LogSiteState::Mode::DEFAULT,
+            std::string_view extra_identifier = "",
+            ContextInfo context_info = {}) const;
+    // Whether log(site, mode) would be logged, without creating the record
+    [[nodiscard]] bool enabled(LogSite const& site, LogSiteState::Mode mode = LogSiteState::Mode::DEFAULT) const;
+
+    /**
+     * @brief A logger of the same channel with context_info added to this logger's context.
+     * The child references this logger's context instead of copying it (changes made to this logger afterwards are not
+     * seen by the child) and shares its channel without looking it up in the manager.
+     */
+    [[nodiscard]] Logger with(ContextInfo context_info) const;
 
     void add_context_key(ContextInfo::ContextInfoKey key, ContextInfo::ContextInfoValue value);
     void add_context_keys(ContextInfo context_info);
@@ -57,6 +76,8 @@ class Logger
 
     const Channel& logger_channel() const;
     Channel& editable_logger_channel();
+    // The logger's own entries, the ones of the loggers it was made from (with) are reached through parent().
+    // ContextInfo::update and flattened() take the whole chain
     [[nodiscard]] ContextInfo const& context_info() const;
 
     friend class Log;
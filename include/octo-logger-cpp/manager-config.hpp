@@ -30,7 +30,9 @@ class ManagerConfig
   public:
     enum class LoggerOption : std::uint8_t
     {
-        DEFAULT_CHANNEL_LEVEL
+        DEFAULT_CHANNEL_LEVEL,
+        // Clock::ClockType of the record timestamps, SYSTEM by default
+        CLOCK,
     };
 
   private:
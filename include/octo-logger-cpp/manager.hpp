@@ -14,16 +14,21 @@
 
 #include "octo-logger-cpp/channel-view.hpp"
 #include "octo-logger-cpp/channel.hpp"
+#include "octo-logger-cpp/clock.hpp"
 #include "octo-logger-cpp/context-info.hpp"
 #include "octo-logger-cpp/fork-safe-mutex.hpp"
+#include "octo-logger-cpp/log-profiler.hpp"
 #include "octo-logger-cpp/log.hpp"
 #include "octo-logger-cpp/logger.hpp"
 #include "octo-logger-cpp/manager-config.hpp"
 #include "octo-logger-cpp/sink-factory.hpp"
+#include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -40,26 +45,48 @@ class Manager
     static std::shared_ptr<Manager> manager_;
 
     std::unordered_map<std::string, ChannelPtr> channels_;
-    std::vector<SinkPtr> sinks_;
+    using SinkList = std::vector<SinkPtr>;
+    /*
+     * Replaced rather than modified, so sinks cleared meanwhile live until the records being dumped to them are written.
+     * dump calls the sinks under sinks_mutex_, except the ones which lock themselves (Sink::thread_safe_dump).
+     */
+    std::shared_ptr<SinkList const> sinks_;
     mutable ForkSafeMutex sinks_mutex_;
     ManagerConfigPtr config_;
     Log::LogLevel default_log_level_;
     std::shared_ptr<Logger> global_logger_;
+    // A published version of the global context: a persistent map, flattened for the sinks on first use
+    struct GlobalContext;
     /*
      * Shared Pointer in order to allow thread safe usage on the 'dump' method with minimal locking.
      * The shared pointer is copied under mutex protection to ensure that the pointed-at ContextInfo will not be
-     * deleted while being used in the 'dump' method, even if another thread updates the global_context_info_.
+     * deleted while being used in the 'dump' method, even if another thread updates the global_context_.
      *
      * FIXME: In the future we should switch to std::atomic_shared_ptr (c++20) and then we won't need the mutex here,
      * We are using a mutex for fork-safety, but std::atomic_shared_ptr should inherently be fork-safe, since it should
      * only use lock-free atomic operations (as opposed to std::atomic_load/store on shared_ptr which uses locks internally)
      */
     mutable ForkSafeMutex global_context_info_mutex_;
-    GlobalContextInfoTypePtr global_context_info_;
+    std::shared_ptr<GlobalContext const> global_context_;
+    // Every clock that was set, records may still be reading a replaced one so they are kept until the end
+    std::vector<ClockPtr> clocks_;
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+    // Writes the LogProfiler report periodically, see start_log_profile_file
+    std::unique_ptr<std::thread> log_profile_thread_;
+    ForkSafeMutex log_profile_mutex_;
+    std::unique_ptr<std::condition_variable> log_profile_cond_;
+    bool log_profile_running_;
+#endif
 
   private:
     explicit Manager();
 
+    [[nodiscard]] std::shared_ptr<GlobalContext const> global_context() const;
+    [[nodiscard]] std::shared_ptr<SinkList const> sinks() const;
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+    void log_profile_thread(std::string const& path, std::chrono::milliseconds interval, std::size_t top_n);
+#endif
+
   public:
     // Non-copyable and non-movable
     Manager(const Manager& other) = delete;
@@ -91,12 +118,42 @@ class Manager
     // @brief replace the global context info with an rvalue to avoid extra copying
     // It is not named 'replace_global_context_info' to avoid ambiguity with the lvalue version
     void replace_global_context_info_rvalue(ContextInfo&& context_info);
+    // Safe to call concurrently, every update is applied on top of the ones published before it
     void update_global_context_info(ContextInfo const& new_context_info);
     // @brief execute this function on child process after fork before logging anything
     void child_on_fork() noexcept;
 
+    // @brief Sets the clock of the record timestamps (e.g. a FakeClock in tests), nullptr for the system clock
+    void set_clock(ClockPtr clock);
+    [[nodiscard]] Clock* clock() const;
+
     [[nodiscard]] Log::LogLevel get_log_level() const;
     void set_log_level(Log::LogLevel log_level);
+
+    /**
+     * @brief Enables (or disables) the OCTO_LOG_* statements matching a glob, whatever their channel's level. e.g.
+     * set_log_site_mode(LogSiteState::Match::LOCATION, "connection.cpp:42", LogSiteState::Mode::ENABLED) turns on
+     * a single TRACE statement. Applies to the statements which didn't run yet too.
+     * @return the number of statements which already ran that matched.
+     */
+    std::size_t set_log_site_mode(LogSiteState::Match match, std::string_view pattern, LogSiteState::Mode mode);
+    // Every statement follows its channel's level again
+    void clear_log_site_modes();
+
+    // Starts or stops counting the records and bytes of every call site, see LogProfiler
+    void set_log_profiling(bool enabled);
+    // The noisiest call sites first, at most top_n of them unless it is 0
+    [[nodiscard]] std::vector<LogProfiler::Entry> log_profile(std::size_t top_n = 0) const;
+    void reset_log_profile();
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+    /**
+     * @brief Enables the profiler and writes its report (LogProfiler::report_json) to path every interval, and once
+     * more when stopped. The file is replaced atomically, readers never see a partial report.
+     */
+    void start_log_profile_file(std::string path, std::chrono::milliseconds interval, std::size_t top_n = 0);
+    // The profiler stays enabled
+    void stop_log_profile_file();
+#endif
 };
 } // namespace octo::logger
 
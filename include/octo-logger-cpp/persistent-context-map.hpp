@@ -0,0 +1,65 @@
+/**
+ * @file persistent-context-map.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef PERSISTENT_CONTEXT_MAP_HPP_
+#define PERSISTENT_CONTEXT_MAP_HPP_
+
+#include "octo-logger-cpp/context-info.hpp"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace octo::logger
+{
+/**
+ * @brief An immutable map of context entries, a hash array mapped trie on the interned key id.
+ *
+ * Updates return a new map which shares every node off the updated paths with the old one, so setting a key
+ * allocates O(log32 n) nodes instead of copying all the entries. Maps may be read and updated from any number of
+ * threads, nodes are never modified once shared.
+ */
+class PersistentContextMap
+{
+  public:
+    typedef ContextInfo::Entry Entry;
+
+  private:
+    struct Node;
+    typedef std::shared_ptr<Node const> NodePtr;
+
+    NodePtr root_;
+    std::size_t size_;
+
+    PersistentContextMap(NodePtr root, std::size_t size);
+    // The node with entry set, node itself if it already has an equal entry
+    static NodePtr insert(NodePtr const& node, unsigned shift, std::shared_ptr<Entry const> const& entry, bool& added);
+    static void collect(Node const& node, std::vector<Entry const*>& entries);
+
+  public:
+    PersistentContextMap();
+    explicit PersistentContextMap(ContextInfo const& context_info);
+
+    // The map with key set to value
+    [[nodiscard]] PersistentContextMap set(ContextInfo::ContextInfoKey key, ContextInfo::ContextInfoValue value) const;
+    // The map with every entry of context_info set, including the ones it inherits from its parents
+    [[nodiscard]] PersistentContextMap update(ContextInfo const& context_info) const;
+
+    // nullptr if the key (see ContextInfo::intern) is not in the map
+    [[nodiscard]] Entry const* find(ContextInfo::ContextInfoKeyId id) const;
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] bool empty() const;
+    // Whether both maps share the same root, a map updated with values it already has is the same as before
+    [[nodiscard]] bool same_as(PersistentContextMap const& other) const;
+
+    // The entries as a flat ContextInfo, the layout the sinks read
+    [[nodiscard]] ContextInfo to_context_info() const;
+};
+} // namespace octo::logger
+
+#endif // PERSISTENT_CONTEXT_MAP_HPP_
@@ -0,0 +1,53 @@
+/**
+ * @file scoped-context.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef SCOPED_CONTEXT_HPP_
+#define SCOPED_CONTEXT_HPP_
+
+#include "octo-logger-cpp/context-info.hpp"
+
+namespace octo::logger
+{
+/**
+ * @brief Adds context entries to every record logged by the current thread while it is alive.
+ *
+ *     ScopedContext const request_context{{"request_id", request_id}};
+ *     logger.info("handling");  // has request_id, from any logger
+ *
+ * Scopes nest, an inner scope hides the values of the keys it shares with the outer ones until it ends. The
+ * entries of a record take precedence over the scoped ones, which take precedence over the logger's and the global
+ * context. Up to ContextInfo::INLINE_CAPACITY keys per scope are pushed and popped without allocating (apart from
+ * the values themselves).
+ * Scopes must end in the reverse order they started, on the thread that started them, so they can't be copied or
+ * moved.
+ */
+class ScopedContext final
+{
+  private:
+    // The keys this scope added, their values are not used
+    ContextInfo added_;
+    // The keys this scope replaced, with the values they had before
+    ContextInfo replaced_;
+
+  public:
+    explicit ScopedContext(ContextInfo::ContextInfoInitializerList entries);
+    explicit ScopedContext(ContextInfo const& entries);
+    ~ScopedContext();
+
+    ScopedContext(ScopedContext const&) = delete;
+    ScopedContext& operator=(ScopedContext const&) = delete;
+    ScopedContext(ScopedContext&&) = delete;
+    ScopedContext& operator=(ScopedContext&&) = delete;
+
+    // The entries of all the scopes of the current thread
+    [[nodiscard]] static ContextInfo const& current();
+};
+} // namespace octo::logger
+
+#endif // SCOPED_CONTEXT_HPP_
@@ -43,8 +43,11 @@ class SinkConfig
         CONSOLE_DISABLE_CONTEXT_INFO,
 
         LINE_FORMAT,
+        LINE_PATTERN,
+        LINE_LAYOUT,
         LOG_THREAD_ID,
         USE_SAFE_LOCALTIME_UTC,
+        USE_SAFE_LOCALTIME,
 #ifndef _WIN32
         FILE_LOG_FILES_PATH,
         FILE_SIZE_PER_LOG_FILE,
@@ -56,6 +59,14 @@ class SinkConfig
         FILE_NO_DATE_ON_NAME,
         FILE_LOG_FOLDER_NO_SEPARATE_BY_DATE,
         FILE_DISABLE_CONTEXT_INFO,
+        FILE_MAX_OPEN_FILES,
+        FILE_ATOMIC_APPEND,
+        FILE_SHARD_PER_THREAD,
+        FILE_PREOPEN_FILL_RATIO,
+        FILE_TIME_INDEX_RECORDS,
+        FILE_TIME_INDEX_BYTES,
+        FILE_BLOOM_KEYS,
+        FILE_BLOOM_BITS,
 
         SYSLOG_LOG_NAME,
 #endif
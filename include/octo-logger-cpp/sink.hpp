@@ -13,6 +13,10 @@
 #define SINK_HPP_
 
 #include "octo-logger-cpp/channel.hpp"
+#include "octo-logger-cpp/compat.hpp"
+#include "octo-logger-cpp/line-layout.hpp"
+#include "octo-logger-cpp/line-pattern.hpp"
+#include "octo-logger-cpp/log-profiler.hpp"
 #include "octo-logger-cpp/log.hpp"
 #include "octo-logger-cpp/logger.hpp"
 #include "octo-logger-cpp/sink-config.hpp"
@@ -43,11 +47,28 @@ class Sink
     const SinkConfig config_;
     std::atomic<bool> is_discarding_;
 
+    // formatted_log without the profiler accounting
+    std::string formatted_line(Log const& log,
+                               Channel const& channel,
+                               ContextInfo const& context_info,
+                               ContextInfo const& global_context_info,
+                               bool disable_context_info) const;
+
   protected:
     const SinkConfig& config() const;
     const std::string origin_;
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+    // origin_ encoded as a JSON string, empty if it is not valid UTF-8
+    const std::string origin_json_;
+#endif
     const LineFormat line_format_;
+    // The layout of the plaintext formats, LINE_PATTERN or the predefined one of line_format_
+    const LinePattern line_pattern_;
+    // LINE_LAYOUT, takes precedence over line_format_ when set
+    const LineLayoutPtr line_layout_;
     const bool safe_localtime_utc_;
+    // USE_SAFE_LOCALTIME_UTC takes precedence over USE_SAFE_LOCALTIME
+    const compat::LocaltimeMode localtime_mode_;
 
     std::string formatted_log_plaintext_long(Log const& log,
                                              Channel const& channel,
@@ -55,6 +76,20 @@ class Sink
                                              ContextInfo const& global_context_info,
                                              bool disable_context_info) const;
     std::string formatted_log_plaintext_short(Log const& log, Channel const& channel) const;
+    void append_line_pattern(std::string& out,
+                             LinePattern const& pattern,
+                             Log const& log,
+                             Channel const& channel,
+                             ContextInfo const& context_info,
+                             ContextInfo const& global_context_info,
+                             bool disable_context_info) const;
+    void append_line_layout(std::string& out,
+                            LineLayout const& layout,
+                            Log const& log,
+                            Channel const& channel,
+                            ContextInfo const& context_info,
+                            ContextInfo const& global_context_info,
+                            bool disable_context_info) const;
 #ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
     nlohmann::json construct_log_json(Log const& log,
                                       Channel const& channel,
@@ -64,6 +99,27 @@ class Sink
                                    Channel const& channel,
                                    ContextInfo const& context_info,
                                    ContextInfo const& global_context_info) const;
+    [[nodiscard]] std::string formatted_json_timestamp(Log const& log) const;
+    // origin_func_name, and origin_file and origin_line for records logged with the OCTO_LOG_* macros
+    static void set_json_source_location(nlohmann::json& j, Log const& log);
+    /**
+     * @brief Streams the same document as construct_log_json(...).dump(indent) into out, without building a DOM.
+     *
+     * host_json and service_json are pre-encoded JSON strings (see JsonWriter::append_string) and are omitted when
+     * empty, thread_id is added to the context_info when not empty.
+     *
+     * @return false if one of the strings is not valid UTF-8, in which case out should be discarded and the
+     * construct_log_json path should be used to get the same error handling.
+     */
+    bool write_log_json(std::string& out,
+                        Log const& log,
+                        Channel const& channel,
+                        ContextInfo const& context_info,
+                        ContextInfo const& global_context_info,
+                        int indent,
+                        std::string_view host_json = {},
+                        std::string_view service_json = {},
+                        std::string_view thread_id = {}) const;
 #endif
 
     std::string formatted_log(Log const& log,
@@ -71,6 +127,14 @@ class Sink
                               ContextInfo const& context_info,
                               ContextInfo const& global_context_info,
                               bool disable_context_info) const;
+    // Adds the bytes of a record to the sink's LogProfiler counters, formatted_log does it for the lines it returns
+    inline void count_formatted_bytes(Log const& log, Channel const& channel, std::size_t bytes) const
+    {
+        if (LogProfiler::enabled())
+        {
+            LogProfiler::count_bytes(log.site(), channel.channel_name(), sink_name(), bytes);
+        }
+    }
 
     inline static LineFormat extract_format_with_default(const SinkConfig& config, LineFormat default_format)
     {
@@ -105,6 +169,15 @@ class Sink
     virtual void restart_sink() noexcept
     {
     }
+    // Whether dump may be called by several threads at once, otherwise the manager calls it one record at a time
+    [[nodiscard]] virtual bool thread_safe_dump() const noexcept
+    {
+        return false;
+    }
+    // Called in the child after fork, before anything is logged
+    virtual void child_on_fork() noexcept
+    {
+    }
 };
 typedef std::shared_ptr<Sink> SinkPtr;
 } // namespace octo::logger
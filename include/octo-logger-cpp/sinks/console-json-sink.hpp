@@ -43,6 +43,9 @@ class ConsoleJSONSink : public Sink
   private:
     std::string const host_;
     std::string const service_;
+    // host_ and service_ encoded as JSON strings, empty if they are not valid UTF-8
+    std::string const host_json_;
+    std::string const service_json_;
     int const indent_;
     bool const log_thread_id_;
 
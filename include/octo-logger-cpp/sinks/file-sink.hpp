@@ -15,25 +15,81 @@
 #ifndef _WIN32
 
 #include "octo-logger-cpp/channel.hpp"
+#include "octo-logger-cpp/fork-safe-mutex.hpp"
+#include "octo-logger-cpp/log-bloom-filter.hpp"
+#include "octo-logger-cpp/log-time-index.hpp"
 #include "octo-logger-cpp/log.hpp"
 #include "octo-logger-cpp/logger.hpp"
 #include "octo-logger-cpp/sink-config.hpp"
 #include "octo-logger-cpp/sink.hpp"
+#include <atomic>
 #include <cinttypes>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <list>
+#include <memory>
+#include <optional>
 #include <string>
+#include <sys/types.h>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace octo::logger
 {
 class FileSink : public Sink
 {
+  public:
+    /**
+     * @brief Counters of the open file handles cache, used with FILE_MAX_OPEN_FILES.
+     *
+     * A high reopens to opens ratio means the cap is too small for the amount of active channels (thrashing).
+     */
+    struct OpenFilesStats
+    {
+        std::uint64_t opens;
+        std::uint64_t reopens;
+        std::uint64_t evictions;
+        std::size_t open_files;
+        // Rotations which swapped in a segment opened ahead of time (FILE_PREOPEN_FILL_RATIO)
+        std::uint64_t preopened_rotations;
+    };
+
   private:
     struct File
     {
+        // Held while the file is written, rotated or closed, by dump and by the eviction of the open files cap
+        ForkSafeMutex mtx;
         std::ofstream stream;
+        // Used instead of the stream with FILE_ATOMIC_APPEND
+        int fd;
         std::uint32_t index;
+        std::string path;
+        // Guarded by lru_mtx_
+        std::list<File*>::iterator lru_position;
+        bool in_lru;
+        // The next segment, opened by the preopen thread once the file passes FILE_PREOPEN_FILL_RATIO
+        std::unique_ptr<std::ofstream> next_stream;
+        std::string next_path;
+        pid_t next_pid;
+        bool next_requested;
+        // Time index of the segment, see LogTimeIndex: the end of the records written so far and the current block
+        std::uint64_t index_offset;
+        std::uint64_t index_records;
+        std::uint64_t index_bytes;
+        std::uint64_t index_block_offset;
+        std::int64_t index_min_timestamp;
+        std::int64_t index_max_timestamp;
+        bool index_started;
+        // The .idx sidecar, opened on the first entry and closed with the segment
+        int index_fd;
+        // Context values of the segment, written to its .bloom file when the segment is closed
+        std::unique_ptr<LogBloomFilter> bloom;
         File();
+
+        [[nodiscard]] bool is_open() const;
     };
 
   private:
@@ -42,16 +98,100 @@ class FileSink : public Sink
     std::string combined_channels_prefix_;
     long size_per_file_;
     int max_files_;
+    // Files are only removed by the destructor, so the references dump takes stay valid
     std::unordered_map<std::string, std::shared_ptr<File>> current_files_;
+    ForkSafeMutex files_mtx_;
     bool separate_channels_to_files_;
     bool separate_logs_by_date_folder_;
     std::string strftime_format_;
     bool disable_file_context_info_;
+    int max_open_files_;
+    bool atomic_append_;
+    // Each logging thread gets its own files, named <name>.t<tid>[.<index>].log
+    bool shard_per_thread_;
+    /*
+     * Open files ordered by last use, most recently used first. Only maintained when max_open_files_ is set.
+     * The files taken out of it past the cap are closed by evict_files once the thread that took them out releases its
+     * own file, so a thread never holds two file locks. lru_mtx_ is taken under a file lock, never the other way around.
+     */
+    std::list<File*> open_files_lru_;
+    std::vector<File*> evicted_files_;
+    ForkSafeMutex lru_mtx_;
+    std::atomic<std::uint64_t> opens_count_;
+    std::atomic<std::uint64_t> reopens_count_;
+    std::atomic<std::uint64_t> evictions_count_;
+    std::atomic<std::size_t> open_files_count_;
+    std::atomic<std::uint64_t> preopened_rotations_count_;
+    // Fill ratio of the active segment after which the next one is opened in the background, 0 disables it
+    double preopen_fill_ratio_;
+    bool preopen_running_;
+    std::unique_ptr<std::thread> preopen_thread_;
+    std::deque<std::function<void()>> preopen_tasks_;
+    std::unique_ptr<std::condition_variable> preopen_cond_;
+    ForkSafeMutex preopen_mtx_;
+    pid_t preopen_pid_;
+    // Write a time index entry every N records and/or every K bytes, both 0 disables the index
+    std::uint64_t time_index_records_;
+    std::uint64_t time_index_bytes_;
+    // Context keys indexed by the per segment Bloom filter, the extra identifier is always indexed when enabled
+    bool bloom_enabled_;
+    std::vector<std::string> bloom_keys_;
+    // Interned once, records are looked up by id
+    std::vector<ContextInfo::ContextInfoKeyId> bloom_key_ids_;
+    std::size_t bloom_bits_;
 
   private:
     static int recursive_folder_creation(const char* dir, mode_t mode);
     void create_log_path();
-    void switch_stream(const std::string& channel);
+    // The suffix of the shard files of the calling thread, cached per thread
+    static std::string& thread_shard_suffix();
+    // The file of key, created without a segment if there is none yet (File::path is empty)
+    [[nodiscard]] std::shared_ptr<File> find_file(const std::string& key);
+    [[nodiscard]] std::string file_key(const std::string& channel) const;
+    [[nodiscard]] std::string file_base_name(const std::string& channel) const;
+    // The base name without the date and time, the name of the lock file of FILE_ATOMIC_APPEND
+    [[nodiscard]] std::string file_group_name(const std::string& channel) const;
+    [[nodiscard]] std::string file_path(const std::string& base_name, std::uint32_t index) const;
+    [[nodiscard]] std::optional<std::uint32_t> latest_file_index(const std::string& base_name) const;
+    // Moves file to its next segment, or to its first one, after the ones already in the folder when scan is set
+    void switch_stream(File& file, const std::string& channel, bool scan);
+    void switch_shared_stream(File& file, const std::string& channel);
+    void open_stream(File& file, bool reopen);
+    void close_stream(File& file);
+    [[nodiscard]] std::int64_t file_size(File& file) const;
+    void write_record(File& file, std::string&& line);
+    void touch_open_file(File& file);
+    void evict_files();
+    void start_preopen_thread();
+    void stop_preopen_thread();
+    void preopen_thread();
+    [[nodiscard]] bool preopen_available();
+    void enqueue_preopen_task(std::function<void()>&& task);
+    void request_next_segment(File& file, const std::string& channel);
+    void prepare_next_segment(File& file, std::string const& path);
+    bool swap_to_next_segment(File& file);
+    void discard_next_segment(File& file);
+    [[nodiscard]] bool time_index_enabled() const;
+    void start_time_index(File& file);
+    void update_time_index(File& file, Log const& log, std::size_t record_size);
+    void close_time_index(File& file);
+    void append_time_index_entries(File& file, LogTimeIndex::Entry const* entries, std::size_t count);
+    void close_time_index_file(File& file);
+    // The part of dump under the lock of file
+    void dump_to_file(File& file,
+                      const std::string& channel_name,
+                      const Log& log,
+                      const Channel& channel,
+                      ContextInfo const& context_info,
+                      ContextInfo const& global_context_info);
+    void update_bloom_filter(File& file,
+                             Log const& log,
+                             ContextInfo const& context_info,
+                             ContextInfo const& global_context_info);
+    void write_bloom_filter(File& file);
+
+  protected:
+    void stop_impl() override;
 
   public:
     explicit FileSink(const SinkConfig& config);
@@ -61,6 +201,15 @@ class FileSink : public Sink
               const Channel& channel,
               ContextInfo const& context_info,
               ContextInfo const& global_context_info) override;
+
+    void restart_sink() noexcept override;
+    [[nodiscard]] bool thread_safe_dump() const noexcept override;
+    void child_on_fork() noexcept override;
+
+    [[nodiscard]] OpenFilesStats open_files_stats() const;
+
+    // Refreshes the shard suffix of the forking thread in the child after fork (Manager::child_on_fork)
+    static void refresh_thread_shard_suffix();
 };
 } // namespace octo::logger
 
@@ -0,0 +1,108 @@
+/**
+ * @file time-zone.hpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef TIME_ZONE_HPP_
+#define TIME_ZONE_HPP_
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace octo::logger
+{
+/**
+ * @brief Time zone loaded from a TZif file (tzfile(5)), converting UTC to local time without locks.
+ *
+ * localtime_r takes the glibc time zone lock, which a child may inherit locked after fork (see compat.hpp). The zone
+ * is parsed once into a transition table, after which conversions are a binary search and a civil date calculation.
+ * Times past the last transition follow the POSIX TZ rule in the file footer. Leap seconds ("right/" zones) are
+ * ignored.
+ */
+class TimeZone
+{
+  public:
+    struct LocalTimeType
+    {
+        std::int32_t utc_offset;
+        bool is_dst;
+        // Offset of the abbreviation in abbreviations_
+        std::uint32_t abbreviation;
+    };
+
+  private:
+    // Day of the year a POSIX rule switches on, and the local time of day it does so
+    struct RuleDate
+    {
+        enum class Kind : std::uint8_t
+        {
+            JULIAN_NO_LEAP, // Jn, 1-365, February 29th is never counted
+            JULIAN,         // n, 0-365
+            MONTH_WEEK_DAY, // Mm.w.d
+        };
+        Kind kind = Kind::MONTH_WEEK_DAY;
+        int day = 0;
+        int week = 0;
+        int month = 0;
+        std::int32_t time = 2 * 60 * 60;
+    };
+
+    // POSIX TZ rule, e.g. CET-1CEST,M3.5.0,M10.5.0/3
+    struct PosixRule
+    {
+        bool valid = false;
+        LocalTimeType standard = {0, false, 0};
+        bool has_dst = false;
+        LocalTimeType dst = {0, true, 0};
+        RuleDate start;
+        RuleDate end;
+    };
+
+    std::vector<std::int64_t> transitions_;
+    std::vector<std::uint8_t> transition_types_;
+    std::vector<LocalTimeType> types_;
+    // NUL separated abbreviations, tm_zone points into it
+    std::string abbreviations_;
+    PosixRule rule_;
+
+    bool parse_tzif(std::string_view data);
+    bool parse_rule(std::string_view rule);
+    std::uint32_t add_abbreviation(std::string_view abbreviation);
+    [[nodiscard]] LocalTimeType const& rule_type(std::int64_t time) const;
+    [[nodiscard]] static std::int64_t rule_transition(RuleDate const& date, std::int64_t year, std::int32_t utc_offset);
+
+  public:
+    // UTC until something is loaded
+    TimeZone();
+
+    /**
+     * @brief Loads a zone the way glibc resolves TZ: a name under TZDIR (/usr/share/zoneinfo), an absolute path, or a
+     * POSIX TZ string. An empty name uses the TZ environment variable, and /etc/localtime when it is not set.
+     * @return false if the zone could not be loaded, in which case it is left as UTC.
+     */
+    bool load(std::string const& name);
+    bool load_file(std::string const& path);
+
+    [[nodiscard]] LocalTimeType const& local_time_type(std::int64_t time) const;
+    [[nodiscard]] char const* abbreviation(LocalTimeType const& type) const;
+
+    /**
+     * @brief Same as localtime_r, with tm_gmtoff and tm_zone filled where struct tm has them.
+     */
+    struct tm* to_local(std::int64_t time, struct tm* result) const;
+
+    /**
+     * @brief The zone of the process (TZ or /etc/localtime), loaded on first use and never reloaded.
+     */
+    [[nodiscard]] static TimeZone const& local();
+};
+} // namespace octo::logger
+
+#endif // TIME_ZONE_HPP_
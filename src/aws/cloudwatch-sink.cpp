@@ -362,23 +362,21 @@ std::string CloudWatchSink::formatted_json(Log const& log,
                                            ContextInfo const& context_info,
                                            ContextInfo const& global_context_info) const
 {
+    std::string_view const thread_id = log_thread_id_ ? compat::thread_id_string() : std::string_view();
+    std::string message;
+    if (write_log_json(message, log, channel, context_info, global_context_info, -1, {}, {}, thread_id))
+    {
+        return message;
+    }
+
+    // Invalid UTF-8, the DOM reports it the same way as before
     nlohmann::json j;
-    std::stringstream ss;
-    std::time_t const log_time_t = std::chrono::system_clock::to_time_t(log.time_created());
-    struct tm timeinfo = {};
-    auto const ms = std::chrono::duration_cast<std::chrono::milliseconds>(log.time_created().time_since_epoch()) % 1000;
-    compat::localtime(&log_time_t, &timeinfo, safe_localtime_utc_);
-    // Put datetime with milliseconds: YYYY-MM-DDTHH:MM:SS.mmm
-    ss << std::put_time(&timeinfo, "%FT%T");
-    ss << "." << std::setfill('0') << std::setw(3) << ms.count();
-    // Put timezone as offset from UTC: ±HHMM
-    ss << std::put_time(&timeinfo, "%z");
     j["message"] = log.str();
     j["origin"] = origin_;
     j["origin_service_name"] = channel.channel_name();
-    j["timestamp"] = ss.str(); // ISO 8601
+    j["timestamp"] = formatted_json_timestamp(log); // ISO 8601
     j["log_level"] = LogLevelUtils::level_to_string_upper(log.log_level());
-    j["origin_func_name"] = "";
+    set_json_source_location(j, log);
 
     j["context_info"] = init_context_info(log, channel, context_info, global_context_info);
 
@@ -402,16 +400,15 @@ void CloudWatchSink::init_context_info(nlohmann::json& dst,
     }
 
     // This determines the precedence of the different contexts - the most local context_info has the highest precedence
-    for (auto const& ci_itr : {log.context_info(), context_info, global_context_info})
-    {
-        for (auto const& [key, value] : ci_itr)
-        {
-            if (!dst.contains(key))
-            {
-                dst[key.data()] = value;
-            }
-        }
-    }
+    // Keys already in dst win, the merge itself yields every key once
+    bool const had_keys = !dst.empty();
+    ContextInfo::merge({&log.context_info(), &log.scoped_context(), &context_info, &global_context_info},
+                       [&dst, had_keys](ContextInfo::Entry const& entry) {
+                           if (!had_keys || !dst.contains(entry.key))
+                           {
+                               dst[entry.key.data()] = entry.value;
+                           }
+                       });
 
     if (!log.extra_identifier().empty())
     {
@@ -420,9 +417,7 @@ void CloudWatchSink::init_context_info(nlohmann::json& dst,
 
     if (log_thread_id_)
     {
-        std::ostringstream oss;
-        oss << std::this_thread::get_id();
-        dst["thread_id"] = oss.str();
+        dst["thread_id"] = compat::thread_id_string();
     }
 }
 
@@ -462,6 +457,7 @@ void CloudWatchSink::dump(Log const& log,
         {
             return;
         }
+        count_formatted_bytes(log, channel, message.size());
         // Set the event and add it to the queue
         e.WithTimestamp(Aws::Utils::DateTime(log.time_created()).Millis()).WithMessage(std::move(message));
         logs_queue_.push_back(CloudWatchLog{std::move(e), std::move(log_name)});
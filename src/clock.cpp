@@ -0,0 +1,248 @@
+/**
+ * @file clock.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/clock.hpp"
+
+#include <ctime>
+#include <thread>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define OCTO_LOGGER_TSC_CLOCK
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+namespace
+{
+using octo::logger::Clock;
+
+Clock::TimePoint time_point_from_ns(std::int64_t ns)
+{
+    return Clock::TimePoint(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+std::int64_t system_now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+#ifdef CLOCK_REALTIME_COARSE
+class CoarseClock : public Clock
+{
+  public:
+    [[nodiscard]] TimePoint now() noexcept override
+    {
+        struct timespec ts = {};
+        clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+        return time_point_from_ns(static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec);
+    }
+};
+#endif
+
+#ifdef OCTO_LOGGER_TSC_CLOCK
+/**
+ * @brief Wall time extrapolated from the TSC.
+ *
+ * The calibration (a TSC / wall time pair and the rate between them) is published with a sequence lock. Once the
+ * resync point passes, the first caller takes a new pair. The rate is measured from the first pair, so it gets more
+ * precise the longer the clock runs.
+ */
+class TscClock : public Clock
+{
+  private:
+    static std::int64_t constexpr RESYNC_INTERVAL_NS = 1000000000;
+    static std::int64_t constexpr INITIAL_CALIBRATION_NS = 5000000;
+    // Larger rate changes are wall clock steps (settimeofday, NTP), after which the rate is measured again
+    static double constexpr MAX_RATE_CHANGE = 0.01;
+
+    std::atomic<std::uint32_t> sequence_;
+    std::atomic<std::uint64_t> base_tsc_;
+    std::atomic<std::int64_t> base_ns_;
+    std::atomic<double> ns_per_tick_;
+    std::atomic<std::uint64_t> resync_tsc_;
+    std::atomic<bool> resyncing_;
+    std::uint64_t origin_tsc_;
+    std::int64_t origin_ns_;
+
+    static void sample(std::uint64_t& tsc, std::int64_t& ns) noexcept
+    {
+        std::uint64_t const before = __rdtsc();
+        ns = system_now_ns();
+        std::uint64_t const after = __rdtsc();
+        tsc = before + (after - before) / 2;
+    }
+
+    void publish(std::uint64_t tsc, std::int64_t ns, double ns_per_tick) noexcept
+    {
+        sequence_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        base_tsc_.store(tsc, std::memory_order_relaxed);
+        base_ns_.store(ns, std::memory_order_relaxed);
+        ns_per_tick_.store(ns_per_tick, std::memory_order_relaxed);
+        sequence_.fetch_add(1, std::memory_order_release);
+        resync_tsc_.store(tsc + static_cast<std::uint64_t>(RESYNC_INTERVAL_NS / ns_per_tick),
+                          std::memory_order_relaxed);
+    }
+
+    void resync() noexcept
+    {
+        if (resyncing_.exchange(true, std::memory_order_acquire))
+        {
+            return;
+        }
+        std::uint64_t tsc;
+        std::int64_t ns;
+        sample(tsc, ns);
+        double const previous = ns_per_tick_.load(std::memory_order_relaxed);
+        double ns_per_tick = previous;
+        if (tsc > origin_tsc_)
+        {
+            double const measured = static_cast<double>(ns - origin_ns_) / static_cast<double>(tsc - origin_tsc_);
+            if (measured > previous * (1 - MAX_RATE_CHANGE) && measured < previous * (1 + MAX_RATE_CHANGE))
+            {
+                ns_per_tick = measured;
+            }
+            else
+            {
+                origin_tsc_ = tsc;
+                origin_ns_ = ns;
+            }
+        }
+        publish(tsc, ns, ns_per_tick);
+        resyncing_.store(false, std::memory_order_release);
+    }
+
+  public:
+    TscClock() : sequence_(0), base_tsc_(0), base_ns_(0), ns_per_tick_(1), resync_tsc_(0), resyncing_(false)
+    {
+        sample(origin_tsc_, origin_ns_);
+        std::this_thread::sleep_for(std::chrono::nanoseconds(INITIAL_CALIBRATION_NS));
+        std::uint64_t tsc;
+        std::int64_t ns;
+        sample(tsc, ns);
+        publish(tsc, ns, static_cast<double>(ns - origin_ns_) / static_cast<double>(tsc - origin_tsc_));
+    }
+
+    [[nodiscard]] static bool supported()
+    {
+        unsigned eax = 0;
+        unsigned ebx = 0;
+        unsigned ecx = 0;
+        unsigned edx = 0;
+        // CPUID 0x80000007 EDX bit 8: the TSC ticks at a constant rate in all P/C states
+        return __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) != 0 && (edx & (1U << 8)) != 0;
+    }
+
+    [[nodiscard]] TimePoint now() noexcept override
+    {
+        std::uint64_t const tsc = __rdtsc();
+        if (tsc >= resync_tsc_.load(std::memory_order_relaxed))
+        {
+            resync();
+        }
+        std::uint32_t sequence;
+        std::uint64_t base_tsc;
+        std::int64_t base_ns;
+        double ns_per_tick;
+        do
+        {
+            sequence = sequence_.load(std::memory_order_acquire);
+            base_tsc = base_tsc_.load(std::memory_order_relaxed);
+            base_ns = base_ns_.load(std::memory_order_relaxed);
+            ns_per_tick = ns_per_tick_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((sequence & 1) != 0 || sequence != sequence_.load(std::memory_order_relaxed));
+        // The TSCs of different cores may be slightly apart, so the difference is signed
+        auto const ticks = static_cast<std::int64_t>(tsc - base_tsc);
+        return time_point_from_ns(base_ns + static_cast<std::int64_t>(static_cast<double>(ticks) * ns_per_tick));
+    }
+
+    void child_on_fork() noexcept override
+    {
+        // The thread that was resyncing doesn't exist in the child
+        resyncing_.store(false, std::memory_order_relaxed);
+        if ((sequence_.load(std::memory_order_relaxed) & 1) != 0)
+        {
+            sequence_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+};
+#endif
+} // namespace
+
+namespace octo::logger
+{
+std::atomic<Clock*> Clock::active_{nullptr};
+
+ClockPtr Clock::create(ClockType type)
+{
+    switch (type)
+    {
+#ifdef CLOCK_REALTIME_COARSE
+        case ClockType::REALTIME_COARSE:
+            return std::make_shared<CoarseClock>();
+#endif
+#ifdef OCTO_LOGGER_TSC_CLOCK
+        case ClockType::TSC:
+            if (TscClock::supported())
+            {
+                return std::make_shared<TscClock>();
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+    return std::make_shared<SystemClock>();
+}
+
+void Clock::set_active(Clock* clock) noexcept
+{
+    active_.store(clock, std::memory_order_release);
+}
+
+Clock* Clock::active() noexcept
+{
+    return active_.load(std::memory_order_acquire);
+}
+
+Clock::TimePoint SystemClock::now() noexcept
+{
+    return std::chrono::system_clock::now();
+}
+
+FakeClock::FakeClock(TimePoint start, std::chrono::nanoseconds step)
+    : now_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count()),
+      step_ns_(step.count())
+{
+}
+
+Clock::TimePoint FakeClock::now() noexcept
+{
+    return time_point_from_ns(now_ns_.fetch_add(step_ns_.load(std::memory_order_relaxed), std::memory_order_relaxed));
+}
+
+void FakeClock::set(TimePoint time) noexcept
+{
+    now_ns_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count(),
+                  std::memory_order_relaxed);
+}
+
+void FakeClock::advance(std::chrono::nanoseconds duration) noexcept
+{
+    now_ns_.fetch_add(duration.count(), std::memory_order_relaxed);
+}
+
+void FakeClock::set_step(std::chrono::nanoseconds step) noexcept
+{
+    step_ns_.store(step.count(), std::memory_order_relaxed);
+}
+} // namespace octo::logger
@@ -10,81 +10,161 @@
  */
 #include <cstdint>
 #include <iostream>
+#include <sstream>
+#include <thread>
 #include "octo-logger-cpp/compat.hpp"
-namespace octo::logger::compat
+#include "octo-logger-cpp/time-zone.hpp"
+#if defined(__linux__)
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+namespace
 {
-
-// See https://sourceware.org/bugzilla/show_bug.cgi?id=16145
-void gmtime_safe_internal(time_t time, long timezone, struct tm *tm_time) 
+// Written without allocating, so it can be refreshed in a forked child
+struct ProcessIdString
 {
-    const char Days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-    std::uint32_t n32_Pass4year = 0;
-    std::uint32_t n32_hpery = 0;
+    char digits[24];
+    std::size_t size;
 
-    time=time + (timezone * 60 * 60);
-
-    if(time < 0)
-    {
-        time = 0;
-    }
-    tm_time->tm_sec=(int)(time % 60);
-    time /= 60;
-    tm_time->tm_min=(int)(time % 60);
-    time /= 60;
-    // Find number of 4-year periods (1461 days) passed since the epoch
-    n32_Pass4year=((unsigned int)time / (1461L * 24L));
-    // Multiply number of 4-year periods by 4 in order to get the number of years passed since the epoch, and add 70 because the epoch year is 1970
-    tm_time->tm_year=(n32_Pass4year << 2)+70;
-    time %= 1461L * 24L;
-    for (;;)
+    void refresh() noexcept
     {
-        n32_hpery = 365 * 24;
-        // Check for Leap year
-        if ((tm_time->tm_year & 3) == 0)
+#ifdef _WIN32
+        auto pid = static_cast<std::uint64_t>(GetCurrentProcessId());
+#else
+        auto pid = static_cast<std::uint64_t>(::getpid());
+#endif
+        char reversed[sizeof(digits)];
+        std::size_t count = 0;
+        do
         {
-            n32_hpery += 24;
-        }
-        if (time < n32_hpery)
+            reversed[count++] = static_cast<char>('0' + pid % 10);
+            pid /= 10;
+        } while (pid != 0);
+        for (size = 0; size < count; ++size)
         {
-            break;
+            digits[size] = reversed[count - size - 1];
         }
-        tm_time->tm_year++;
-        time -= n32_hpery;
     }
-    tm_time->tm_hour=(int)(time % 24);
-    // At this point `time` represents the number of days passed since the epoch
-    time /= 24;
-    // Assumed to be due to days starting from 1, so we add 1 to the day count
-    time++;
-    if ((tm_time->tm_year & 3) == 0)
+};
+
+ProcessIdString& process_id()
+{
+    static ProcessIdString pid = [] {
+        ProcessIdString value{};
+        value.refresh();
+        return value;
+    }();
+    return pid;
+}
+} // namespace
+
+namespace octo::logger::compat
+{
+
+// See https://sourceware.org/bugzilla/show_bug.cgi?id=16145
+void gmtime_safe_internal(time_t time, long timezone, struct tm *tm_time)
+{
+    long const offset = timezone * 60 * 60;
+    civil_from_seconds(static_cast<std::int64_t>(time) + offset, tm_time);
+    // A fixed offset, DST is never in effect
+    tm_time->tm_isdst = 0;
+#ifndef _WIN32
+    tm_time->tm_gmtoff = offset;
+#endif
+}
+
+struct tm* localtime_safe(time_t time, struct tm* result)
+{
+    return TimeZone::local().to_local(static_cast<std::int64_t>(time), result);
+}
+
+void civil_from_seconds(std::int64_t seconds, struct tm* tm_time) noexcept
+{
+    std::int64_t constexpr SECONDS_PER_DAY = 24 * 60 * 60;
+    std::int64_t days = seconds / SECONDS_PER_DAY;
+    std::int64_t second_of_day = seconds % SECONDS_PER_DAY;
+    if (second_of_day < 0)
     {
-        if (time > 60)
-        {
-            // Decrement the day by 1 to account for the extra day in February, so that the day in the month is calculated correctly below
-            time--;
-        }
-        else
+        second_of_day += SECONDS_PER_DAY;
+        --days;
+    }
+    tm_time->tm_hour = static_cast<int>(second_of_day / 3600);
+    tm_time->tm_min = static_cast<int>(second_of_day / 60 % 60);
+    tm_time->tm_sec = static_cast<int>(second_of_day % 60);
+    // 1970-01-01 was a Thursday
+    tm_time->tm_wday = static_cast<int>(((days + 4) % 7 + 7) % 7);
+
+    // See http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+    std::int64_t const shifted = days + 719468;
+    std::int64_t const era = (shifted >= 0 ? shifted : shifted - 146096) / 146097;
+    auto const doe = static_cast<unsigned>(shifted - era * 146097);
+    unsigned const yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned const doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned const mp = (5 * doy + 2) / 153;
+    unsigned const day = doy - (153 * mp + 2) / 5 + 1;
+    unsigned const month = mp < 10 ? mp + 3 : mp - 9;
+    std::int64_t const year = static_cast<std::int64_t>(yoe) + era * 400 + (month <= 2 ? 1 : 0);
+    tm_time->tm_year = static_cast<int>(year - 1900);
+    tm_time->tm_mon = static_cast<int>(month - 1);
+    tm_time->tm_mday = static_cast<int>(day);
+    tm_time->tm_yday = static_cast<int>(days - days_from_civil(year, 1, 1));
+}
+
+std::uint64_t current_thread_id() noexcept
+{
+#if defined(__linux__)
+    return static_cast<std::uint64_t>(::syscall(SYS_gettid));
+#elif defined(__APPLE__)
+    std::uint64_t tid = 0;
+    pthread_threadid_np(nullptr, &tid);
+    return tid;
+#elif defined(_WIN32)
+    return static_cast<std::uint64_t>(GetCurrentThreadId());
+#else
+    return 0;
+#endif
+}
+
+std::string const& thread_id_string()
+{
+    thread_local std::string const thread_id = [] {
+        std::ostringstream oss;
+        oss << std::this_thread::get_id();
+        return oss.str();
+    }();
+    return thread_id;
+}
+
+std::string const& thread_name()
+{
+    thread_local std::string const name = [] {
+#if defined(__linux__) || defined(__APPLE__)
+        char buffer[64] = {};
+        if (pthread_getname_np(pthread_self(), buffer, sizeof(buffer)) == 0)
         {
-            // Account for the edge case of February 29th on a leap year
-            if (time == 60)
-            {
-                tm_time->tm_mon = 1;
-                tm_time->tm_mday = 29;
-                return;
-            }
+            return std::string(buffer);
         }
-    }
-    // Find the month and day in the month
-    for (tm_time->tm_mon = 0; Days[tm_time->tm_mon] < time;tm_time->tm_mon++)
-    {
-        time -= Days[tm_time->tm_mon];
-    }
+#endif
+        return std::string();
+    }();
+    return name;
+}
 
-    tm_time->tm_mday = (int)(time);
+std::string_view process_id_string() noexcept
+{
+    auto const& pid = process_id();
+    return std::string_view(pid.digits, pid.size);
+}
 
-    // Always set daylight saving time to 0 (i.e DST not in effect), as we currently do not handle it.
-    tm_time->tm_isdst = 0;
-    return;
+void refresh_process_id() noexcept
+{
+    process_id().refresh();
 }
 
 } // namespace octo::logger::compat
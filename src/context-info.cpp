@@ -10,85 +10,518 @@
  */
 
 #include "octo-logger-cpp/context-info.hpp"
+#include "octo-logger-cpp/fork-safe-mutex.hpp"
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+#include "octo-logger-cpp/json-writer.hpp"
+#endif
+#include <atomic>
+#include <deque>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace
+{
+using octo::logger::ContextInfo;
+
+/**
+ * @brief The process wide key interning table.
+ *
+ * The names live in a deque, which never moves its elements, so the string_views handed out stay valid. The table is
+ * never destroyed, records may still be formatted while static destructors run.
+ */
+class KeyTable
+{
+  private:
+    octo::logger::ForkSafeMutex mutex_;
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, ContextInfo::ContextInfoKeyId> ids_;
+    // The number of names, read without the lock
+    std::atomic<std::size_t> size_{0};
+
+  public:
+    static KeyTable& instance()
+    {
+        static auto* const table = new KeyTable();
+        return *table;
+    }
+
+    std::pair<ContextInfo::ContextInfoKeyId, std::string_view> intern(std::string_view key)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto const it = ids_.find(key);
+        if (it != ids_.end())
+        {
+            return {it->second, it->first};
+        }
+        auto const id = static_cast<ContextInfo::ContextInfoKeyId>(names_.size());
+        std::string_view const name(names_.emplace_back(key));
+        ids_.emplace(name, id);
+        size_.store(names_.size(), std::memory_order_release);
+        return {id, name};
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    // Adds the names from id from onwards to cache, returns the number of names
+    template <typename Cache>
+    std::size_t copy_names(std::size_t from, Cache& cache)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::size_t id = from; id < names_.size(); ++id)
+        {
+            cache.emplace(names_[id], static_cast<ContextInfo::ContextInfoKeyId>(id));
+        }
+        return names_.size();
+    }
+
+    void child_on_fork()
+    {
+        mutex_.fork_reset();
+    }
+};
+
+// The keys this thread already looked up or interned, the views point into the table
+std::unordered_map<std::string_view, ContextInfo::ContextInfoKeyId>& thread_key_cache()
+{
+    thread_local std::unordered_map<std::string_view, ContextInfo::ContextInfoKeyId> cache;
+    return cache;
+}
+
+bool find_key(std::string_view key, std::pair<ContextInfo::ContextInfoKeyId, std::string_view>& result)
+{
+    // The whole table up to this size is in the cache of this thread
+    thread_local std::size_t cached_size = 0;
+    auto& cache = thread_key_cache();
+    auto it = cache.find(key);
+    if (it == cache.end())
+    {
+        // A key which was never interned is not in any context, the miss takes no lock unless keys were added
+        KeyTable& table = KeyTable::instance();
+        if (table.size() == cached_size)
+        {
+            return false;
+        }
+        cached_size = table.copy_names(cached_size, cache);
+        it = cache.find(key);
+        if (it == cache.end())
+        {
+            return false;
+        }
+    }
+    result = {it->second, it->first};
+    return true;
+}
+} // namespace
 
 namespace octo::logger
 {
 
-ContextInfo::ContextInfo(ContextInfoInitializerList init) : context_info_(std::move(init))
+ContextInfo::ContextInfo() : size_(0), on_heap_(false), fragments_(nullptr)
+{
+}
+
+ContextInfo::~ContextInfo()
+{
+    delete fragments_.load(std::memory_order_acquire);
+}
+
+ContextInfo::ContextInfo(ContextInfo&& other) noexcept
+    : inline_entries_(std::move(other.inline_entries_)),
+      heap_entries_(std::move(other.heap_entries_)),
+      size_(other.size_),
+      on_heap_(other.on_heap_),
+      fragments_(other.fragments_.exchange(nullptr, std::memory_order_acq_rel)),
+      parent_(std::move(other.parent_))
+{
+    other.size_ = 0;
+    other.on_heap_ = false;
+}
+
+ContextInfo& ContextInfo::operator=(ContextInfo&& other) noexcept
+{
+    if (&other != this)
+    {
+        inline_entries_ = std::move(other.inline_entries_);
+        heap_entries_ = std::move(other.heap_entries_);
+        size_ = other.size_;
+        on_heap_ = other.on_heap_;
+        delete fragments_.exchange(other.fragments_.exchange(nullptr, std::memory_order_acq_rel),
+                                   std::memory_order_acq_rel);
+        parent_ = std::move(other.parent_);
+        other.size_ = 0;
+        other.on_heap_ = false;
+    }
+    return *this;
+}
+
+// The copy renders its own fragments when it is first logged
+ContextInfo::ContextInfo(ContextInfo const& other)
+    : inline_entries_(other.inline_entries_),
+      heap_entries_(other.heap_entries_),
+      size_(other.size_),
+      on_heap_(other.on_heap_),
+      fragments_(nullptr),
+      parent_(other.parent_)
+{
+}
+
+ContextInfo& ContextInfo::operator=(ContextInfo const& other)
+{
+    if (&other != this)
+    {
+        inline_entries_ = other.inline_entries_;
+        heap_entries_ = other.heap_entries_;
+        size_ = other.size_;
+        on_heap_ = other.on_heap_;
+        parent_ = other.parent_;
+        invalidate();
+    }
+    return *this;
+}
+
+ContextInfo::ContextInfo(ContextInfoInitializerList init) : ContextInfo()
+{
+    for (auto const& [key, value] : init)
+    {
+        ContextInfoKey interned_key;
+        ContextInfoKeyId const id = intern(key, &interned_key);
+        // Like inserting into a map, the first occurrence of a key wins
+        set(id, interned_key, value, false);
+    }
+}
+
+ContextInfo::ContextInfoKeyId ContextInfo::intern(ContextInfoKey key, ContextInfoKey* interned_key)
+{
+    auto& cache = thread_key_cache();
+    auto const it = cache.find(key);
+    if (it != cache.end())
+    {
+        if (interned_key != nullptr)
+        {
+            *interned_key = it->first;
+        }
+        return it->second;
+    }
+    auto const [id, name] = KeyTable::instance().intern(key);
+    cache.emplace(name, id);
+    if (interned_key != nullptr)
+    {
+        *interned_key = name;
+    }
+    return id;
+}
+
+void ContextInfo::child_on_fork()
+{
+    KeyTable::instance().child_on_fork();
+}
+
+ContextInfo::Entry* ContextInfo::entries()
+{
+    return on_heap_ ? heap_entries_.data() : inline_entries_.data();
+}
+
+ContextInfo::Entry const* ContextInfo::entries() const
+{
+    return on_heap_ ? heap_entries_.data() : inline_entries_.data();
+}
+
+std::size_t ContextInfo::lower_bound(ContextInfoKeyId id) const
+{
+    Entry const* const first = entries();
+    std::size_t pos = 0;
+    while (pos < size_ && first[pos].id < id)
+    {
+        ++pos;
+    }
+    return pos;
+}
+
+ContextInfo::Entry const* ContextInfo::find(ContextInfoKey key) const
+{
+    if (size_ == 0)
+    {
+        return nullptr;
+    }
+    std::pair<ContextInfoKeyId, ContextInfoKey> interned;
+    if (!find_key(key, interned))
+    {
+        return nullptr;
+    }
+    std::size_t const pos = lower_bound(interned.first);
+    return pos < size_ && entries()[pos].id == interned.first ? &entries()[pos] : nullptr;
+}
+
+void ContextInfo::invalidate()
+{
+    delete fragments_.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+void ContextInfo::insert_at(std::size_t pos, ContextInfoKeyId id, ContextInfoKey key, ContextInfoValue value)
+{
+    if (!on_heap_ && size_ == INLINE_CAPACITY)
+    {
+        heap_entries_.reserve(INLINE_CAPACITY * 2);
+        for (auto& entry : inline_entries_)
+        {
+            heap_entries_.push_back(std::move(entry));
+            entry.value = ContextInfoValue();
+        }
+        on_heap_ = true;
+    }
+    if (on_heap_)
+    {
+        heap_entries_.insert(heap_entries_.begin() + static_cast<std::ptrdiff_t>(pos),
+                             Entry{id, key, std::move(value)});
+        size_ = static_cast<std::uint32_t>(heap_entries_.size());
+        return;
+    }
+    for (std::size_t i = size_; i > pos; --i)
+    {
+        inline_entries_[i] = std::move(inline_entries_[i - 1]);
+    }
+    inline_entries_[pos] = Entry{id, key, std::move(value)};
+    ++size_;
+}
+
+void ContextInfo::set(ContextInfoKeyId id, ContextInfoKey key, ContextInfoValue value, bool overwrite)
 {
+    std::size_t const pos = lower_bound(id);
+    if (pos < size_ && entries()[pos].id == id)
+    {
+        if (overwrite)
+        {
+            entries()[pos].value = std::move(value);
+            invalidate();
+        }
+        return;
+    }
+    insert_at(pos, id, key, std::move(value));
+    invalidate();
 }
 
 [[nodiscard]] bool ContextInfo::operator==(ContextInfo const& other) const
 {
-    return context_info_ == other.context_info_;
+    if (size_ != other.size_ || parent_ != other.parent_)
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+        if (entries()[i].id != other.entries()[i].id || entries()[i].value != other.entries()[i].value)
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 void ContextInfo::update(ContextInfoKey key, ContextInfoValue value)
 {
-    context_info_[key] = std::move(value);
+    ContextInfoKey interned_key;
+    ContextInfoKeyId const id = intern(key, &interned_key);
+    set(id, interned_key, std::move(value), true);
 }
 
 void ContextInfo::update(ContextInfo const& other)
 {
-    for (const auto& [key, value] : other.context_info_)
+    if (&other == this)
+    {
+        return;
+    }
+    if (other.parent_)
     {
-        context_info_[key] = value;
+        // The inherited entries are taken too, from a copy since this context may be one of other's parents
+        update(other.flattened());
+        return;
+    }
+    for (auto itr = other.begin(); itr != other.end(); ++itr)
+    {
+        set(itr.entry().id, itr.entry().key, itr.entry().value, true);
     }
 }
 
 void ContextInfo::erase(ContextInfoKey const& key)
 {
-    context_info_.erase(key);
+    Entry const* const entry = find(key);
+    if (entry == nullptr)
+    {
+        return;
+    }
+    auto const pos = static_cast<std::size_t>(entry - entries());
+    invalidate();
+    if (on_heap_)
+    {
+        heap_entries_.erase(heap_entries_.begin() + static_cast<std::ptrdiff_t>(pos));
+        size_ = static_cast<std::uint32_t>(heap_entries_.size());
+        return;
+    }
+    for (std::size_t i = pos + 1; i < size_; ++i)
+    {
+        inline_entries_[i - 1] = std::move(inline_entries_[i]);
+    }
+    --size_;
+    inline_entries_[size_].value = ContextInfoValue();
 }
 
 [[nodiscard]] bool ContextInfo::empty() const
 {
-    return context_info_.empty();
+    return size_ == 0;
+}
+
+[[nodiscard]] std::size_t ContextInfo::size() const
+{
+    return size_;
 }
 
 [[nodiscard]] bool ContextInfo::contains(ContextInfoKey const& key) const
 {
-    return context_info_.find(key) != context_info_.cend();
+    return find(key) != nullptr;
+}
+
+ContextInfo::Entry const* ContextInfo::entry(ContextInfoKeyId id) const
+{
+    std::size_t const pos = lower_bound(id);
+    return pos < size_ && entries()[pos].id == id ? &entries()[pos] : nullptr;
 }
 
 [[nodiscard]] ContextInfo::ContextInfoValue ContextInfo::at(ContextInfoKey const& key) const
 {
-    return context_info_.at(key);
+    Entry const* const entry = find(key);
+    if (entry == nullptr)
+    {
+        throw std::out_of_range("ContextInfo::at");
+    }
+    return entry->value;
 }
 
 void ContextInfo::clear()
 {
-    return context_info_.clear();
+    for (std::size_t i = 0; i < INLINE_CAPACITY; ++i)
+    {
+        inline_entries_[i].value = ContextInfoValue();
+    }
+    heap_entries_.clear();
+    size_ = 0;
+    on_heap_ = false;
+    parent_.reset();
+    invalidate();
+}
+
+ContextInfo::const_iterator ContextInfo::begin() const
+{
+    return const_iterator(entries());
+}
+
+ContextInfo::const_iterator ContextInfo::cbegin() const
+{
+    return begin();
+}
+
+ContextInfo::const_iterator ContextInfo::end() const
+{
+    return const_iterator(entries() + size_);
+}
+
+ContextInfo::const_iterator ContextInfo::cend() const
+{
+    return end();
 }
 
-ContextInfo::ContextInfoType::iterator ContextInfo::begin()
+ContextInfo const* ContextInfo::parent() const
 {
-    return context_info_.begin();
+    return parent_.get();
 }
 
-ContextInfo::ContextInfoType::const_iterator ContextInfo::begin() const
+void ContextInfo::set_parent(std::shared_ptr<ContextInfo const> parent)
 {
-    return context_info_.begin();
+    if (parent && parent->chain_depth() >= MAX_CHAIN_DEPTH)
+    {
+        parent = std::make_shared<ContextInfo const>(parent->flattened());
+    }
+    parent_ = std::move(parent);
 }
 
-ContextInfo::ContextInfoType::const_iterator ContextInfo::cbegin() const
+std::size_t ContextInfo::chain_depth() const
 {
-    return context_info_.cbegin();
+    std::size_t depth = 0;
+    for (ContextInfo const* link = parent_.get(); link != nullptr; link = link->parent_.get())
+    {
+        ++depth;
+    }
+    return depth;
 }
 
-ContextInfo::ContextInfoType::iterator ContextInfo::end()
+bool ContextInfo::chain_empty() const
 {
-    return context_info_.end();
+    for (ContextInfo const* link = this; link != nullptr; link = link->parent_.get())
+    {
+        if (!link->empty())
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
-ContextInfo::ContextInfoType::const_iterator ContextInfo::end() const
+bool ContextInfo::chain_contains(ContextInfoKey const& key) const
 {
-    return context_info_.end();
+    for (ContextInfo const* link = this; link != nullptr; link = link->parent_.get())
+    {
+        if (link->contains(key))
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
-ContextInfo::ContextInfoType::const_iterator ContextInfo::cend() const
+ContextInfo ContextInfo::flattened() const
 {
-    return context_info_.cend();
+    ContextInfo result;
+    merge({this},
+          [&result](Entry const& entry) { result.insert_at(result.size_, entry.id, entry.key, entry.value); });
+    return result;
+}
+
+ContextInfo::Fragments const& ContextInfo::fragments() const
+{
+    Fragments const* cached = fragments_.load(std::memory_order_acquire);
+    if (cached != nullptr)
+    {
+        return *cached;
+    }
+    auto* rendered = new Fragments();
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+    rendered->json_keys.reserve(size_);
+    rendered->json_values.reserve(size_);
+#endif
+    for (Entry const* entry = entries(); entry != entries() + size_; ++entry)
+    {
+        rendered->plaintext += '[';
+        rendered->plaintext += entry->key;
+        rendered->plaintext += ':';
+        entry->value.append_to(rendered->plaintext);
+        rendered->plaintext += ']';
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+        std::string& json_key = rendered->json_keys.emplace_back();
+        rendered->json_valid = JsonWriter::append_string(json_key, entry->key) && rendered->json_valid;
+        std::string& json_value = rendered->json_values.emplace_back();
+        JsonWriter writer(json_value);
+        writer.context_value(entry->value);
+        rendered->json_valid = writer.valid() && rendered->json_valid;
+#endif
+    }
+    if (fragments_.compare_exchange_strong(cached, rendered, std::memory_order_acq_rel, std::memory_order_acquire))
+    {
+        return *rendered;
+    }
+    // Another thread rendered them first
+    delete rendered;
+    return *cached;
 }
 
 } // namespace octo::logger
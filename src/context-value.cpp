@@ -0,0 +1,69 @@
+/**
+ * @file context-value.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/context-value.hpp"
+#include <charconv>
+
+namespace
+{
+template <typename T>
+void append_chars(std::string& out, T value)
+{
+    char buffer[32];
+    auto const result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+} // namespace
+
+namespace octo::logger
+{
+void ContextValue::append_to(std::string& out) const
+{
+    switch (type())
+    {
+        case Type::STRING:
+            out += as_string();
+            break;
+        case Type::INT64:
+            append_chars(out, as_int64());
+            break;
+        case Type::UINT64:
+            append_chars(out, as_uint64());
+            break;
+        case Type::DOUBLE:
+            append_chars(out, as_double());
+            break;
+        case Type::BOOL:
+            out += as_bool() ? "true" : "false";
+            break;
+    }
+}
+
+std::string ContextValue::to_string() const
+{
+    if (type() == Type::STRING)
+    {
+        return as_string();
+    }
+    std::string text;
+    append_to(text);
+    return text;
+}
+
+bool ContextValue::operator==(std::string_view other) const
+{
+    if (type() == Type::STRING)
+    {
+        return as_string() == other;
+    }
+    std::string text;
+    append_to(text);
+    return text == other;
+}
+} // namespace octo::logger
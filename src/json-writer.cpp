@@ -0,0 +1,394 @@
+/**
+ * @file json-writer.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/json-writer.hpp"
+
+#include <nlohmann/json.hpp>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#define OCTO_LOGGER_JSON_SSE2
+#include <immintrin.h>
+#endif
+
+namespace
+{
+char constexpr HEX_DIGITS[] = "0123456789abcdef";
+
+// Returns the position of the first byte at or after pos which can't be copied as is: '"', '\\', a control
+// character or the start of a UTF-8 sequence, or size if there is none
+typedef std::size_t (*FindSpecialFn)(char const* data, std::size_t pos, std::size_t size);
+
+inline bool is_special(char c)
+{
+    auto const byte = static_cast<std::uint8_t>(c);
+    return byte < 0x20 || byte >= 0x80 || byte == '"' || byte == '\\';
+}
+
+std::size_t find_special_scalar(char const* data, std::size_t pos, std::size_t size)
+{
+    while (pos < size && !is_special(data[pos]))
+    {
+        ++pos;
+    }
+    return pos;
+}
+
+#ifdef OCTO_LOGGER_JSON_SSE2
+std::size_t find_special_sse2(char const* data, std::size_t pos, std::size_t size)
+{
+    __m128i const quote = _mm_set1_epi8('"');
+    __m128i const backslash = _mm_set1_epi8('\\');
+    __m128i const space = _mm_set1_epi8(0x20);
+    for (; pos + 16 <= size; pos += 16)
+    {
+        __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + pos));
+        // The compare is signed, so bytes >= 0x80 are negative and are caught along with the control characters
+        __m128i const special = _mm_or_si128(
+            _mm_cmplt_epi8(block, space),
+            _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)));
+        int const mask = _mm_movemask_epi8(special);
+        if (mask != 0)
+        {
+            return pos + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+    }
+    return find_special_scalar(data, pos, size);
+}
+
+__attribute__((target("avx2"))) std::size_t find_special_avx2(char const* data, std::size_t pos, std::size_t size)
+{
+    __m256i const quote = _mm256_set1_epi8('"');
+    __m256i const backslash = _mm256_set1_epi8('\\');
+    __m256i const space = _mm256_set1_epi8(0x20);
+    for (; pos + 32 <= size; pos += 32)
+    {
+        __m256i const block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + pos));
+        __m256i const special = _mm256_or_si256(
+            _mm256_cmpgt_epi8(space, block),
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, quote), _mm256_cmpeq_epi8(block, backslash)));
+        auto const mask = static_cast<unsigned>(_mm256_movemask_epi8(special));
+        if (mask != 0)
+        {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return find_special_sse2(data, pos, size);
+}
+#endif
+
+FindSpecialFn find_special_for(octo::logger::JsonWriter::ScanKernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef OCTO_LOGGER_JSON_SSE2
+        case octo::logger::JsonWriter::ScanKernel::SSE2:
+            return find_special_sse2;
+        case octo::logger::JsonWriter::ScanKernel::AVX2:
+            return find_special_avx2;
+#endif
+        default:
+            return find_special_scalar;
+    }
+}
+
+octo::logger::JsonWriter::ScanKernel detect_scan_kernel()
+{
+#ifdef OCTO_LOGGER_JSON_SSE2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return octo::logger::JsonWriter::ScanKernel::AVX2;
+    }
+    return octo::logger::JsonWriter::ScanKernel::SSE2;
+#else
+    return octo::logger::JsonWriter::ScanKernel::SCALAR;
+#endif
+}
+
+// Resolved on first use rather than during static initialization, sinks may be constructed by other static objects
+octo::logger::JsonWriter::ScanKernel active_kernel()
+{
+    static octo::logger::JsonWriter::ScanKernel const kernel = detect_scan_kernel();
+    return kernel;
+}
+
+FindSpecialFn active_find_special()
+{
+    static FindSpecialFn const find_special = find_special_for(active_kernel());
+    return find_special;
+}
+
+/**
+ * @brief Length of the UTF-8 sequence starting at the position, or 0 if it is not a valid one.
+ * Rejects overlong encodings, surrogates and code points above U+10FFFF, the same as nlohmann::json.
+ */
+std::size_t utf8_sequence_length(std::string_view value, std::size_t pos)
+{
+    auto const byte = [&](std::size_t i) { return static_cast<std::uint8_t>(value[pos + i]); };
+    auto const continuation = [&](std::size_t i) { return pos + i < value.size() && (byte(i) & 0xC0) == 0x80; };
+    std::uint8_t const lead = byte(0);
+    if (lead >= 0xC2 && lead <= 0xDF)
+    {
+        return continuation(1) ? 2 : 0;
+    }
+    if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        if (!continuation(1) || !continuation(2))
+        {
+            return 0;
+        }
+        // E0 needs A0..BF (no overlong), ED needs 80..9F (no surrogates)
+        if ((lead == 0xE0 && byte(1) < 0xA0) || (lead == 0xED && byte(1) > 0x9F))
+        {
+            return 0;
+        }
+        return 3;
+    }
+    if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        if (!continuation(1) || !continuation(2) || !continuation(3))
+        {
+            return 0;
+        }
+        // F0 needs 90..BF (no overlong), F4 needs 80..8F (up to U+10FFFF)
+        if ((lead == 0xF0 && byte(1) < 0x90) || (lead == 0xF4 && byte(1) > 0x8F))
+        {
+            return 0;
+        }
+        return 4;
+    }
+    return 0;
+}
+
+bool append_escaped(std::string& out, std::string_view value, FindSpecialFn find_special)
+{
+    char const* const data = value.data();
+    std::size_t const size = value.size();
+    out.reserve(out.size() + size + 2);
+    out += '"';
+    std::size_t run_begin = 0;
+    std::size_t pos = 0;
+    while ((pos = find_special(data, pos, size)) < size)
+    {
+        auto const c = static_cast<std::uint8_t>(data[pos]);
+        if (c >= 0x80)
+        {
+            std::size_t const length = utf8_sequence_length(value, pos);
+            if (length == 0)
+            {
+                return false;
+            }
+            pos += length;
+            continue;
+        }
+        // Clean runs are copied in bulk
+        out.append(data + run_begin, pos - run_begin);
+        switch (c)
+        {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\b':
+                out += "\\b";
+                break;
+            case '\f':
+                out += "\\f";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                out += "\\u00";
+                out += HEX_DIGITS[c >> 4];
+                out += HEX_DIGITS[c & 0xF];
+                break;
+        }
+        run_begin = ++pos;
+    }
+    out.append(data + run_begin, size - run_begin);
+    out += '"';
+    return true;
+}
+} // namespace
+
+namespace octo::logger
+{
+JsonWriter::JsonWriter(std::string& out, int indent)
+    : out_(out), indent_(indent), depth_(0), first_member_(true), valid_(true)
+{
+}
+
+void JsonWriter::write_indent()
+{
+    out_ += '\n';
+    out_.append(static_cast<std::size_t>(depth_ * indent_), ' ');
+}
+
+void JsonWriter::begin_object()
+{
+    out_ += '{';
+    ++depth_;
+    first_member_ = true;
+}
+
+void JsonWriter::end_object()
+{
+    --depth_;
+    // Empty objects are written as {} in both the compact and the pretty formats
+    if (indent_ >= 0 && !first_member_)
+    {
+        write_indent();
+    }
+    out_ += '}';
+    first_member_ = false;
+}
+
+void JsonWriter::key(std::string_view key)
+{
+    if (!first_member_)
+    {
+        out_ += ',';
+    }
+    if (indent_ >= 0)
+    {
+        write_indent();
+    }
+    valid_ = append_string(out_, key) && valid_;
+    out_ += indent_ >= 0 ? ": " : ":";
+    first_member_ = false;
+}
+
+void JsonWriter::encoded_key(std::string_view encoded)
+{
+    if (!first_member_)
+    {
+        out_ += ',';
+    }
+    if (indent_ >= 0)
+    {
+        write_indent();
+    }
+    out_ += encoded;
+    out_ += indent_ >= 0 ? ": " : ":";
+    first_member_ = false;
+}
+
+void JsonWriter::string_value(std::string_view value)
+{
+    valid_ = append_string(out_, value) && valid_;
+}
+
+void JsonWriter::number_value(std::int64_t value)
+{
+    char buffer[24];
+    out_.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+}
+
+void JsonWriter::number_value(std::uint64_t value)
+{
+    char buffer[24];
+    out_.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+}
+
+void JsonWriter::number_value(double value)
+{
+    append_number(out_, value);
+}
+
+void JsonWriter::bool_value(bool value)
+{
+    out_ += value ? "true" : "false";
+}
+
+void JsonWriter::context_value(ContextValue const& value)
+{
+    switch (value.type())
+    {
+        case ContextValue::Type::STRING:
+            string_value(value.as_string());
+            break;
+        case ContextValue::Type::INT64:
+            number_value(value.as_int64());
+            break;
+        case ContextValue::Type::UINT64:
+            number_value(value.as_uint64());
+            break;
+        case ContextValue::Type::DOUBLE:
+            number_value(value.as_double());
+            break;
+        case ContextValue::Type::BOOL:
+            bool_value(value.as_bool());
+            break;
+    }
+}
+
+void JsonWriter::encoded_value(std::string_view encoded)
+{
+    out_ += encoded;
+}
+
+bool JsonWriter::valid() const
+{
+    return valid_;
+}
+
+JsonWriter::ScanKernel JsonWriter::active_scan_kernel()
+{
+    return active_kernel();
+}
+
+bool JsonWriter::scan_kernel_supported(ScanKernel kernel)
+{
+    return kernel <= active_kernel();
+}
+
+bool JsonWriter::append_string(std::string& out, std::string_view value)
+{
+    return append_escaped(out, value, active_find_special());
+}
+
+bool JsonWriter::append_string(std::string& out, std::string_view value, ScanKernel kernel)
+{
+    return append_escaped(out, value, find_special_for(scan_kernel_supported(kernel) ? kernel : ScanKernel::SCALAR));
+}
+
+void JsonWriter::append_number(std::string& out, double value)
+{
+    if (!std::isfinite(value))
+    {
+        out += "null";
+        return;
+    }
+    // The grisu2 conversion nlohmann::json::dump uses, std::to_chars may pick another shortest form on ties
+    char buffer[64];
+    out.append(buffer, nlohmann::detail::to_chars(buffer, buffer + sizeof(buffer), value));
+}
+
+std::string JsonWriter::encode_string(std::string_view value)
+{
+    std::string encoded;
+    if (!append_string(encoded, value))
+    {
+        encoded.clear();
+    }
+    return encoded;
+}
+} // namespace octo::logger
@@ -0,0 +1,45 @@
+/**
+ * @file line-layout.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/line-layout.hpp"
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+struct LayoutRegistry
+{
+    std::mutex mutex;
+    std::unordered_map<std::string, octo::logger::LineLayoutPtr> layouts;
+};
+
+LayoutRegistry& registry()
+{
+    static LayoutRegistry layout_registry;
+    return layout_registry;
+}
+} // namespace
+
+namespace octo::logger
+{
+void LineLayout::register_layout(std::string const& name, std::shared_ptr<LineLayout const> layout)
+{
+    auto& layout_registry = registry();
+    std::lock_guard<std::mutex> lock(layout_registry.mutex);
+    layout_registry.layouts[name] = std::move(layout);
+}
+
+std::shared_ptr<LineLayout const> LineLayout::find_layout(std::string const& name)
+{
+    auto& layout_registry = registry();
+    std::lock_guard<std::mutex> lock(layout_registry.mutex);
+    auto const it = layout_registry.layouts.find(name);
+    return it != layout_registry.layouts.end() ? it->second : nullptr;
+}
+} // namespace octo::logger
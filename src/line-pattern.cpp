@@ -0,0 +1,169 @@
+/**
+ * @file line-pattern.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/line-pattern.hpp"
+
+namespace octo::logger
+{
+LinePattern::LinePattern(std::string_view pattern) : uses_time_(false)
+{
+    std::size_t pos = 0;
+    while (pos < pattern.size())
+    {
+        std::size_t const flag = pattern.find('%', pos);
+        if (flag == std::string_view::npos || flag + 1 == pattern.size())
+        {
+            add_literal(pattern.substr(pos));
+            break;
+        }
+        add_literal(pattern.substr(pos, flag - pos));
+        pos = flag + 2;
+        switch (pattern[flag + 1])
+        {
+            case 'Y':
+                add_op(OpType::YEAR);
+                break;
+            case 'm':
+                add_op(OpType::MONTH);
+                break;
+            case 'd':
+                add_op(OpType::DAY);
+                break;
+            case 'H':
+                add_op(OpType::HOURS);
+                break;
+            case 'M':
+                add_op(OpType::MINUTES);
+                break;
+            case 'S':
+                add_op(OpType::SECONDS);
+                break;
+            case 'T':
+                add_op(OpType::HOURS);
+                add_literal(":");
+                add_op(OpType::MINUTES);
+                add_literal(":");
+                add_op(OpType::SECONDS);
+                break;
+            case 'z':
+                add_op(OpType::UTC_OFFSET);
+                break;
+            case 'e':
+                add_op(OpType::MILLISECONDS);
+                break;
+            case 'f':
+                add_op(OpType::MICROSECONDS);
+                break;
+            case 'F':
+                add_op(OpType::NANOSECONDS);
+                break;
+            case 'L':
+                add_op(OpType::LEVEL_SHORT);
+                break;
+            case 'l':
+                add_op(OpType::LEVEL);
+                break;
+            case 'n':
+                add_op(OpType::CHANNEL);
+                break;
+            case 'v':
+                add_op(OpType::MESSAGE);
+                break;
+            case 'P':
+                add_op(OpType::PROCESS_ID);
+                break;
+            case 't':
+                add_op(OpType::THREAD_ID);
+                break;
+            case 'N':
+                add_op(OpType::THREAD_NAME);
+                break;
+            case 'i':
+                add_op(OpType::EXTRA_ID);
+                break;
+            case 'I':
+                add_op(OpType::EXTRA_ID_BRACKETED);
+                break;
+            case 'c':
+                add_op(OpType::CONTEXT_INFO);
+                break;
+            case 's':
+                add_op(OpType::SOURCE_FILE);
+                break;
+            case '#':
+                add_op(OpType::SOURCE_LINE);
+                break;
+            case '!':
+                add_op(OpType::SOURCE_FUNCTION);
+                break;
+            case '%':
+                add_literal("%");
+                break;
+            default:
+                // Unknown flags are kept as they are
+                add_literal(pattern.substr(flag, 2));
+                break;
+        }
+    }
+}
+
+void LinePattern::add_literal(std::string_view text)
+{
+    if (text.empty())
+    {
+        return;
+    }
+    // Adjacent literals are merged, so "%T" and "%%" don't cost extra ops
+    if (!ops_.empty() && ops_.back().type == OpType::LITERAL &&
+        ops_.back().offset + ops_.back().size == literals_.size())
+    {
+        ops_.back().size += static_cast<std::uint32_t>(text.size());
+    }
+    else
+    {
+        ops_.push_back(
+            {OpType::LITERAL, static_cast<std::uint32_t>(literals_.size()), static_cast<std::uint32_t>(text.size())});
+    }
+    literals_.append(text);
+}
+
+void LinePattern::add_op(OpType type)
+{
+    ops_.push_back({type, 0, 0});
+    switch (type)
+    {
+        case OpType::YEAR:
+        case OpType::MONTH:
+        case OpType::DAY:
+        case OpType::HOURS:
+        case OpType::MINUTES:
+        case OpType::SECONDS:
+        case OpType::UTC_OFFSET:
+            uses_time_ = true;
+            break;
+        default:
+            break;
+    }
+}
+
+std::vector<LinePattern::Op> const& LinePattern::ops() const
+{
+    return ops_;
+}
+
+std::string_view LinePattern::literal(Op const& op) const
+{
+    return std::string_view(literals_).substr(op.offset, op.size);
+}
+
+bool LinePattern::uses_time() const
+{
+    return uses_time_;
+}
+} // namespace octo::logger
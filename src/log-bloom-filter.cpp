@@ -0,0 +1,170 @@
+/**
+ * @file log-bloom-filter.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/log-bloom-filter.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+char constexpr FILTER_MAGIC[8] = {'O', 'C', 'T', 'O', 'B', 'L', 'M', '1'};
+std::uint64_t constexpr FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+std::uint64_t constexpr FNV_PRIME = 0x100000001b3ULL;
+
+struct FilterHeader
+{
+    char magic[8];
+    std::uint32_t hashes;
+    std::uint32_t reserved;
+    std::uint64_t bits;
+    std::uint64_t items;
+};
+
+std::uint64_t fnv1a(std::uint64_t h, std::string_view data)
+{
+    for (unsigned char const c : data)
+    {
+        h ^= c;
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+std::uint64_t mix(std::uint64_t h)
+{
+    // splitmix64 finalizer, gives the second hash of the double hashing its own bits
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+} // namespace
+
+namespace octo::logger
+{
+LogBloomFilter::LogBloomFilter(std::size_t bits) : words_((bits + 63) / 64), bits_(words_.size() * 64), items_(0)
+{
+}
+
+std::string LogBloomFilter::filter_path(std::string const& segment_path)
+{
+    return segment_path + ".bloom";
+}
+
+std::uint64_t LogBloomFilter::hash(std::string_view key, std::string_view value)
+{
+    std::uint64_t h = fnv1a(FNV_OFFSET_BASIS, key);
+    h = fnv1a(h, std::string_view("\0", 1));
+    return fnv1a(h, value);
+}
+
+void LogBloomFilter::insert(std::string_view key, std::string_view value)
+{
+    if (bits_ == 0)
+    {
+        return;
+    }
+    std::uint64_t const h1 = hash(key, value);
+    std::uint64_t const h2 = mix(h1) | 1;
+    for (std::uint32_t i = 0; i < HASHES; ++i)
+    {
+        std::uint64_t const bit = (h1 + i * h2) % bits_;
+        words_[bit / 64] |= std::uint64_t(1) << (bit % 64);
+    }
+    ++items_;
+}
+
+bool LogBloomFilter::may_contain(std::string_view key, std::string_view value) const
+{
+    if (bits_ == 0)
+    {
+        return true;
+    }
+    std::uint64_t const h1 = hash(key, value);
+    std::uint64_t const h2 = mix(h1) | 1;
+    for (std::uint32_t i = 0; i < HASHES; ++i)
+    {
+        std::uint64_t const bit = (h1 + i * h2) % bits_;
+        if ((words_[bit / 64] & (std::uint64_t(1) << (bit % 64))) == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::uint64_t LogBloomFilter::items() const
+{
+    return items_;
+}
+
+std::uint64_t LogBloomFilter::bits() const
+{
+    return bits_;
+}
+
+void LogBloomFilter::clear()
+{
+    std::fill(words_.begin(), words_.end(), 0);
+    items_ = 0;
+}
+
+bool LogBloomFilter::merge(LogBloomFilter const& other)
+{
+    if (other.bits_ != bits_)
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < words_.size(); ++i)
+    {
+        words_[i] |= other.words_[i];
+    }
+    items_ += other.items_;
+    return true;
+}
+
+bool LogBloomFilter::load(std::string const& path)
+{
+    std::ifstream in(path, std::ifstream::binary);
+    FilterHeader header = {};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, FILTER_MAGIC, sizeof(FILTER_MAGIC)) != 0 || header.hashes != HASHES ||
+        header.bits % 64 != 0)
+    {
+        return false;
+    }
+    std::vector<std::uint64_t> words(header.bits / 64);
+    if (!in.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(words[0]))))
+    {
+        return false;
+    }
+    words_ = std::move(words);
+    bits_ = header.bits;
+    items_ = header.items;
+    return true;
+}
+
+bool LogBloomFilter::save(std::string const& path) const
+{
+    std::ofstream out(path, std::ofstream::binary | std::ofstream::trunc);
+    FilterHeader header = {};
+    std::memcpy(header.magic, FILTER_MAGIC, sizeof(FILTER_MAGIC));
+    header.hashes = HASHES;
+    header.bits = bits_;
+    header.items = items_;
+    out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    out.write(reinterpret_cast<char const*>(words_.data()), static_cast<std::streamsize>(words_.size() * sizeof(words_[0])));
+    out.close();
+    return static_cast<bool>(out);
+}
+} // namespace octo::logger
@@ -0,0 +1,289 @@
+/**
+ * @file log-profiler.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/log-profiler.hpp"
+#include "octo-logger-cpp/fork-safe-mutex.hpp"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+#include <nlohmann/json.hpp>
+#endif
+
+namespace
+{
+using octo::logger::LogSite;
+
+// A cache line of its own, the owning thread is the only one writing it
+struct alignas(64) Counters
+{
+    std::atomic<std::uint64_t> emitted{0};
+    std::atomic<std::uint64_t> filtered{0};
+    std::atomic<std::uint64_t> bytes{0};
+};
+
+// The sink is empty for the record counters
+struct SlotKey
+{
+    LogSite const* site;
+    std::string_view channel;
+    std::string_view sink;
+
+    bool operator==(SlotKey const& other) const
+    {
+        return site == other.site && channel == other.channel && sink == other.sink;
+    }
+};
+
+struct SlotKeyHash
+{
+    std::size_t operator()(SlotKey const& key) const
+    {
+        std::size_t hash = std::hash<LogSite const*>()(key.site);
+        hash = hash * 31 + std::hash<std::string_view>()(key.channel);
+        return hash * 31 + std::hash<std::string_view>()(key.sink);
+    }
+};
+
+struct Slot
+{
+    Counters counters;
+    // The key views point to these, channels and sinks may be destroyed before the report
+    std::string channel;
+    std::string sink;
+};
+
+struct ThreadSlots
+{
+    // Taken by the owning thread to add slots and by the reports, lookups of the owning thread don't take it
+    octo::logger::ForkSafeMutex mutex;
+    std::unordered_map<SlotKey, std::unique_ptr<Slot>, SlotKeyHash> slots;
+
+    Slot& slot(LogSite const* site, std::string_view channel, std::string_view sink)
+    {
+        auto const itr = slots.find({site, channel, sink});
+        if (itr != slots.end())
+        {
+            return *itr->second;
+        }
+        auto added = std::make_unique<Slot>();
+        added->channel = channel;
+        added->sink = sink;
+        SlotKey const key{site, added->channel, added->sink};
+        std::lock_guard<std::mutex> lock(mutex);
+        return *slots.emplace(key, std::move(added)).first->second;
+    }
+};
+
+// Never destroyed, threads may still log while static destructors run
+struct Registry
+{
+    octo::logger::ForkSafeMutex mutex;
+    std::vector<ThreadSlots*> threads;
+    // The counters of the threads which exited
+    ThreadSlots retired;
+
+    static Registry& instance()
+    {
+        static auto* const registry = new Registry();
+        return *registry;
+    }
+};
+
+void add_counters(Counters& counters, std::uint64_t emitted, std::uint64_t filtered, std::uint64_t bytes)
+{
+    // Uncontended, only the reports read the line from other threads
+    if (emitted != 0)
+    {
+        counters.emitted.fetch_add(emitted, std::memory_order_relaxed);
+    }
+    if (filtered != 0)
+    {
+        counters.filtered.fetch_add(filtered, std::memory_order_relaxed);
+    }
+    if (bytes != 0)
+    {
+        counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+// Trivially destructible, so they are still valid while the thread_local destructors run
+thread_local ThreadSlots* thread_slots = nullptr;
+thread_local bool thread_exited = false;
+
+// Merges the slots of the thread into the retired ones when it exits
+struct ThreadRetirer
+{
+    ~ThreadRetirer()
+    {
+        Registry& registry = Registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto const& [key, slot] : thread_slots->slots)
+        {
+            add_counters(registry.retired.slot(key.site, key.channel, key.sink).counters,
+                         slot->counters.emitted.load(std::memory_order_relaxed),
+                         slot->counters.filtered.load(std::memory_order_relaxed),
+                         slot->counters.bytes.load(std::memory_order_relaxed));
+        }
+        registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), thread_slots));
+        delete thread_slots;
+        thread_slots = nullptr;
+        thread_exited = true;
+    }
+};
+
+// Calls fn(key, counters) for every slot of every thread, the registry lock held
+template <typename Fn>
+void for_each_slot(Registry& registry, Fn&& fn)
+{
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto const visit = [&fn](ThreadSlots& thread_slots) {
+        std::lock_guard<std::mutex> slots_lock(thread_slots.mutex);
+        for (auto const& [key, slot] : thread_slots.slots)
+        {
+            fn(key, slot->counters);
+        }
+    };
+    visit(registry.retired);
+    for (ThreadSlots* thread_slots : registry.threads)
+    {
+        visit(*thread_slots);
+    }
+}
+} // namespace
+
+namespace octo::logger
+{
+std::atomic<bool> LogProfiler::enabled_{false};
+
+void LogProfiler::set_enabled(bool enabled)
+{
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void LogProfiler::add(LogSite const* site,
+                      std::string_view channel,
+                      std::string_view sink,
+                      std::uint64_t emitted,
+                      std::uint64_t filtered,
+                      std::uint64_t bytes)
+{
+    if (thread_slots == nullptr)
+    {
+        Registry& registry = Registry::instance();
+        if (thread_exited)
+        {
+            // Logged by a thread_local destructor which ran after the retirer
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            add_counters(registry.retired.slot(site, channel, sink).counters, emitted, filtered, bytes);
+            return;
+        }
+        thread_local ThreadRetirer retirer;
+        thread_slots = new ThreadSlots();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.threads.push_back(thread_slots);
+    }
+    add_counters(thread_slots->slot(site, channel, sink).counters, emitted, filtered, bytes);
+}
+
+std::vector<LogProfiler::Entry> LogProfiler::report(std::size_t top_n)
+{
+    // Keyed by copies of the names, the slots of a thread are freed when it exits
+    std::map<std::pair<LogSite const*, std::string>, Entry> entries;
+    std::map<std::tuple<LogSite const*, std::string, std::string>, std::uint64_t> sink_bytes;
+    for_each_slot(Registry::instance(), [&](SlotKey const& key, Counters const& counters) {
+        Entry& entry = entries[{key.site, std::string(key.channel)}];
+        entry.emitted += counters.emitted.load(std::memory_order_relaxed);
+        entry.filtered += counters.filtered.load(std::memory_order_relaxed);
+        std::uint64_t const bytes = counters.bytes.load(std::memory_order_relaxed);
+        entry.bytes += bytes;
+        if (!key.sink.empty())
+        {
+            sink_bytes[{key.site, std::string(key.channel), std::string(key.sink)}] += bytes;
+        }
+    });
+
+    std::vector<Entry> report;
+    report.reserve(entries.size());
+    for (auto& [key, entry] : entries)
+    {
+        entry.site = key.first;
+        entry.channel = key.second;
+        for (auto itr = sink_bytes.lower_bound({key.first, key.second, std::string()});
+             itr != sink_bytes.end() && std::get<0>(itr->first) == key.first && std::get<1>(itr->first) == key.second;
+             ++itr)
+        {
+            entry.sink_bytes.emplace_back(std::get<2>(itr->first), itr->second);
+        }
+        report.push_back(std::move(entry));
+    }
+    std::stable_sort(report.begin(), report.end(), [](Entry const& lhs, Entry const& rhs) {
+        return std::tie(lhs.bytes, lhs.emitted, lhs.filtered) > std::tie(rhs.bytes, rhs.emitted, rhs.filtered);
+    });
+    if (top_n != 0 && report.size() > top_n)
+    {
+        report.resize(top_n);
+    }
+    return report;
+}
+
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+std::string LogProfiler::report_json(std::size_t top_n)
+{
+    nlohmann::json entries = nlohmann::json::array();
+    for (Entry const& entry : report(top_n))
+    {
+        nlohmann::json j;
+        j["file"] = entry.site != nullptr ? entry.site->file() : std::string_view();
+        j["line"] = entry.site != nullptr ? entry.site->line() : 0;
+        j["function"] = entry.site != nullptr ? entry.site->function() : std::string_view();
+        j["format"] = entry.site != nullptr ? entry.site->format() : std::string_view();
+        j["channel"] = entry.channel;
+        j["emitted"] = entry.emitted;
+        j["filtered"] = entry.filtered;
+        j["bytes"] = entry.bytes;
+        j["sinks"] = nlohmann::json::object();
+        for (auto const& [sink, bytes] : entry.sink_bytes)
+        {
+            j["sinks"][sink] = bytes;
+        }
+        entries.push_back(std::move(j));
+    }
+    nlohmann::json report_json;
+    report_json["entries"] = std::move(entries);
+    // Names and format strings are the caller's, replace rather than throw on invalid UTF-8
+    return report_json.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+#endif
+
+void LogProfiler::reset()
+{
+    for_each_slot(Registry::instance(), [](SlotKey const&, Counters& counters) {
+        counters.emitted.store(0, std::memory_order_relaxed);
+        counters.filtered.store(0, std::memory_order_relaxed);
+        counters.bytes.store(0, std::memory_order_relaxed);
+    });
+}
+
+void LogProfiler::child_on_fork()
+{
+    // Only the forking thread is left, nothing else can hold or take the locks
+    Registry& registry = Registry::instance();
+    registry.mutex.fork_reset();
+    registry.retired.mutex.fork_reset();
+    for (ThreadSlots* thread_slots : registry.threads)
+    {
+        thread_slots->mutex.fork_reset();
+    }
+}
+} // namespace octo::logger
@@ -0,0 +1,423 @@
+/**
+ * @file log-query.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/log-query.hpp"
+
+#include "octo-logger-cpp/log-level.hpp"
+#include "octo-logger-cpp/log-time-index.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#define OCTO_LOGGER_LOG_QUERY_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+constexpr std::string_view JSON_LEVEL_KEY = "\"log_level\":\"";
+constexpr std::string_view JSON_CHANNEL_KEY = "\"origin_service_name\":\"";
+// [dd/mm/YYYY HH:MM:SS.mmm][L][channel]...
+constexpr std::size_t LONG_LEVEL_OFFSET = 26;
+constexpr std::size_t LONG_CHANNEL_OFFSET = 29;
+// [MS(mmm)][L][channel]...
+constexpr std::string_view SHORT_PREFIX = "[MS(";
+constexpr std::size_t SHORT_LEVEL_OFFSET = 10;
+constexpr std::size_t SHORT_CHANNEL_OFFSET = 13;
+
+std::string_view bracketed_at(std::string_view line, std::size_t offset)
+{
+    std::size_t const end = line.find(']', offset);
+    return end == std::string_view::npos ? std::string_view() : line.substr(offset, end - offset);
+}
+
+std::optional<std::string_view> json_string_value(std::string_view line, std::string_view key)
+{
+    std::size_t const key_pos = line.find(key);
+    if (key_pos == std::string_view::npos)
+    {
+        return std::nullopt;
+    }
+    std::size_t const start = key_pos + key.size();
+    std::size_t const end = line.find('"', start);
+    if (end == std::string_view::npos)
+    {
+        return std::nullopt;
+    }
+    return line.substr(start, end - start);
+}
+
+class MappedFile
+{
+  private:
+    char const* data_;
+    std::size_t size_;
+
+  public:
+    explicit MappedFile(std::string const& path) : data_(nullptr), size_(0)
+    {
+        int const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return;
+        }
+        struct stat st = {};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void* const data = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                ::madvise(data, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+                data_ = static_cast<char const*>(data);
+                size_ = static_cast<std::size_t>(st.st_size);
+            }
+        }
+        else if (st.st_size == 0)
+        {
+            // Nothing to map, but the segment exists
+            data_ = "";
+        }
+        ::close(fd);
+    }
+    ~MappedFile()
+    {
+        if (size_ > 0)
+        {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+    }
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    [[nodiscard]] bool is_open() const
+    {
+        return data_ != nullptr;
+    }
+    [[nodiscard]] char const* data() const
+    {
+        return data_;
+    }
+    [[nodiscard]] std::size_t size() const
+    {
+        return size_;
+    }
+};
+} // namespace
+
+namespace octo::logger
+{
+bool LogQuery::set_min_level(std::string const& name)
+{
+    try
+    {
+        auto const minimum = LogLevelUtils::string_to_level(name);
+        std::fill(std::begin(accepted_levels), std::end(accepted_levels), false);
+        for (auto const level :
+             {LogLevel::TRACE, LogLevel::DEBUG, LogLevel::INFO, LogLevel::NOTICE, LogLevel::WARNING, LogLevel::ERROR})
+        {
+            if (level >= minimum)
+            {
+                auto const& short_name = LogLevelUtils::level_to_string_short(level);
+                accepted_levels[static_cast<unsigned char>(short_name.front())] = true;
+            }
+        }
+        filter_level = true;
+        return true;
+    }
+    catch (std::exception const&)
+    {
+        return false;
+    }
+}
+
+char const* LogQuery::find_byte(char const* begin, char const* end, char c)
+{
+#ifdef OCTO_LOGGER_LOG_QUERY_SSE2
+    __m128i const needle = _mm_set1_epi8(c);
+    while (end - begin >= 16)
+    {
+        __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(begin));
+        int const mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+        if (mask != 0)
+        {
+            return begin + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        begin += 16;
+    }
+#endif
+    for (; begin < end; ++begin)
+    {
+        if (*begin == c)
+        {
+            return begin;
+        }
+    }
+    return end;
+}
+
+char const* LogQuery::find_substring(char const* begin, char const* end, std::string_view needle)
+{
+    std::size_t const size = needle.size();
+    if (static_cast<std::size_t>(end - begin) < size)
+    {
+        return end;
+    }
+    if (size <= 1)
+    {
+        return size == 0 ? begin : find_byte(begin, end, needle.front());
+    }
+#ifdef OCTO_LOGGER_LOG_QUERY_SSE2
+    // Only the positions where both the first and the last byte of the needle match are compared in full. A block
+    // covers the 16 starts from begin, which are all at or before last_start, so its last bytes end before end
+    char const* const last_start = end - size;
+    __m128i const first = _mm_set1_epi8(needle.front());
+    __m128i const last = _mm_set1_epi8(needle.back());
+    while (last_start - begin >= 15)
+    {
+        __m128i const block_first = _mm_loadu_si128(reinterpret_cast<__m128i const*>(begin));
+        __m128i const block_last = _mm_loadu_si128(reinterpret_cast<__m128i const*>(begin + size - 1));
+        auto mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last))));
+        while (mask != 0)
+        {
+            unsigned const bit = __builtin_ctz(mask);
+            if (std::memcmp(begin + bit + 1, needle.data() + 1, size - 2) == 0)
+            {
+                return begin + bit;
+            }
+            mask &= mask - 1;
+        }
+        begin += 16;
+    }
+#endif
+    std::size_t const found = std::string_view(begin, static_cast<std::size_t>(end - begin)).find(needle);
+    return found == std::string_view::npos ? end : begin + found;
+}
+
+LogQuery::LineKind LogQuery::classify(std::string_view line)
+{
+    if (line.size() > LONG_CHANNEL_OFFSET && line[0] == '[' && line[3] == '/' && line[6] == '/' && line[24] == ']' &&
+        line[25] == '[' && line[27] == ']' && line[28] == '[')
+    {
+        return LineKind::PLAINTEXT_LONG;
+    }
+    if (line.size() > SHORT_CHANNEL_OFFSET && line.compare(0, SHORT_PREFIX.size(), SHORT_PREFIX) == 0 &&
+        line[8] == ']' && line[9] == '[' && line[11] == ']' && line[12] == '[')
+    {
+        return LineKind::PLAINTEXT_SHORT;
+    }
+    if (!line.empty() && line.front() == '{')
+    {
+        return LineKind::JSON;
+    }
+    return LineKind::CONTINUATION;
+}
+
+char LogQuery::level(std::string_view line, LineKind kind)
+{
+    switch (kind)
+    {
+        case LineKind::PLAINTEXT_LONG:
+            return line[LONG_LEVEL_OFFSET];
+        case LineKind::PLAINTEXT_SHORT:
+            return line[SHORT_LEVEL_OFFSET];
+        case LineKind::JSON:
+        {
+            auto const value = json_string_value(line, JSON_LEVEL_KEY);
+            return value && !value->empty() ? value->front() : 0;
+        }
+        case LineKind::CONTINUATION:
+            return 0;
+    }
+    return 0;
+}
+
+std::string_view LogQuery::channel_name(std::string_view line, LineKind kind)
+{
+    switch (kind)
+    {
+        case LineKind::PLAINTEXT_LONG:
+            return bracketed_at(line, LONG_CHANNEL_OFFSET);
+        case LineKind::PLAINTEXT_SHORT:
+            return bracketed_at(line, SHORT_CHANNEL_OFFSET);
+        case LineKind::JSON:
+            return json_string_value(line, JSON_CHANNEL_KEY).value_or(std::string_view());
+        case LineKind::CONTINUATION:
+            return {};
+    }
+    return {};
+}
+
+bool LogQuery::header_matches(std::string_view line, LineKind kind, LogTimestampParser& parser) const
+{
+    // From the cheapest field to the most expensive one
+    if (kind == LineKind::CONTINUATION)
+    {
+        return false;
+    }
+    if (filter_level && !accepted_levels[static_cast<unsigned char>(level(line, kind))])
+    {
+        return false;
+    }
+    if (!channel.empty() && channel_name(line, kind) != channel)
+    {
+        return false;
+    }
+    if (from || to)
+    {
+        // PLAINTEXT_SHORT has no date, so it never matches a time range
+        auto const timestamp = kind == LineKind::JSON             ? LogTimestampParser::parse_json(line)
+                               : kind == LineKind::PLAINTEXT_LONG ? parser.parse_plaintext(line)
+                                                                  : std::nullopt;
+        if (!timestamp || (from && *timestamp < *from) || (to && *timestamp > *to))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+LogQuery::Result LogQuery::scan_segment(std::string const& path, OutputCallback const& on_output) const
+{
+    MappedFile file(path);
+    if (!file.is_open())
+    {
+        return Result();
+    }
+    std::uint64_t begin = 0;
+    std::uint64_t end = file.size();
+    LogTimeIndex index;
+    if ((from || to) && index.load(path))
+    {
+        begin = std::min<std::uint64_t>(from ? index.start_offset(*from) : 0, end);
+        if (to)
+        {
+            if (auto const end_offset = index.end_offset(*to))
+            {
+                end = std::max(begin, std::min(*end_offset, end));
+            }
+        }
+    }
+    Result result = scan(std::string_view(file.data() + begin, end - begin), on_output);
+    result.opened = true;
+    return result;
+}
+
+LogQuery::Result LogQuery::scan(std::string_view data, OutputCallback const& on_output) const
+{
+    Result result;
+    result.opened = true;
+    char const* position = data.data();
+    char const* const end = data.data() + data.size();
+
+    LogTimestampParser parser(utc);
+    // Lines before the first header belong to a record which started before data
+    bool const unfiltered = !filter_level && channel.empty() && !from && !to;
+    char const* const scan_begin = position;
+    auto const line_at = [end](char const* line_begin) {
+        return std::string_view(line_begin, static_cast<std::size_t>(find_byte(line_begin, end, '\n') - line_begin));
+    };
+    auto const accepted = [&](std::string_view header) {
+        LineKind const kind = classify(header);
+        return kind == LineKind::CONTINUATION ? unfiltered : header_matches(header, kind, parser);
+    };
+    auto const append_record = [&](char const* record_begin, char const* record_end) {
+        ++result.matches;
+        if (!count_only)
+        {
+            result.output.append(record_begin, static_cast<std::size_t>(record_end - record_begin));
+            if (record_end[-1] != '\n')
+            {
+                result.output += '\n';
+            }
+            if (on_output && result.output.size() >= OUTPUT_CHUNK_SIZE)
+            {
+                on_output(std::move(result.output));
+                result.output.clear();
+            }
+        }
+    };
+    auto const flush_output = [&]() {
+        if (on_output && !result.output.empty())
+        {
+            on_output(std::move(result.output));
+            result.output.clear();
+        }
+    };
+
+    if (needle.empty())
+    {
+        // Walk the headers, a record is rejected by its level character before anything else is parsed
+        char const* record_begin = position;
+        bool record_accepted = unfiltered;
+        while (position < end)
+        {
+            char const* const newline = find_byte(position, end, '\n');
+            std::string_view const line(position, static_cast<std::size_t>(newline - position));
+            LineKind const kind = classify(line);
+            if (kind != LineKind::CONTINUATION)
+            {
+                if (record_accepted && position != record_begin)
+                {
+                    append_record(record_begin, position);
+                }
+                record_begin = position;
+                record_accepted = header_matches(line, kind, parser);
+            }
+            position = newline == end ? end : newline + 1;
+        }
+        if (record_accepted && record_begin < end)
+        {
+            append_record(record_begin, end);
+        }
+        flush_output();
+        return result;
+    }
+
+    // Jump from one occurrence of the text to the next, only the records around them are looked at
+    while (position < end)
+    {
+        char const* const hit = find_substring(position, end, needle);
+        if (hit == end)
+        {
+            break;
+        }
+        char const* record_begin = hit;
+        while (record_begin > scan_begin && record_begin[-1] != '\n')
+        {
+            --record_begin;
+        }
+        while (record_begin > scan_begin && classify(line_at(record_begin)) == LineKind::CONTINUATION)
+        {
+            do
+            {
+                --record_begin;
+            } while (record_begin > scan_begin && record_begin[-1] != '\n');
+        }
+        char const* record_end = find_byte(hit, end, '\n');
+        record_end = record_end == end ? end : record_end + 1;
+        while (record_end < end && classify(line_at(record_end)) == LineKind::CONTINUATION)
+        {
+            char const* const newline = find_byte(record_end, end, '\n');
+            record_end = newline == end ? end : newline + 1;
+        }
+        if (accepted(line_at(record_begin)))
+        {
+            append_record(record_begin, record_end);
+        }
+        position = record_end;
+    }
+    flush_output();
+    return result;
+}
+} // namespace octo::logger
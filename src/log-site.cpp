@@ -0,0 +1,169 @@
+/**
+ * @file log-site.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/log-site.hpp"
+#include "octo-logger-cpp/fork-safe-mutex.hpp"
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+using octo::logger::LogSiteState;
+
+struct SiteRule
+{
+    LogSiteState::Match match;
+    std::string pattern;
+    LogSiteState::Mode mode;
+};
+
+// Never destroyed, sites may still log while static destructors run
+struct SiteTable
+{
+    octo::logger::ForkSafeMutex mutex;
+    std::vector<LogSiteState*> sites;
+    // In the order they were set, the last matching rule wins
+    std::vector<SiteRule> rules;
+
+    static SiteTable& instance()
+    {
+        static auto* const table = new SiteTable();
+        return *table;
+    }
+};
+// Glob match, * matches any run of characters and ? any single character
+bool glob_match(std::string_view pattern, std::string_view text)
+{
+    std::size_t p = 0;
+    std::size_t t = 0;
+    // Where to resume after the last *, the text it matches grows by one on each mismatch
+    std::size_t star = std::string_view::npos;
+    std::size_t star_text = 0;
+    while (t < text.size())
+    {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t]))
+        {
+            ++p;
+            ++t;
+        }
+        else if (p < pattern.size() && pattern[p] == '*')
+        {
+            star = p++;
+            star_text = t;
+        }
+        else if (star != std::string_view::npos)
+        {
+            p = star + 1;
+            t = ++star_text;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*')
+    {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+bool rule_matches(SiteRule const& rule, octo::logger::LogSite const& site)
+{
+    switch (rule.match)
+    {
+        case LogSiteState::Match::LOCATION:
+            return glob_match(rule.pattern, std::string(site.file()) + ":" + std::to_string(site.line()));
+        case LogSiteState::Match::FUNCTION:
+            return glob_match(rule.pattern, site.function());
+        case LogSiteState::Match::FORMAT:
+            return glob_match(rule.pattern, site.format());
+    }
+    return false;
+}
+} // namespace
+
+namespace octo::logger
+{
+
+LogSiteState::Mode LogSiteState::register_site()
+{
+    SiteTable& table = SiteTable::instance();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    // Another thread may have registered it first
+    Mode mode = mode_.load(std::memory_order_relaxed);
+    if (mode == Mode::UNREGISTERED)
+    {
+        table.sites.push_back(this);
+        mode = Mode::DEFAULT;
+        for (SiteRule const& rule : table.rules)
+        {
+            if (rule_matches(rule, *site_))
+            {
+                mode = rule.mode;
+            }
+        }
+        mode_.store(mode, std::memory_order_relaxed);
+    }
+    return mode;
+}
+
+std::size_t LogSiteState::set_mode(Match match, std::string_view pattern, Mode mode)
+{
+    if (mode == Mode::UNREGISTERED)
+    {
+        throw std::runtime_error("Invalid log site mode");
+    }
+    SiteTable& table = SiteTable::instance();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    table.rules.push_back({match, std::string(pattern), mode});
+    std::size_t matched = 0;
+    for (LogSiteState* state : table.sites)
+    {
+        if (rule_matches(table.rules.back(), *state->site_))
+        {
+            // Relaxed, a statement running concurrently may still see the previous mode
+            state->mode_.store(mode, std::memory_order_relaxed);
+            ++matched;
+        }
+    }
+    return matched;
+}
+
+void LogSiteState::clear_rules()
+{
+    SiteTable& table = SiteTable::instance();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    table.rules.clear();
+    for (LogSiteState* state : table.sites)
+    {
+        state->mode_.store(Mode::DEFAULT, std::memory_order_relaxed);
+    }
+}
+
+std::vector<LogSite const*> LogSiteState::registered_sites()
+{
+    SiteTable& table = SiteTable::instance();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    std::vector<LogSite const*> sites;
+    sites.reserve(table.sites.size());
+    for (LogSiteState const* state : table.sites)
+    {
+        sites.push_back(&state->site());
+    }
+    return sites;
+}
+
+void LogSiteState::child_on_fork()
+{
+    SiteTable::instance().mutex.fork_reset();
+}
+
+} // namespace octo::logger
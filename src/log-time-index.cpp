@@ -0,0 +1,139 @@
+/**
+ * @file log-time-index.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/log-time-index.hpp"
+
+#include "octo-logger-cpp/log-timestamp-parser.hpp"
+#include <algorithm>
+#include <fstream>
+
+namespace octo::logger
+{
+std::string LogTimeIndex::index_path(std::string const& segment_path)
+{
+    return segment_path + ".idx";
+}
+
+bool LogTimeIndex::load(std::string const& segment_path)
+{
+    entries_.clear();
+    std::ifstream in(index_path(segment_path), std::ifstream::binary);
+    if (!in.is_open())
+    {
+        return false;
+    }
+    Entry entry = {};
+    while (in.read(reinterpret_cast<char*>(&entry), sizeof(entry)))
+    {
+        entries_.push_back(entry);
+    }
+    // The writers' blocks interleave in the file, they are put in file order with the closed entry of a block after its
+    // open one, and only the last entry of every block is kept
+    std::stable_sort(entries_.begin(), entries_.end(), [](Entry const& lhs, Entry const& rhs) {
+        return lhs.offset < rhs.offset;
+    });
+    auto const last = std::unique(entries_.rbegin(), entries_.rend(), [](Entry const& lhs, Entry const& rhs) {
+        return lhs.offset == rhs.offset;
+    });
+    entries_.erase(entries_.begin(), last.base());
+    return true;
+}
+
+std::vector<LogTimeIndex::Entry> const& LogTimeIndex::entries() const
+{
+    return entries_;
+}
+
+std::uint64_t LogTimeIndex::start_offset(std::int64_t from_ms) const
+{
+    // The first block which may have a record at or after from_ms, records of other blocks may come before its end
+    std::uint64_t end = 0;
+    for (Entry const& e : entries_)
+    {
+        if (e.is_open() || e.max_timestamp_ms >= from_ms)
+        {
+            return e.offset;
+        }
+        end = std::max(end, e.end_offset);
+    }
+    return end;
+}
+
+std::optional<std::uint64_t> LogTimeIndex::end_offset(std::int64_t to_ms) const
+{
+    if (entries_.empty())
+    {
+        return std::nullopt;
+    }
+    // Past the end of every block which may have a record at or before to_ms, all the later records are newer
+    std::uint64_t end = entries_.front().offset;
+    for (Entry const& e : entries_)
+    {
+        if (e.is_open())
+        {
+            return std::nullopt;
+        }
+        if (e.min_timestamp_ms <= to_ms)
+        {
+            end = std::max(end, e.end_offset);
+        }
+    }
+    return end;
+}
+
+bool LogTimeIndex::read_range(std::string const& segment_path,
+                              std::int64_t from_ms,
+                              std::int64_t to_ms,
+                              bool utc,
+                              RecordCallback const& on_record)
+{
+    std::ifstream in(segment_path, std::ifstream::binary);
+    if (!in.is_open())
+    {
+        return false;
+    }
+    LogTimeIndex index;
+    std::uint64_t offset = 0;
+    std::optional<std::uint64_t> end;
+    if (index.load(segment_path))
+    {
+        offset = index.start_offset(from_ms);
+        end = index.end_offset(to_ms);
+        in.seekg(static_cast<std::streamoff>(offset));
+    }
+
+    LogTimestampParser parser(utc);
+    std::string record;
+    bool in_range = false;
+    std::string line;
+    while ((!end || offset < *end) && std::getline(in, line))
+    {
+        offset += line.size() + 1;
+        if (auto const timestamp = parser.parse(line))
+        {
+            if (in_range)
+            {
+                on_record(record);
+            }
+            in_range = *timestamp >= from_ms && *timestamp <= to_ms;
+            record.clear();
+        }
+        if (in_range)
+        {
+            record += line;
+            record += '\n';
+        }
+    }
+    if (in_range)
+    {
+        on_record(record);
+    }
+    return true;
+}
+} // namespace octo::logger
@@ -0,0 +1,166 @@
+/**
+ * @file log-timestamp-parser.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/log-timestamp-parser.hpp"
+
+#include "octo-logger-cpp/compat.hpp"
+#include <ctime>
+#include <limits>
+#include <string>
+
+namespace
+{
+constexpr std::string_view JSON_TIMESTAMP_KEY = "\"timestamp\":\"";
+constexpr std::int64_t SECONDS_PER_HOUR = 60 * 60;
+constexpr std::int64_t SECONDS_PER_DAY = 24 * SECONDS_PER_HOUR;
+
+bool parse_digits(std::string_view text, std::size_t pos, std::size_t count, int& value)
+{
+    if (pos + count > text.size())
+    {
+        return false;
+    }
+    value = 0;
+    for (std::size_t i = pos; i < pos + count; ++i)
+    {
+        if (text[i] < '0' || text[i] > '9')
+        {
+            return false;
+        }
+        value = value * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+bool expect(std::string_view text, std::size_t pos, char c)
+{
+    return pos < text.size() && text[pos] == c;
+}
+
+std::int64_t civil_to_seconds(int year, int month, int day, int hour, int minute, int second)
+{
+    return octo::logger::compat::days_from_civil(year, static_cast<unsigned>(month), static_cast<unsigned>(day)) *
+               SECONDS_PER_DAY +
+           hour * SECONDS_PER_HOUR + minute * 60 + second;
+}
+
+// The local time offset at a local civil time, from mktime
+std::int64_t civil_offset_seconds(std::int64_t civil_seconds)
+{
+    std::int64_t const days = civil_seconds / SECONDS_PER_DAY;
+    std::int64_t const second_of_day = civil_seconds - days * SECONDS_PER_DAY;
+    std::tm civil = {};
+    // Rebuild the civil date from the day count through a UTC conversion, which is lock free
+    octo::logger::compat::gmtime_safe(static_cast<std::time_t>(days * SECONDS_PER_DAY), &civil);
+    civil.tm_hour = static_cast<int>(second_of_day / SECONDS_PER_HOUR);
+    civil.tm_min = static_cast<int>(second_of_day / 60 % 60);
+    civil.tm_sec = static_cast<int>(second_of_day % 60);
+    civil.tm_isdst = -1;
+    std::time_t const utc = std::mktime(&civil);
+    return utc == static_cast<std::time_t>(-1) ? 0 : civil_seconds - static_cast<std::int64_t>(utc);
+}
+} // namespace
+
+namespace octo::logger
+{
+LogTimestampParser::LogTimestampParser(bool utc)
+    : utc_(utc), cached_local_hour_(std::numeric_limits<std::int64_t>::min()), cached_local_offset_(0)
+{
+}
+
+std::int64_t LogTimestampParser::local_offset_seconds(std::int64_t civil_seconds)
+{
+    // The offset is resolved once per hour, unless it changes within the hour (e.g. Pacific/Chatham at 02:45)
+    std::int64_t const hour = civil_seconds / SECONDS_PER_HOUR;
+    if (hour == cached_local_hour_)
+    {
+        return cached_local_offset_;
+    }
+    std::int64_t const hour_start = hour * SECONDS_PER_HOUR;
+    std::int64_t const offset = civil_offset_seconds(hour_start);
+    if (civil_offset_seconds(hour_start + SECONDS_PER_HOUR - 1) != offset)
+    {
+        return civil_offset_seconds(civil_seconds);
+    }
+    cached_local_offset_ = offset;
+    cached_local_hour_ = hour;
+    return offset;
+}
+
+std::optional<std::int64_t> LogTimestampParser::parse(std::string_view line)
+{
+    if (!line.empty() && line.front() == '{')
+    {
+        return parse_json(line);
+    }
+    return parse_plaintext(line);
+}
+
+std::optional<std::int64_t> LogTimestampParser::parse_plaintext(std::string_view line)
+{
+    int day, month, year, hour, minute, second, millis;
+    if (!expect(line, 0, '[') || !parse_digits(line, 1, 2, day) || !expect(line, 3, '/') ||
+        !parse_digits(line, 4, 2, month) || !expect(line, 6, '/') || !parse_digits(line, 7, 4, year) ||
+        !expect(line, 11, ' ') || !parse_digits(line, 12, 2, hour) || !expect(line, 14, ':') ||
+        !parse_digits(line, 15, 2, minute) || !expect(line, 17, ':') || !parse_digits(line, 18, 2, second) ||
+        !expect(line, 20, '.') || !parse_digits(line, 21, 3, millis) || !expect(line, 24, ']'))
+    {
+        return std::nullopt;
+    }
+    std::int64_t seconds = civil_to_seconds(year, month, day, hour, minute, second);
+    if (!utc_)
+    {
+        seconds -= local_offset_seconds(seconds);
+    }
+    return seconds * 1000 + millis;
+}
+
+std::optional<std::int64_t> LogTimestampParser::parse_json(std::string_view line)
+{
+    std::size_t const key_pos = line.find(JSON_TIMESTAMP_KEY);
+    if (key_pos == std::string_view::npos)
+    {
+        return std::nullopt;
+    }
+    // YYYY-MM-DDTHH:MM:SS.mmm±HHMM
+    std::string_view const ts = line.substr(key_pos + JSON_TIMESTAMP_KEY.size());
+    int year, month, day, hour, minute, second, millis, offset_hours, offset_minutes;
+    if (!parse_digits(ts, 0, 4, year) || !expect(ts, 4, '-') || !parse_digits(ts, 5, 2, month) ||
+        !expect(ts, 7, '-') || !parse_digits(ts, 8, 2, day) || !expect(ts, 10, 'T') ||
+        !parse_digits(ts, 11, 2, hour) || !expect(ts, 13, ':') || !parse_digits(ts, 14, 2, minute) ||
+        !expect(ts, 16, ':') || !parse_digits(ts, 17, 2, second) || !expect(ts, 19, '.') ||
+        !parse_digits(ts, 20, 3, millis) || !(expect(ts, 23, '+') || expect(ts, 23, '-')) ||
+        !parse_digits(ts, 24, 2, offset_hours) || !parse_digits(ts, 26, 2, offset_minutes))
+    {
+        return std::nullopt;
+    }
+    std::int64_t offset = offset_hours * SECONDS_PER_HOUR + offset_minutes * 60;
+    if (ts[23] == '-')
+    {
+        offset = -offset;
+    }
+    return (civil_to_seconds(year, month, day, hour, minute, second) - offset) * 1000 + millis;
+}
+
+std::optional<std::int64_t> LogTimestampParser::parse_argument(std::string_view argument)
+{
+    if (!argument.empty() && argument.size() <= 18 &&
+        argument.find_first_not_of("0123456789") == std::string_view::npos)
+    {
+        return std::stoll(std::string(argument));
+    }
+    if (argument.find('T') != std::string_view::npos)
+    {
+        return parse_json(std::string(JSON_TIMESTAMP_KEY) + std::string(argument) + "\"");
+    }
+    // Milliseconds are optional
+    std::string const millis = argument.size() + 2 < PLAINTEXT_TIMESTAMP_SIZE ? ".000" : "";
+    return parse_plaintext("[" + std::string(argument) + millis + "]");
+}
+} // namespace octo::logger
@@ -10,7 +10,10 @@
  */
 
 #include "octo-logger-cpp/log.hpp"
+#include "octo-logger-cpp/clock.hpp"
+#include "octo-logger-cpp/log-profiler.hpp"
 #include "octo-logger-cpp/logger.hpp"
+#include "octo-logger-cpp/scoped-context.hpp"
 #include <algorithm>
 
 namespace octo::logger
@@ -19,16 +22,28 @@ namespace octo::logger
 Log::Log(const Log::LogLevel& log_level,
          std::string_view extra_identifier,
          ContextInfo&& context_info,
-         const Logger& logger)
+         const Logger& logger,
+         LogSite const* site,
+         LogSiteState::Mode site_mode)
     : stream_(std::nullopt),
       log_level_(log_level),
       logger_(logger),
       extra_identifier_(extra_identifier),
-      context_info_(std::move(context_info))
+      context_info_(std::move(context_info)),
+      scoped_context_(&ScopedContext::current()),
+      site_(site)
 {
-    if (log_level_ >= logger.logger_channel().log_level() && log_level_ != LogLevel::QUIET)
+    // A site mode set with LogSiteState::set_mode takes precedence over the channel level
+    bool const enabled = LogSiteState::enabled(site_mode, log_level_, logger.logger_channel().log_level());
+    if (LogProfiler::enabled())
+    {
+        LogProfiler::count_record(site_, logger.logger_channel().channel_name(), enabled);
+    }
+    if (enabled)
     {
         stream_.emplace();
+        // Taken when the record is created, so slow operator<< chains don't change the order of the records
+        time_created_ = Clock::record_time();
     }
 }
 
@@ -36,7 +51,6 @@ Log::~Log()
 {
     if (stream_)
     {
-        time_created_ = std::chrono::system_clock::now();
         logger_.dump_log(*this);
         stream_.reset();
     }
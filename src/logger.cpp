@@ -16,14 +16,46 @@ namespace octo::logger
 {
 void Logger::dump_log(const Log& log) const
 {
-    Manager::instance().dump(log, channel_view_.channel(), context_info_);
+    Manager::instance().dump(log, channel_view_.channel(), *context_info_);
 }
 
-Logger::Logger(std::string_view channel)
+Logger::Logger(std::string_view channel) : context_info_(std::make_shared<ContextInfo>())
 {
     channel_view_ = Manager::instance().create_channel(channel);
 }
 
+Logger::Logger(ChannelView channel_view, std::shared_ptr<ContextInfo> context_info)
+    : context_info_(std::move(context_info)), channel_view_(std::move(channel_view))
+{
+}
+
+ContextInfo& Logger::editable_context_info()
+{
+    if (context_info_.use_count() > 1)
+    {
+        context_info_ = std::make_shared<ContextInfo>(*context_info_);
+    }
+    return *context_info_;
+}
+
+Logger Logger::with(ContextInfo context_info) const
+{
+    auto child_context_info = std::make_shared<ContextInfo>(std::move(context_info));
+    // A context without entries of its own adds nothing to the chain
+    if (context_info_->empty())
+    {
+        if (context_info_->parent() != nullptr)
+        {
+            child_context_info->set_parent(std::shared_ptr<ContextInfo const>(context_info_, context_info_->parent()));
+        }
+    }
+    else
+    {
+        child_context_info->set_parent(context_info_);
+    }
+    return Logger(channel_view_, std::move(child_context_info));
+}
+
 const Channel& Logger::logger_channel() const
 {
     return channel_view_.channel();
@@ -86,35 +118,59 @@ Log Logger::log(Log::LogLevel level, std::string_view extra_identifier, ContextI
     throw std::runtime_error("No log level");
 }
 
+Log Logger::log(LogSite const& site,
+                LogSiteState::Mode mode,
+                std::string_view extra_identifier,
+                ContextInfo context_info) const
+{
+    return Log(site.level(),
+               extra_identifier,
+               std::move(context_info),
+               *this,
+               &site,
+               mode);
+}
+
+bool Logger::enabled(LogSite const& site, LogSiteState::Mode mode) const
+{
+    return LogSiteState::enabled(mode, site.level(), logger_channel().log_level());
+}
+
 ContextInfo const& Logger::context_info() const
 {
-    return context_info_;
+    return *context_info_;
 }
 
 void Logger::add_context_key(ContextInfo::ContextInfoKey key, ContextInfo::ContextInfoValue value)
 {
 
-    context_info_.update(key, std::move(value));
+    editable_context_info().update(key, std::move(value));
 }
 
 void Logger::add_context_keys(ContextInfo context_info)
 {
-    context_info_.update(std::move(context_info));
+    editable_context_info().update(std::move(context_info));
 }
 
 void Logger::remove_context_key(ContextInfo::ContextInfoKey key)
 {
-    context_info_.erase(key);
+    ContextInfo& context_info = editable_context_info();
+    // An inherited key can't be hidden, the chain is flattened into this logger's own context first
+    if (context_info.parent() != nullptr && context_info.parent()->chain_contains(key))
+    {
+        context_info = context_info.flattened();
+    }
+    context_info.erase(key);
 }
 
 bool Logger::has_context_key(ContextInfo::ContextInfoKey const& key) const
 {
-    return context_info_.contains(key);
+    return context_info_->chain_contains(key);
 }
 
 void Logger::clear_context_info()
 {
-    context_info_.clear();
+    editable_context_info().clear();
 }
 
 } // namespace octo::logger
@@ -10,16 +10,83 @@
  */
 
 #include "octo-logger-cpp/manager.hpp"
+#include "octo-logger-cpp/persistent-context-map.hpp"
+#include "octo-logger-cpp/sinks/file-sink.hpp"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
 
 namespace octo::logger
 {
+struct Manager::GlobalContext
+{
+    PersistentContextMap const map;
+    // The map flattened for the sinks, built by the first record logged with this version
+    mutable std::atomic<ContextInfo const*> flat;
+
+    explicit GlobalContext(PersistentContextMap context_map, ContextInfo const* flat_context_info = nullptr)
+        : map(std::move(context_map)), flat(flat_context_info)
+    {
+    }
+    GlobalContext(GlobalContext const&) = delete;
+    GlobalContext& operator=(GlobalContext const&) = delete;
+    ~GlobalContext()
+    {
+        delete flat.load(std::memory_order_acquire);
+    }
+
+    // Thread safe, concurrent first calls may both flatten the map, one of the results is kept
+    [[nodiscard]] ContextInfo const& context_info() const
+    {
+        ContextInfo const* cached = flat.load(std::memory_order_acquire);
+        if (cached != nullptr)
+        {
+            return *cached;
+        }
+        auto* flattened = new ContextInfo(map.to_context_info());
+        if (flat.compare_exchange_strong(cached, flattened, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            return *flattened;
+        }
+        delete flattened;
+        return *cached;
+    }
+};
+
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+namespace
+{
+// Written next to the report and renamed over it
+void write_log_profile_file(std::string const& path, std::size_t top_n)
+{
+    std::string const temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::out | std::ios::trunc);
+        file << LogProfiler::report_json(top_n) << '\n';
+        if (!file)
+        {
+            // Nothing to report it to, logging it would be counted by the profiler it failed to write
+            return;
+        }
+    }
+    std::rename(temp_path.c_str(), path.c_str());
+}
+} // namespace
+#endif
+
 std::shared_ptr<Manager> Manager::manager_;
 std::mutex Manager::manager_init_mutex_;
 
 Manager::Manager()
-    : config_(std::make_shared<ManagerConfig>()),
+    : sinks_(std::make_shared<SinkList const>()),
+      config_(std::make_shared<ManagerConfig>()),
       default_log_level_(Log::LogLevel::INFO),
-      global_context_info_(std::make_shared<GlobalContextInfoType>())
+      global_context_(std::make_shared<GlobalContext const>(PersistentContextMap(), new ContextInfo()))
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+      ,
+      log_profile_cond_(std::make_unique<std::condition_variable>()),
+      log_profile_running_(false)
+#endif
 {
 }
 
@@ -45,7 +112,11 @@ void Manager::reset_manager()
 
 Manager::~Manager()
 {
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+    stop_log_profile_file();
+#endif
     terminate();
+    Clock::set_active(nullptr);
 }
 
 ChannelView Manager::create_channel(std::string_view name)
@@ -89,21 +160,32 @@ void Manager::configure(const ManagerConfigPtr& config, bool clear_old_sinks)
             default_log_level_ = static_cast<Log::LogLevel>(default_level);
         }
     }
+    if (config_->has_option(ManagerConfig::LoggerOption::CLOCK))
+    {
+        int clock_type;
+        if (config_->option(ManagerConfig::LoggerOption::CLOCK, clock_type))
+        {
+            set_clock(Clock::create(static_cast<Clock::ClockType>(clock_type)));
+        }
+    }
     {
         std::lock_guard<std::mutex> lock(manager_init_mutex_);
         // Create all the sinks
+        auto sinks = std::make_shared<SinkList>(*this->sinks());
         for (auto& sink_config : config_->sinks())
         {
             SinkPtr sink = SinkFactory::instance().create_sink(sink_config);
             if (sink)
             {
-                sinks_.push_back(std::move(sink));
+                sinks->push_back(std::move(sink));
             }
         }
         for (auto& sink : config_->custom_sinks())
         {
-            sinks_.push_back(sink);
+            sinks->push_back(sink);
         }
+        std::lock_guard<std::mutex> sinks_lock(sinks_mutex_);
+        sinks_ = std::move(sinks);
     }
     for (auto const& channel : channels_)
     {
@@ -120,8 +202,7 @@ void Manager::terminate()
 
 void Manager::stop(bool discard)
 {
-    std::lock_guard<std::mutex> lock(sinks_mutex_);
-    for (auto const& sink : sinks_)
+    for (auto const& sink : *sinks())
     {
         sink->stop(discard);
     }
@@ -136,22 +217,36 @@ void Manager::dump(const Log& log, const Channel& channel, ContextInfo const& co
 {
     // The local copy increments the ref-count and guarantees that the pointed-at context_info will not be deleted
     // while we're working on it, even if the global_context_info_ is replaced with a new context_info pointer
-    GlobalContextInfoTypePtr context_info_handle;
+    std::shared_ptr<GlobalContext const> const context_handle = global_context();
+    ContextInfo const& global_context_info = context_handle->context_info();
+
+    // Sinks cleared or replaced meanwhile stay alive until the record is written to them
+    std::shared_ptr<SinkList const> sinks_handle;
     {
-        std::lock_guard<std::mutex> lock(global_context_info_mutex_);
-        context_info_handle = global_context_info_;
+        std::lock_guard<std::mutex> lock(sinks_mutex_);
+        sinks_handle = sinks_;
+        for (auto const& sink : *sinks_handle)
+        {
+            if (!sink->thread_safe_dump())
+            {
+                sink->dump(log, channel, context_info, global_context_info);
+            }
+        }
     }
-
-    std::lock_guard<std::mutex> lock(sinks_mutex_);
-    for (auto& sink : sinks_)
+    for (auto const& sink : *sinks_handle)
     {
-        sink->dump(log, channel, context_info, *context_info_handle);
+        if (sink->thread_safe_dump())
+        {
+            sink->dump(log, channel, context_info, global_context_info);
+        }
     }
 }
 void Manager::clear_sinks()
 {
+    // The sinks are destroyed after the lock is released, when the last dump using them ends
+    std::shared_ptr<SinkList const> sinks = std::make_shared<SinkList const>();
     std::lock_guard<std::mutex> lock(sinks_mutex_);
-    sinks_.clear();
+    sinks_.swap(sinks);
 }
 
 void Manager::clear_channels()
@@ -182,6 +277,70 @@ void Manager::set_log_level(Log::LogLevel log_level)
     }
 }
 
+std::size_t Manager::set_log_site_mode(LogSiteState::Match match, std::string_view pattern, LogSiteState::Mode mode)
+{
+    return LogSiteState::set_mode(match, pattern, mode);
+}
+
+void Manager::clear_log_site_modes()
+{
+    LogSiteState::clear_rules();
+}
+
+void Manager::set_log_profiling(bool enabled)
+{
+    LogProfiler::set_enabled(enabled);
+}
+
+std::vector<LogProfiler::Entry> Manager::log_profile(std::size_t top_n) const
+{
+    return LogProfiler::report(top_n);
+}
+
+void Manager::reset_log_profile()
+{
+    LogProfiler::reset();
+}
+
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+void Manager::start_log_profile_file(std::string path, std::chrono::milliseconds interval, std::size_t top_n)
+{
+    stop_log_profile_file();
+    LogProfiler::set_enabled(true);
+    log_profile_running_ = true;
+    log_profile_thread_ =
+        std::make_unique<std::thread>(&Manager::log_profile_thread, this, std::move(path), interval, top_n);
+}
+
+void Manager::stop_log_profile_file()
+{
+    if (!log_profile_thread_)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(log_profile_mutex_);
+        log_profile_running_ = false;
+    }
+    log_profile_cond_->notify_all();
+    log_profile_thread_->join();
+    log_profile_thread_.reset();
+}
+
+void Manager::log_profile_thread(std::string const& path, std::chrono::milliseconds interval, std::size_t top_n)
+{
+    std::unique_lock<std::mutex> lock(log_profile_mutex_);
+    bool running = true;
+    while (running)
+    {
+        running = !log_profile_cond_->wait_for(lock, interval, [this]() { return !log_profile_running_; });
+        lock.unlock();
+        write_log_profile_file(path, top_n);
+        lock.lock();
+    }
+}
+#endif
+
 bool Manager::has_channel(std::string const& name) const
 {
     return channels_.find(name) != channels_.cend();
@@ -198,10 +357,24 @@ bool Manager::mute_channel(std::string const& name)
     return true;
 }
 
-Manager::GlobalContextInfoTypePtr Manager::global_context_info() const
+std::shared_ptr<Manager::GlobalContext const> Manager::global_context() const
 {
     std::lock_guard<std::mutex> lock(global_context_info_mutex_);
-    return global_context_info_;
+    return global_context_;
+}
+
+std::shared_ptr<Manager::SinkList const> Manager::sinks() const
+{
+    std::lock_guard<std::mutex> lock(sinks_mutex_);
+    return sinks_;
+}
+
+Manager::GlobalContextInfoTypePtr Manager::global_context_info() const
+{
+    std::shared_ptr<GlobalContext const> context_handle = global_context();
+    // Aliases the version, the flat context info lives as long as it
+    ContextInfo const* const context_info = &context_handle->context_info();
+    return GlobalContextInfoTypePtr(std::move(context_handle), context_info);
 }
 
 void Manager::replace_global_context_info(ContextInfo context_info)
@@ -211,44 +384,102 @@ void Manager::replace_global_context_info(ContextInfo context_info)
 
 void Manager::replace_global_context_info_rvalue(ContextInfo&& context_info)
 {
-    // First allocate the new ContextInfo, and then lock and replace the pointer held in global_context_info_
-    auto new_context_info = std::make_shared<Manager::GlobalContextInfoType>(context_info);
+    // First build the new version, and then lock and replace the pointer held in global_context_
+    PersistentContextMap map(context_info);
+    if (context_info.parent() != nullptr)
+    {
+        // The global context info is flat, e.g. a child logger's context brings along its parents' entries
+        context_info = context_info.flattened();
+    }
+    auto new_context = std::make_shared<GlobalContext const>(std::move(map), new ContextInfo(std::move(context_info)));
     std::lock_guard<std::mutex> lock(global_context_info_mutex_);
-    global_context_info_ = std::move(new_context_info);
+    global_context_ = std::move(new_context);
 }
 
-// Calling this method concurrently from multiple threads could result in loss of context info (one of the calls could
-// be lost)
 void Manager::update_global_context_info(ContextInfo const& new_context_info)
 {
-    // First make a local copy of the current context info (under lock), update it and then replace the global context info
-    GlobalContextInfoTypePtr context_info_handle;
+    // The next version is built outside the lock, sharing all the untouched nodes of the current one, and is only
+    // published if no other update was published in the meantime. Otherwise it is rebuilt on top of the newer version,
+    // so concurrent updates are never lost.
+    std::shared_ptr<GlobalContext const> current = global_context();
+    while (true)
     {
+        PersistentContextMap map = current->map.update(new_context_info);
+        if (map.same_as(current->map))
+        {
+            return;
+        }
+        auto next = std::make_shared<GlobalContext const>(std::move(map));
         std::lock_guard<std::mutex> lock(global_context_info_mutex_);
-        context_info_handle = global_context_info_;
+        if (global_context_ == current)
+        {
+            global_context_ = std::move(next);
+            return;
+        }
+        current = global_context_;
     }
-    auto copy_of_current = *context_info_handle;
-    copy_of_current.update(new_context_info);
-    replace_global_context_info_rvalue(std::move(copy_of_current));
 }
 
 void Manager::restart_sinks() noexcept
 {
-    std::lock_guard<std::mutex> lock(sinks_mutex_);
-    std::for_each(sinks_.cbegin(), sinks_.cend(), [](SinkPtr const& itr) { itr->restart_sink(); });
+    std::shared_ptr<SinkList const> const sinks_handle = sinks();
+    std::for_each(sinks_handle->cbegin(), sinks_handle->cend(), [](SinkPtr const& itr) { itr->restart_sink(); });
+}
+
+void Manager::set_clock(ClockPtr clock)
+{
+    std::lock_guard<std::mutex> lock(manager_init_mutex_);
+    Clock::set_active(clock.get());
+    if (clock)
+    {
+        clocks_.push_back(std::move(clock));
+    }
+}
+
+Clock* Manager::clock() const
+{
+    return Clock::active();
 }
 
 void Manager::child_on_fork() noexcept
 {
     sinks_mutex_.fork_reset();
     global_context_info_mutex_.fork_reset();
-    if (global_context_info_)
+    compat::refresh_process_id();
+    ContextInfo::child_on_fork();
+    LogSiteState::child_on_fork();
+    LogProfiler::child_on_fork();
+#ifndef _WIN32
+    FileSink::refresh_thread_shard_suffix();
+#endif
+    for (auto const& sink : *sinks_)
+    {
+        sink->child_on_fork();
+    }
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+    if (log_profile_thread_)
+    {
+        // The thread only exists in the parent and may have held the mutex or waited on the condition variable while
+        // forking, so none of them can be released safely
+        log_profile_thread_.release();
+        log_profile_cond_.release();
+        log_profile_cond_ = std::make_unique<std::condition_variable>();
+        log_profile_running_ = false;
+    }
+    log_profile_mutex_.fork_reset();
+#endif
+    if (Clock* const active_clock = Clock::active())
+    {
+        active_clock->child_on_fork();
+    }
+    if (global_context_)
     {
         // This is probably unnecessary, since the shared_ptr should only use lock-free atomic operations, but just to
         // be on the safe side...
         // Replace in case there is any internal lock in the shared_ptr which is not fork-safe
         // On fork, there is only one thread, so we can safely replace the pointer without a lock
-        global_context_info_ = std::make_shared<GlobalContextInfoType>(*global_context_info_);
+        global_context_ = std::make_shared<GlobalContext const>(
+            global_context_->map, new ContextInfo(global_context_->map.to_context_info()));
     }
 }
 
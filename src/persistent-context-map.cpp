@@ -0,0 +1,205 @@
+/**
+ * @file persistent-context-map.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/persistent-context-map.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+// Each level of the trie consumes 5 bits of the key id, the lowest first
+constexpr unsigned BITS_PER_LEVEL = 5;
+constexpr std::uint32_t LEVEL_MASK = (1U << BITS_PER_LEVEL) - 1;
+
+unsigned bit_count(std::uint32_t value)
+{
+    value = value - ((value >> 1) & 0x55555555U);
+    value = (value & 0x33333333U) + ((value >> 2) & 0x33333333U);
+    return (((value + (value >> 4)) & 0x0F0F0F0FU) * 0x01010101U) >> 24;
+}
+} // namespace
+
+namespace octo::logger
+{
+
+struct PersistentContextMap::Node
+{
+    struct Slot
+    {
+        // Exactly one of the two is set
+        std::shared_ptr<Entry const> entry;
+        NodePtr child;
+    };
+
+    std::uint32_t bitmap = 0;
+    // One slot per bit set in the bitmap, in bit order
+    std::vector<Slot> slots;
+};
+
+PersistentContextMap::PersistentContextMap() : size_(0)
+{
+}
+
+PersistentContextMap::PersistentContextMap(NodePtr root, std::size_t size) : root_(std::move(root)), size_(size)
+{
+}
+
+PersistentContextMap::PersistentContextMap(ContextInfo const& context_info) : PersistentContextMap()
+{
+    *this = update(context_info);
+}
+
+PersistentContextMap::NodePtr PersistentContextMap::insert(NodePtr const& node,
+                                                           unsigned shift,
+                                                           std::shared_ptr<Entry const> const& entry,
+                                                           bool& added)
+{
+    std::uint32_t const bit = 1U << ((entry->id >> shift) & LEVEL_MASK);
+    std::uint32_t const bitmap = node ? node->bitmap : 0;
+    auto const pos = static_cast<std::ptrdiff_t>(bit_count(bitmap & (bit - 1)));
+    if ((bitmap & bit) == 0)
+    {
+        auto copy = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+        copy->bitmap |= bit;
+        copy->slots.insert(copy->slots.begin() + pos, Node::Slot{entry, nullptr});
+        added = true;
+        return copy;
+    }
+    Node::Slot const& slot = node->slots[static_cast<std::size_t>(pos)];
+    NodePtr child;
+    if (slot.child)
+    {
+        child = insert(slot.child, shift + BITS_PER_LEVEL, entry, added);
+        if (child == slot.child)
+        {
+            return node;
+        }
+    }
+    else if (slot.entry->id == entry->id)
+    {
+        if (slot.entry->value == entry->value)
+        {
+            return node;
+        }
+    }
+    else
+    {
+        // Two ids share the bits so far, both move one level down (ids are unique, so they differ by the last level)
+        bool moved = false;
+        NodePtr const split = insert(nullptr, shift + BITS_PER_LEVEL, slot.entry, moved);
+        child = insert(split, shift + BITS_PER_LEVEL, entry, added);
+    }
+    auto copy = std::make_shared<Node>(*node);
+    Node::Slot& copied_slot = copy->slots[static_cast<std::size_t>(pos)];
+    if (child)
+    {
+        copied_slot.entry.reset();
+        copied_slot.child = std::move(child);
+    }
+    else
+    {
+        copied_slot.entry = entry;
+    }
+    return copy;
+}
+
+void PersistentContextMap::collect(Node const& node, std::vector<Entry const*>& entries)
+{
+    for (auto const& slot : node.slots)
+    {
+        if (slot.child)
+        {
+            collect(*slot.child, entries);
+        }
+        else
+        {
+            entries.push_back(slot.entry.get());
+        }
+    }
+}
+
+PersistentContextMap PersistentContextMap::set(ContextInfo::ContextInfoKey key,
+                                               ContextInfo::ContextInfoValue value) const
+{
+    auto entry = std::make_shared<Entry>();
+    entry->id = ContextInfo::intern(key, &entry->key);
+    entry->value = std::move(value);
+    bool added = false;
+    NodePtr root = insert(root_, 0, entry, added);
+    return PersistentContextMap(std::move(root), added ? size_ + 1 : size_);
+}
+
+PersistentContextMap PersistentContextMap::update(ContextInfo const& context_info) const
+{
+    NodePtr root = root_;
+    std::size_t size = size_;
+    // The chain of context_info is merged, so the entries it inherits are set too
+    ContextInfo::merge({&context_info}, [&root, &size](Entry const& entry) {
+        bool added = false;
+        root = insert(root, 0, std::make_shared<Entry const>(entry), added);
+        size += added ? 1 : 0;
+    });
+    return PersistentContextMap(std::move(root), size);
+}
+
+PersistentContextMap::Entry const* PersistentContextMap::find(ContextInfo::ContextInfoKeyId id) const
+{
+    Node const* node = root_.get();
+    for (unsigned shift = 0; node != nullptr; shift += BITS_PER_LEVEL)
+    {
+        std::uint32_t const bit = 1U << ((id >> shift) & LEVEL_MASK);
+        if ((node->bitmap & bit) == 0)
+        {
+            return nullptr;
+        }
+        Node::Slot const& slot = node->slots[bit_count(node->bitmap & (bit - 1))];
+        if (!slot.child)
+        {
+            return slot.entry->id == id ? slot.entry.get() : nullptr;
+        }
+        node = slot.child.get();
+    }
+    return nullptr;
+}
+
+std::size_t PersistentContextMap::size() const
+{
+    return size_;
+}
+
+bool PersistentContextMap::empty() const
+{
+    return size_ == 0;
+}
+
+bool PersistentContextMap::same_as(PersistentContextMap const& other) const
+{
+    return root_ == other.root_;
+}
+
+ContextInfo PersistentContextMap::to_context_info() const
+{
+    ContextInfo context_info;
+    if (!root_)
+    {
+        return context_info;
+    }
+    std::vector<Entry const*> entries;
+    entries.reserve(size_);
+    collect(*root_, entries);
+    // The trie is ordered by the low bits of the ids, ContextInfo by the ids
+    std::sort(entries.begin(), entries.end(), [](Entry const* lhs, Entry const* rhs) { return lhs->id < rhs->id; });
+    for (Entry const* entry : entries)
+    {
+        context_info.insert_at(context_info.size_, entry->id, entry->key, entry->value);
+    }
+    return context_info;
+}
+
+} // namespace octo::logger
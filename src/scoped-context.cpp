@@ -0,0 +1,62 @@
+/**
+ * @file scoped-context.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/scoped-context.hpp"
+#include <utility>
+
+namespace
+{
+octo::logger::ContextInfo& thread_context()
+{
+    thread_local octo::logger::ContextInfo context;
+    return context;
+}
+} // namespace
+
+namespace octo::logger
+{
+
+ScopedContext::ScopedContext(ContextInfo::ContextInfoInitializerList entries)
+    : ScopedContext(ContextInfo(entries))
+{
+}
+
+ScopedContext::ScopedContext(ContextInfo const& entries)
+{
+    ContextInfo& context = thread_context();
+    for (auto const& [key, value] : entries)
+    {
+        if (context.contains(key))
+        {
+            replaced_.update(key, context.at(key));
+        }
+        else
+        {
+            added_.update(key, ContextInfo::ContextInfoValue());
+        }
+        context.update(key, value);
+    }
+}
+
+ScopedContext::~ScopedContext()
+{
+    ContextInfo& context = thread_context();
+    for (auto const& [key, value] : added_)
+    {
+        context.erase(key);
+    }
+    context.update(replaced_);
+}
+
+ContextInfo const& ScopedContext::current()
+{
+    return thread_context();
+}
+
+} // namespace octo::logger
@@ -12,48 +12,276 @@
 #include "octo-logger-cpp/sink.hpp"
 
 #include "octo-logger-cpp/compat.hpp"
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+#include "octo-logger-cpp/json-writer.hpp"
+#endif
 #include "octo-logger-cpp/log-level.hpp"
+#include "octo-logger-cpp/time-zone.hpp"
 #include <fmt/format.h>
+#include <algorithm>
 #include <iomanip>
-#include <thread>
-#ifndef _WIN32
-#include <unistd.h>
-#else
-#include <windows.h>
-#define getpid GetCurrentProcessId
-#endif
+#include <limits>
 
-namespace octo::logger
+namespace
 {
-std::string Sink::formatted_log_plaintext_long(Log const& log,
-                                               Channel const& channel,
-                                               ContextInfo const& context_info,
-                                               ContextInfo const& global_context_info,
-                                               bool disable_context_info) const
+/**
+ * @brief The calendar time and the formatted parts of the timestamps for one second, records within that second only
+ * patch the sub-second digits.
+ */
+struct TimestampPrefix
 {
-    char dtf[1024];
-    std::stringstream ss;
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(log.time_created().time_since_epoch());
-    std::time_t const time = std::chrono::duration_cast<std::chrono::seconds>(ms).count();
-    auto const fraction = ms.count() % 1000;
+    std::time_t seconds = std::numeric_limits<std::time_t>::min();
     struct tm timeinfo = {};
-    std::strftime(dtf, sizeof(dtf), "[%d/%m/%Y %H:%M:%S", compat::localtime(&time, &timeinfo, safe_localtime_utc_));
-    std::string extra_id;
-    if (!log.extra_identifier().empty())
+    // YYYY-MM-DDTHH:MM:SS
+    char iso_datetime[32] = {};
+    std::size_t iso_datetime_size = 0;
+    // ±HHMM
+    char iso_offset[16] = {};
+    std::size_t iso_offset_size = 0;
+};
+
+TimestampPrefix const& timestamp_prefix(std::time_t seconds, octo::logger::compat::LocaltimeMode mode)
+{
+    // One entry per conversion mode, so sinks with different modes don't evict each other
+    thread_local TimestampPrefix prefixes[3];
+    TimestampPrefix& prefix = prefixes[static_cast<std::size_t>(mode)];
+    if (prefix.seconds != seconds)
+    {
+        struct tm& timeinfo = prefix.timeinfo;
+        timeinfo = {};
+        octo::logger::compat::localtime(&seconds, &timeinfo, mode);
+        prefix.iso_datetime_size = std::strftime(prefix.iso_datetime, sizeof(prefix.iso_datetime), "%FT%T", &timeinfo);
+        prefix.iso_offset_size = std::strftime(prefix.iso_offset, sizeof(prefix.iso_offset), "%z", &timeinfo);
+        prefix.seconds = seconds;
+    }
+    return prefix;
+}
+
+octo::logger::compat::LocaltimeMode localtime_mode(octo::logger::SinkConfig const& config)
+{
+    if (config.option_default(octo::logger::SinkConfig::SinkOption::USE_SAFE_LOCALTIME_UTC, false))
+    {
+        return octo::logger::compat::LocaltimeMode::SAFE_UTC;
+    }
+    if (config.option_default(octo::logger::SinkConfig::SinkOption::USE_SAFE_LOCALTIME, false))
+    {
+        // The zone is loaded here rather than on the first log, which may come after a fork
+        static_cast<void>(octo::logger::TimeZone::local());
+        return octo::logger::compat::LocaltimeMode::SAFE_LOCAL;
+    }
+    return octo::logger::compat::LocaltimeMode::SYSTEM;
+}
+
+void append_padded(std::string& out, std::uint64_t value, int width)
+{
+    char digits[20];
+    int size = 0;
+    do
+    {
+        digits[size++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0 && size < static_cast<int>(sizeof(digits)));
+    for (int i = size; i < width; ++i)
+    {
+        out += '0';
+    }
+    while (size > 0)
+    {
+        out += digits[--size];
+    }
+}
+
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+void append_millis(std::string& out, int millis)
+{
+    out += '.';
+    append_padded(out, static_cast<std::uint64_t>(millis), 3);
+}
+#endif
+
+octo::logger::LineLayoutPtr line_layout(octo::logger::SinkConfig const& config)
+{
+    std::string name;
+    if (!config.option(octo::logger::SinkConfig::SinkOption::LINE_LAYOUT, name))
     {
-        extra_id = "[" + log.extra_identifier() + "]";
+        return nullptr;
     }
+    auto layout = octo::logger::LineLayout::find_layout(name);
+    if (!layout)
+    {
+        throw std::runtime_error(fmt::format("No line layout registered with the name {}", name));
+    }
+    return layout;
+}
 
-    ss << dtf << "." << std::setfill('0') << std::setw(3) << fraction << "]["
-       << LogLevelUtils::level_to_string_short(log.log_level()) << "][" << channel.channel_name() << "][PID("
-       << getpid() << ")][TID(" << std::this_thread::get_id() << ")]" << extra_id << ": " << log.str();
+octo::logger::LinePattern line_pattern(octo::logger::SinkConfig const& config, octo::logger::Sink::LineFormat format)
+{
+    std::string pattern;
+    if (config.option(octo::logger::SinkConfig::SinkOption::LINE_PATTERN, pattern))
+    {
+        return octo::logger::LinePattern(pattern);
+    }
+    return octo::logger::LinePattern(format == octo::logger::Sink::LineFormat::PLAINTEXT_SHORT
+                                         ? octo::logger::LinePattern::PLAINTEXT_SHORT
+                                         : octo::logger::LinePattern::PLAINTEXT_LONG);
+}
+} // namespace
 
-    if (!disable_context_info && !(context_info.empty() && log.context_info().empty() && global_context_info.empty()))
+namespace octo::logger
+{
+void Sink::append_line_pattern(std::string& out,
+                               LinePattern const& pattern,
+                               Log const& log,
+                               Channel const& channel,
+                               ContextInfo const& context_info,
+                               ContextInfo const& global_context_info,
+                               bool disable_context_info) const
+{
+    auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(log.time_created().time_since_epoch()).count();
+    std::int64_t constexpr NS_PER_SECOND = 1000000000;
+    auto const sub_second = static_cast<std::uint64_t>(ns % NS_PER_SECOND);
+    TimestampPrefix const* prefix =
+        pattern.uses_time() ? &timestamp_prefix(static_cast<std::time_t>(ns / NS_PER_SECOND), localtime_mode_) : nullptr;
+    for (auto const& op : pattern.ops())
     {
-        ss << "\n" << formatted_context_info(log, channel, context_info, global_context_info);
+        switch (op.type)
+        {
+            case LinePattern::OpType::LITERAL:
+                out += pattern.literal(op);
+                break;
+            case LinePattern::OpType::YEAR:
+                append_padded(out, static_cast<std::uint64_t>(prefix->timeinfo.tm_year + 1900), 4);
+                break;
+            case LinePattern::OpType::MONTH:
+                append_padded(out, static_cast<std::uint64_t>(prefix->timeinfo.tm_mon + 1), 2);
+                break;
+            case LinePattern::OpType::DAY:
+                append_padded(out, static_cast<std::uint64_t>(prefix->timeinfo.tm_mday), 2);
+                break;
+            case LinePattern::OpType::HOURS:
+                append_padded(out, static_cast<std::uint64_t>(prefix->timeinfo.tm_hour), 2);
+                break;
+            case LinePattern::OpType::MINUTES:
+                append_padded(out, static_cast<std::uint64_t>(prefix->timeinfo.tm_min), 2);
+                break;
+            case LinePattern::OpType::SECONDS:
+                append_padded(out, static_cast<std::uint64_t>(prefix->timeinfo.tm_sec), 2);
+                break;
+            case LinePattern::OpType::UTC_OFFSET:
+                out.append(prefix->iso_offset, prefix->iso_offset_size);
+                break;
+            case LinePattern::OpType::MILLISECONDS:
+                append_padded(out, sub_second / 1000000, 3);
+                break;
+            case LinePattern::OpType::MICROSECONDS:
+                append_padded(out, sub_second / 1000, 6);
+                break;
+            case LinePattern::OpType::NANOSECONDS:
+                append_padded(out, sub_second, 9);
+                break;
+            case LinePattern::OpType::LEVEL_SHORT:
+                out += octo::logger::layout::short_level_name(log.log_level());
+                break;
+            case LinePattern::OpType::LEVEL:
+                out += octo::logger::layout::level_name(log.log_level());
+                break;
+            case LinePattern::OpType::CHANNEL:
+                out += channel.channel_name();
+                break;
+            case LinePattern::OpType::MESSAGE:
+                out += log.str();
+                break;
+            case LinePattern::OpType::PROCESS_ID:
+                out += octo::logger::compat::process_id_string();
+                break;
+            case LinePattern::OpType::THREAD_ID:
+                out += octo::logger::compat::thread_id_string();
+                break;
+            case LinePattern::OpType::THREAD_NAME:
+                out += octo::logger::compat::thread_name();
+                break;
+            case LinePattern::OpType::SOURCE_FILE:
+                if (log.site() != nullptr)
+                {
+                    out += log.site()->file();
+                }
+                break;
+            case LinePattern::OpType::SOURCE_LINE:
+                if (log.site() != nullptr)
+                {
+                    append_padded(out, log.site()->line(), 0);
+                }
+                break;
+            case LinePattern::OpType::SOURCE_FUNCTION:
+                if (log.site() != nullptr)
+                {
+                    out += log.site()->function();
+                }
+                break;
+            case LinePattern::OpType::EXTRA_ID:
+                out += log.extra_identifier();
+                break;
+            case LinePattern::OpType::EXTRA_ID_BRACKETED:
+                if (!log.extra_identifier().empty())
+                {
+                    out += '[';
+                    out += log.extra_identifier();
+                    out += ']';
+                }
+                break;
+            case LinePattern::OpType::CONTEXT_INFO:
+                if (!disable_context_info &&
+                    !(context_info.chain_empty() && log.context_info().empty() && log.scoped_context().empty() &&
+                      global_context_info.empty()))
+                {
+                    out += '\n';
+                    out += formatted_context_info(log, channel, context_info, global_context_info);
+                }
+                break;
+        }
     }
+}
 
-    return ss.str();
+void Sink::append_line_layout(std::string& out,
+                              LineLayout const& layout,
+                              Log const& log,
+                              Channel const& channel,
+                              ContextInfo const& context_info,
+                              ContextInfo const& global_context_info,
+                              bool disable_context_info) const
+{
+    auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(log.time_created().time_since_epoch()).count();
+    std::int64_t constexpr NS_PER_SECOND = 1000000000;
+    std::string formatted_context;
+    if (layout.uses_context_info() && !disable_context_info &&
+        !(context_info.chain_empty() && log.context_info().empty() && log.scoped_context().empty() &&
+          global_context_info.empty()))
+    {
+        formatted_context = formatted_context_info(log, channel, context_info, global_context_info);
+    }
+    LayoutRecord const record{
+        log,
+        channel,
+        layout.uses_time() ? &timestamp_prefix(static_cast<std::time_t>(ns / NS_PER_SECOND), localtime_mode_).timeinfo
+                           : nullptr,
+        static_cast<std::uint32_t>(ns % NS_PER_SECOND),
+        compat::process_id_string(),
+        compat::thread_id_string(),
+        formatted_context,
+    };
+    layout.append(out, record);
+}
+
+std::string Sink::formatted_log_plaintext_long(Log const& log,
+                                               Channel const& channel,
+                                               ContextInfo const& context_info,
+                                               ContextInfo const& global_context_info,
+                                               bool disable_context_info) const
+{
+    static LinePattern const pattern(LinePattern::PLAINTEXT_LONG);
+    std::string line;
+    append_line_pattern(line, pattern, log, channel, context_info, global_context_info, disable_context_info);
+    return line;
 }
 
 #ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
@@ -74,16 +302,15 @@ static void init_context_info_impl(nlohmann::json& dst,
     }
 
     // This determines the precedence of the different contexts - the most local context_info has the highest precedence
-    for (auto const& ci_itr : {log.context_info(), context_info, global_context_info})
-    {
-        for (auto const& [key, value] : ci_itr)
-        {
-            if (!dst.contains(key))
-            {
-                dst[key.data()] = value;
-            }
-        }
-    }
+    // Keys already in dst win, the merge itself yields every key once
+    bool const had_keys = !dst.empty();
+    ContextInfo::merge({&log.context_info(), &log.scoped_context(), &context_info, &global_context_info},
+                       [&dst, had_keys](ContextInfo::Entry const& entry) {
+                           if (!had_keys || !dst.contains(entry.key))
+                           {
+                               dst[entry.key.data()] = entry.value;
+                           }
+                       });
 
     if (!log.extra_identifier().empty())
     {
@@ -101,58 +328,199 @@ static nlohmann::json init_context_info_impl(Log const& log,
     return std::move(j);
 }
 
+struct JsonContextEntry
+{
+    std::string_view key;
+    // The context value, or text for the overrides (thread_id, session_id)
+    ContextValue const* value;
+    std::string_view text;
+    // The key and value rendered by the context (ContextInfo::fragments), empty if it is written as it goes
+    std::string_view encoded_key;
+    std::string_view encoded_value;
+};
+
+std::string Sink::formatted_json_timestamp(Log const& log) const
+{
+    std::time_t const log_time_t = std::chrono::system_clock::to_time_t(log.time_created());
+    auto const ms = std::chrono::duration_cast<std::chrono::milliseconds>(log.time_created().time_since_epoch()) % 1000;
+    TimestampPrefix const& prefix = timestamp_prefix(log_time_t, localtime_mode_);
+    // ISO 8601: YYYY-MM-DDTHH:MM:SS.mmm±HHMM
+    std::string timestamp;
+    timestamp.reserve(prefix.iso_datetime_size + 4 + prefix.iso_offset_size);
+    timestamp.append(prefix.iso_datetime, prefix.iso_datetime_size);
+    append_millis(timestamp, static_cast<int>(ms.count()));
+    timestamp.append(prefix.iso_offset, prefix.iso_offset_size);
+    return timestamp;
+}
+
+void Sink::set_json_source_location(nlohmann::json& j, Log const& log)
+{
+    LogSite const* const site = log.site();
+    if (site == nullptr)
+    {
+        j["origin_func_name"] = "";
+        return;
+    }
+    j["origin_file"] = site->file();
+    j["origin_func_name"] = site->function();
+    j["origin_line"] = site->line();
+}
+
 nlohmann::json Sink::construct_log_json(Log const& log,
                                         Channel const& channel,
                                         ContextInfo const& context_info,
                                         ContextInfo const& global_context_info) const
 {
     nlohmann::json j;
-    std::stringstream ss;
-    std::time_t const log_time_t = std::chrono::system_clock::to_time_t(log.time_created());
-    struct tm timeinfo = {};
-    auto const ms = std::chrono::duration_cast<std::chrono::milliseconds>(log.time_created().time_since_epoch()) % 1000;
-    compat::localtime(&log_time_t, &timeinfo, safe_localtime_utc_);
-    // Put datetime with milliseconds: YYYY-MM-DDTHH:MM:SS.mmm
-    ss << std::put_time(&timeinfo, "%FT%T");
-    ss << "." << std::setfill('0') << std::setw(3) << ms.count();
-    // Put timezone as offset from UTC: ±HHMM
-    ss << std::put_time(&timeinfo, "%z");
-
     j["message"] = log.str();
     j["origin"] = origin_;
     j["origin_service_name"] = channel.channel_name();
-    j["timestamp"] = ss.str(); // ISO 8601
+    j["timestamp"] = formatted_json_timestamp(log);
     j["log_level"] = LogLevelUtils::level_to_string_upper(log.log_level());
-    j["origin_func_name"] = "";
+    set_json_source_location(j, log);
 
     j["context_info"] = init_context_info_impl(log, channel, context_info, global_context_info);
 
     return j;
 }
 
+bool Sink::write_log_json(std::string& out,
+                          Log const& log,
+                          Channel const& channel,
+                          ContextInfo const& context_info,
+                          ContextInfo const& global_context_info,
+                          int indent,
+                          std::string_view host_json,
+                          std::string_view service_json,
+                          std::string_view thread_id) const
+{
+    if (origin_json_.empty())
+    {
+        return false;
+    }
+    // Same precedence as init_context_info_impl: the overrides come first and the first occurrence of a key wins
+    thread_local std::vector<JsonContextEntry> entries;
+    entries.clear();
+    if (!thread_id.empty())
+    {
+        entries.push_back({"thread_id", nullptr, thread_id, {}, {}});
+    }
+    if (!log.extra_identifier().empty())
+    {
+        entries.push_back({"session_id", nullptr, log.extra_identifier(), {}, {}});
+    }
+    // The logger (with its parents) and global contexts are spliced from their cached fragments, the record's own and
+    // the scoped context are encoded here
+    ContextInfo const* const log_context_info = &log.context_info();
+    ContextInfo const* const scoped_context = &log.scoped_context();
+    ContextInfo::merge(
+        {log_context_info, scoped_context, &context_info, &global_context_info},
+        [&](ContextInfo::Entry const& entry, ContextInfo const& source, std::size_t index) {
+            ContextInfo::Fragments const* fragments = nullptr;
+            if (&source != log_context_info && &source != scoped_context && source.fragments().json_valid)
+            {
+                fragments = &source.fragments();
+            }
+            if (fragments != nullptr)
+            {
+                entries.push_back(
+                    {entry.key, &entry.value, {}, fragments->json_keys[index], fragments->json_values[index]});
+            }
+            else
+            {
+                entries.push_back({entry.key, &entry.value, {}, {}, {}});
+            }
+        });
+    // nlohmann::json objects are ordered by key, the stable sort keeps the overrides ahead of the context keys
+    std::stable_sort(entries.begin(), entries.end(), [](JsonContextEntry const& lhs, JsonContextEntry const& rhs) {
+        return lhs.key < rhs.key;
+    });
+
+    JsonWriter writer(out, indent);
+    writer.begin_object();
+    writer.key("context_info");
+    writer.begin_object();
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        if (i > 0 && entries[i].key == entries[i - 1].key)
+        {
+            continue;
+        }
+        if (!entries[i].encoded_key.empty())
+        {
+            writer.encoded_key(entries[i].encoded_key);
+            writer.encoded_value(entries[i].encoded_value);
+            continue;
+        }
+        writer.key(entries[i].key);
+        if (entries[i].value != nullptr)
+        {
+            writer.context_value(*entries[i].value);
+        }
+        else
+        {
+            writer.string_value(entries[i].text);
+        }
+    }
+    writer.end_object();
+    if (!host_json.empty())
+    {
+        writer.key("host");
+        writer.encoded_value(host_json);
+    }
+    writer.key("log_level");
+    writer.string_value(LogLevelUtils::level_to_string_upper(log.log_level()));
+    writer.key("message");
+    writer.string_value(log.str());
+    writer.key("origin");
+    writer.encoded_value(origin_json_);
+    LogSite const* const site = log.site();
+    if (site != nullptr)
+    {
+        writer.key("origin_file");
+        writer.string_value(site->file());
+    }
+    writer.key("origin_func_name");
+    writer.string_value(site != nullptr ? site->function() : std::string_view());
+    if (site != nullptr)
+    {
+        writer.key("origin_line");
+        writer.number_value(static_cast<std::uint64_t>(site->line()));
+    }
+    writer.key("origin_service_name");
+    writer.string_value(channel.channel_name());
+    if (!service_json.empty())
+    {
+        writer.key("service");
+        writer.encoded_value(service_json);
+    }
+    writer.key("timestamp");
+    writer.string_value(formatted_json_timestamp(log));
+    writer.end_object();
+    return writer.valid();
+}
+
 std::string Sink::formatted_log_json(Log const& log,
                                      Channel const& channel,
                                      ContextInfo const& context_info,
                                      ContextInfo const& global_context_info) const
 {
+    std::string out;
+    if (write_log_json(out, log, channel, context_info, global_context_info, -1))
+    {
+        return out;
+    }
     return construct_log_json(log, channel, context_info, global_context_info).dump();
 }
 #endif
 
 std::string Sink::formatted_log_plaintext_short(Log const& log, Channel const& channel) const
 {
-    std::stringstream ss;
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(log.time_created().time_since_epoch());
-    auto fraction = ms.count() % 1000;
-    std::string extra_id = "";
-    if (!log.extra_identifier().empty())
-    {
-        extra_id = "[" + log.extra_identifier() + "]";
-    }
-    ss << "[MS(" << std::setfill('0') << std::setw(3) << fraction << ")]["
-       << LogLevelUtils::level_to_string_short(log.log_level()) << "][" << channel.channel_name() << "][TID("
-       << std::this_thread::get_id() << ")]" << extra_id << ": " << log.str();
-    return ss.str();
+    static LinePattern const pattern(LinePattern::PLAINTEXT_SHORT);
+    ContextInfo const no_context_info;
+    std::string line;
+    append_line_pattern(line, pattern, log, channel, no_context_info, no_context_info, true);
+    return line;
 }
 
 std::string Sink::formatted_context_info(Log const& log,
@@ -162,11 +530,26 @@ std::string Sink::formatted_context_info(Log const& log,
 {
     std::string context_info_str("context_info: ");
     // Note that if the same key is present in multiple context_infos, it will be logged multiple times
-    for (auto const& ci_itr : {log.context_info(), context_info, global_context_info})
+    for (auto const* ci_itr : {&log.context_info(), &log.scoped_context()})
     {
-        for (auto const& [key, value] : ci_itr)
+        for (auto const& [key, value] : *ci_itr)
         {
-            context_info_str += fmt::format(FMT_STRING("[{:s}:{:s}]"), key.data(), value);
+            context_info_str += '[';
+            context_info_str += key;
+            context_info_str += ':';
+            value.append_to(context_info_str);
+            context_info_str += ']';
+        }
+    }
+    // The logger (with its parents) and global contexts change rarely, their rendering is cached until they do
+    for (auto const* ci_itr : {&context_info, &global_context_info})
+    {
+        for (ContextInfo const* link = ci_itr; link != nullptr; link = link->parent())
+        {
+            if (!link->empty())
+            {
+                context_info_str += link->fragments().plaintext;
+            }
         }
     }
     return std::move(context_info_str);
@@ -178,12 +561,35 @@ std::string Sink::formatted_log(Log const& log,
                                 ContextInfo const& global_context_info,
                                 bool disable_context_info) const
 {
+    std::string line = formatted_line(log, channel, context_info, global_context_info, disable_context_info);
+    count_formatted_bytes(log, channel, line.size());
+    return line;
+}
+
+std::string Sink::formatted_line(Log const& log,
+                                 Channel const& channel,
+                                 ContextInfo const& context_info,
+                                 ContextInfo const& global_context_info,
+                                 bool disable_context_info) const
+{
+    if (line_layout_)
+    {
+        std::string line;
+        append_line_layout(
+            line, *line_layout_, log, channel, context_info, global_context_info, disable_context_info);
+        return line;
+    }
     switch (line_format_)
     {
         case LineFormat::PLAINTEXT_LONG:
-            return formatted_log_plaintext_long(log, channel, context_info, global_context_info, disable_context_info);
         case LineFormat::PLAINTEXT_SHORT:
-            return formatted_log_plaintext_short(log, channel);
+        {
+            // The predefined layout of the format, or LINE_PATTERN
+            std::string line;
+            append_line_pattern(
+                line, line_pattern_, log, channel, context_info, global_context_info, disable_context_info);
+            return line;
+        }
 #ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
         case LineFormat::JSON:
         {
@@ -235,8 +641,17 @@ void Sink::stop(bool discard)
 }
 
 Sink::Sink(const SinkConfig& config, std::string const& origin, LineFormat format)
-    : config_(config), is_discarding_(false), origin_(origin), line_format_(format), 
-    safe_localtime_utc_(config.option_default(SinkConfig::SinkOption::USE_SAFE_LOCALTIME_UTC, false))
+    : config_(config),
+      is_discarding_(false),
+      origin_(origin),
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+      origin_json_(JsonWriter::encode_string(origin)),
+#endif
+      line_format_(format),
+      line_pattern_(line_pattern(config, format)),
+      line_layout_(line_layout(config)),
+      safe_localtime_utc_(config.option_default(SinkConfig::SinkOption::USE_SAFE_LOCALTIME_UTC, false)),
+      localtime_mode_(localtime_mode(config))
 {
 }
 } // namespace octo::logger
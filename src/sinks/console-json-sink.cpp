@@ -10,6 +10,8 @@
 
 #include "octo-logger-cpp/sinks/console-json-sink.hpp"
 
+#include "octo-logger-cpp/compat.hpp"
+#include "octo-logger-cpp/json-writer.hpp"
 #include <nlohmann/json.hpp>
 
 namespace octo::logger
@@ -20,6 +22,8 @@ ConsoleJSONSink::ConsoleJSONSink(SinkConfig const& sink_config)
            LineFormat::JSON),
       host_(sink_config.option_default(SinkConfig::SinkOption::CONSOLE_JSON_HOST, DEFAULT_HOST)),
       service_(sink_config.option_default(SinkConfig::SinkOption::CONSOLE_JSON_SERVICE, DEFAULT_SERVICE)),
+      host_json_(JsonWriter::encode_string(host_)),
+      service_json_(JsonWriter::encode_string(service_)),
       indent_(sink_config.option_default(SinkConfig::SinkOption::CONSOLE_JSON_INDENT, DEFAULT_INDENT)),
       log_thread_id_(sink_config.option_default<bool>(SinkConfig::SinkOption::LOG_THREAD_ID, false))
 {
@@ -32,6 +36,18 @@ void ConsoleJSONSink::dump(Log const& log,
 {
     if (log.has_stream())
     {
+        std::string_view const thread_id = log_thread_id_ ? compat::thread_id_string() : std::string_view();
+        // The line is streamed into a per thread buffer, the DOM is only built to report invalid UTF-8
+        thread_local std::string line;
+        line.clear();
+        if (!host_json_.empty() && !service_json_.empty() &&
+            write_log_json(
+                line, log, channel, context_info, global_context_info, indent_, host_json_, service_json_, thread_id))
+        {
+            count_formatted_bytes(log, channel, line.size());
+            std::cout << line << std::endl;
+            return;
+        }
         try
         {
             nlohmann::json log_json(construct_log_json(log, channel, context_info, global_context_info));
@@ -39,19 +55,21 @@ void ConsoleJSONSink::dump(Log const& log,
             log_json["service"] = service_;
             if (log_thread_id_)
             {
-                std::ostringstream oss;
-                oss << std::this_thread::get_id();
-                log_json["context_info"]["thread_id"] = oss.str();
+                log_json["context_info"]["thread_id"] = std::string(thread_id);
             }
 
-            std::cout << log_json.dump(indent_) << std::endl;
+            std::string const dumped = log_json.dump(indent_);
+            count_formatted_bytes(log, channel, dumped.size());
+            std::cout << dumped << std::endl;
         }
         catch (nlohmann::json::exception const& ex)
         {
             // Fallback to default upon exception
             std::cerr << "Failed to dump log to console in JSON format: " << ex.what() << std::endl;
-            std::cout << formatted_log_plaintext_long(log, channel, context_info, global_context_info, false)
-                      << std::endl;
+            std::string const fallback =
+                formatted_log_plaintext_long(log, channel, context_info, global_context_info, false);
+            count_formatted_bytes(log, channel, fallback.size());
+            std::cout << fallback << std::endl;
         }
     }
 }
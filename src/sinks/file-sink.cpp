@@ -14,23 +14,129 @@
 #include "octo-logger-cpp/sinks/file-sink.hpp"
 
 #include "octo-logger-cpp/compat.hpp"
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <ctime>
-#include <ctime>
+#include <cerrno>
 #include <dirent.h>
+#include <fcntl.h>
 #include <libgen.h>
+#include <sstream>
+#include <sys/file.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 namespace
 {
 std::size_t constexpr TIME_FORMAT_SIZE = 1024;
+
+void preallocate_file(std::string const& path, long size)
+{
+#ifdef __linux__
+    // Reserves the blocks without changing the file size, so the size based rotation is unaffected
+    int const fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0666);
+    if (fd < 0)
+    {
+        return;
+    }
+    ::fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, size);
+    ::close(fd);
+#else
+    static_cast<void>(path);
+    static_cast<void>(size);
+#endif
+}
+
+void sync_file(std::string const& path)
+{
+    // The stream does not expose its descriptor, syncing any descriptor of the file flushes its data
+    int const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return;
+    }
+    ::fsync(fd);
+    ::close(fd);
+}
+
+void save_bloom_filter(std::string const& segment_path, octo::logger::LogBloomFilter& filter)
+{
+    // Processes sharing the segment (FILE_ATOMIC_APPEND) each add their own items to the file
+    std::string const path = octo::logger::LogBloomFilter::filter_path(segment_path);
+    int const lock_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    if (lock_fd < 0)
+    {
+        return;
+    }
+    while (::flock(lock_fd, LOCK_EX) != 0 && errno == EINTR)
+    {
+    }
+    octo::logger::LogBloomFilter existing(0);
+    if (existing.load(path))
+    {
+        filter.merge(existing);
+    }
+    filter.save(path);
+    ::flock(lock_fd, LOCK_UN);
+    ::close(lock_fd);
 }
 
+// The segment shared by the processes (FILE_ATOMIC_APPEND) is kept in the lock file as "<index> <file name>"
+bool read_shared_segment(int lock_fd, std::uint32_t& index, std::string& name)
+{
+    char buffer[TIME_FORMAT_SIZE] = {};
+    ssize_t const size = ::pread(lock_fd, buffer, sizeof(buffer) - 1, 0);
+    if (size <= 0)
+    {
+        return false;
+    }
+    std::string_view const content(buffer, static_cast<std::size_t>(size));
+    std::size_t const separator = content.find(' ');
+    if (separator == 0 || separator == std::string_view::npos || separator + 1 == content.size() ||
+        content.substr(0, separator).find_first_not_of("0123456789") != std::string_view::npos)
+    {
+        return false;
+    }
+    index = static_cast<std::uint32_t>(std::stoul(std::string(content.substr(0, separator))));
+    name = content.substr(separator + 1);
+    return true;
+}
+
+void write_shared_segment(int lock_fd, std::uint32_t index, std::string const& name)
+{
+    std::string const content = std::to_string(index) + " " + name;
+    if (::ftruncate(lock_fd, 0) == 0)
+    {
+        while (::pwrite(lock_fd, content.data(), content.size(), 0) < 0 && errno == EINTR)
+        {
+        }
+    }
+}
+} // namespace
+
 namespace octo::logger
 {
-FileSink::File::File() : index(0)
+FileSink::File::File()
+    : fd(-1),
+      index(0),
+      in_lru(false),
+      next_pid(0),
+      next_requested(false),
+      index_offset(0),
+      index_records(0),
+      index_bytes(0),
+      index_block_offset(0),
+      index_min_timestamp(0),
+      index_max_timestamp(0),
+      index_started(false),
+      index_fd(-1)
+{
+}
+
+bool FileSink::File::is_open() const
 {
+    return fd >= 0 || stream.is_open();
 }
 
 void FileSink::create_log_path()
@@ -49,7 +155,7 @@ void FileSink::create_log_path()
         char dtf[TIME_FORMAT_SIZE];
         std::time_t const time_v = std::time(nullptr);
         struct tm timeinfo = {};
-        std::strftime(dtf, sizeof(dtf), "%d-%m-%Y", compat::localtime(&time_v, &timeinfo, safe_localtime_utc_));
+        std::strftime(dtf, sizeof(dtf), "%d-%m-%Y", compat::localtime(&time_v, &timeinfo, localtime_mode_));
         log_path_ += std::string(dtf);
     }
 }
@@ -75,9 +181,8 @@ int FileSink::recursive_folder_creation(const char* dir, mode_t mode)
     return mkdir(dir, mode);
 }
 
-void FileSink::switch_stream(const std::string& channel)
+std::string FileSink::file_base_name(const std::string& channel) const
 {
-    std::shared_ptr<File> file;
     std::stringstream ss;
     if (separate_channels_to_files_)
     {
@@ -92,24 +197,88 @@ void FileSink::switch_stream(const std::string& channel)
         char dtf[TIME_FORMAT_SIZE] = {};
         std::time_t const time_v = std::time(nullptr);
         struct tm timeinfo = {};
-        std::strftime(dtf, sizeof(dtf), strftime_format_.c_str(), compat::localtime(&time_v, &timeinfo, safe_localtime_utc_));
+        std::strftime(dtf, sizeof(dtf), strftime_format_.c_str(), compat::localtime(&time_v, &timeinfo, localtime_mode_));
         ss << "_" << dtf;
     }
+    if (shard_per_thread_)
+    {
+        ss << thread_shard_suffix();
+    }
+    return ss.str();
+}
+
+std::string FileSink::file_group_name(const std::string& channel) const
+{
+    std::string name = separate_channels_to_files_ ? channel : combined_channels_prefix_;
+    if (shard_per_thread_)
+    {
+        name += thread_shard_suffix();
+    }
+    return name;
+}
+
+std::string& FileSink::thread_shard_suffix()
+{
+    thread_local std::string suffix = ".t" + std::to_string(compat::current_thread_id());
+    return suffix;
+}
+
+void FileSink::refresh_thread_shard_suffix()
+{
+    // The forking thread is the one calling, it has a new id in the child and must not write to the parent's shards
+    thread_shard_suffix() = ".t" + std::to_string(compat::current_thread_id());
+}
+
+std::string FileSink::file_key(const std::string& channel) const
+{
+    if (shard_per_thread_)
+    {
+        return channel + thread_shard_suffix();
+    }
+    return channel;
+}
+
+std::string FileSink::file_path(const std::string& base_name, std::uint32_t index) const
+{
+    if (index == 0)
+    {
+        return log_path_ + "/" + base_name + ".log";
+    }
+    return log_path_ + "/" + base_name + "." + std::to_string(index) + ".log";
+}
+
+std::shared_ptr<FileSink::File> FileSink::find_file(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(files_mtx_);
+    std::shared_ptr<File>& file = current_files_[key];
+    if (!file)
+    {
+        file = std::make_shared<File>();
+    }
+    return file;
+}
+
+void FileSink::switch_stream(File& file, const std::string& channel, bool scan)
+{
+    std::string const base_name = file_base_name(channel);
+    if (atomic_append_)
+    {
+        switch_shared_stream(file, channel);
+        return;
+    }
+    std::stringstream ss;
+    ss << base_name;
     // If Channel file exists, close it and move to the index for this channel
-    if (current_files_.find(channel) != current_files_.end())
+    if (!scan)
     {
-        file = current_files_[channel];
-        if (file->stream.is_open())
-        {
-            file->stream.close();
-        }
-        file->index++;
+        write_bloom_filter(file);
+        close_time_index(file);
+        close_stream(file);
+        file.index++;
     }
     // Create new file for the channel
     else
     {
-        current_files_[channel] = std::make_shared<File>();
-        file = current_files_[channel];
         // List the dir to see if there were existing files for that channel already
         // Update the index accordingly
         std::unique_ptr<DIR, int (*)(DIR*)> dir{opendir(log_path_.c_str()), closedir};
@@ -155,24 +324,582 @@ void FileSink::switch_stream(const std::string& channel)
             // If we found an index file, we just create a new one with the next index
             if (last_index > 0)
             {
-                file->index = last_index + 1;
+                file.index = last_index + 1;
+            }
+        }
+    }
+
+    file.path = file_path(base_name, file.index);
+    open_stream(file, false);
+}
+
+std::optional<std::uint32_t> FileSink::latest_file_index(const std::string& base_name) const
+{
+    std::optional<std::uint32_t> latest;
+    std::unique_ptr<DIR, int (*)(DIR*)> dir{opendir(log_path_.c_str()), closedir};
+    if (dir == nullptr)
+    {
+        return latest;
+    }
+    struct dirent* dir_entry;
+    while ((dir_entry = readdir(dir.get())) != nullptr)
+    {
+        // Only accept exactly "<base_name>.log" or "<base_name>.<index>.log"
+        std::string_view name(dir_entry->d_name);
+        if (name.size() < base_name.size() + 4 || name.compare(0, base_name.size(), base_name) != 0 ||
+            name.compare(name.size() - 4, 4, ".log") != 0)
+        {
+            continue;
+        }
+        name = name.substr(base_name.size(), name.size() - base_name.size() - 4);
+        std::uint32_t index = 0;
+        if (!name.empty())
+        {
+            if (name.size() < 2 || name.front() != '.' ||
+                name.find_first_not_of("0123456789", 1) != std::string_view::npos)
+            {
+                continue;
             }
+            index = static_cast<std::uint32_t>(std::stoul(std::string(name.substr(1))));
+        }
+        if (!latest || index > *latest)
+        {
+            latest = index;
         }
     }
+    return latest;
+}
 
-    if (file->index == 0)
+void FileSink::switch_shared_stream(File& file, const std::string& channel)
+{
+    write_bloom_filter(file);
+    close_time_index(file);
+    // Several processes may append to the same files. The lock file is named without the time, so processes which
+    // open or rotate in different seconds still share it, and holds the current segment: the first process to find it
+    // full creates the next one while the rest join it
+    int const lock_fd =
+        ::open((log_path_ + "/" + file_group_name(channel) + ".lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    if (lock_fd >= 0)
+    {
+        while (::flock(lock_fd, LOCK_EX) != 0 && errno == EINTR)
+        {
+        }
+    }
+    close_stream(file);
+    std::uint32_t shared_index = 0;
+    std::string shared_name;
+    bool const shared = lock_fd >= 0 && read_shared_segment(lock_fd, shared_index, shared_name);
+    struct stat st = {};
+    if (shared && ::stat((log_path_ + "/" + shared_name).c_str(), &st) == 0 && st.st_size <= size_per_file_)
     {
-        ss << ".log";
+        file.index = shared_index;
+        file.path = log_path_ + "/" + shared_name;
     }
     else
     {
-        ss << "." << file->index << ".log";
+        std::string const base_name = file_base_name(channel);
+        file.index = shared ? shared_index + 1 : latest_file_index(base_name).value_or(0);
+        while (::stat(file_path(base_name, file.index).c_str(), &st) == 0 && st.st_size > size_per_file_)
+        {
+            file.index++;
+        }
+        file.path = file_path(base_name, file.index);
+        if (lock_fd >= 0)
+        {
+            write_shared_segment(lock_fd, file.index, file.path.substr(log_path_.size() + 1));
+        }
+    }
+    open_stream(file, false);
+    if (lock_fd >= 0)
+    {
+        ::flock(lock_fd, LOCK_UN);
+        ::close(lock_fd);
+    }
+}
+
+void FileSink::open_stream(File& file, bool reopen)
+{
+    if (atomic_append_)
+    {
+        file.fd = ::open(file.path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666);
+    }
+    else
+    {
+        file.stream.open(file.path, std::ofstream::out | std::ofstream::app);
+    }
+    if (!file.is_open())
+    {
+        return;
+    }
+    ++open_files_count_;
+    ++(reopen ? reopens_count_ : opens_count_);
+    touch_open_file(file);
+    if (!reopen)
+    {
+        start_time_index(file);
+    }
+}
+
+void FileSink::close_stream(File& file)
+{
+    if (max_open_files_ > 0)
+    {
+        std::lock_guard<std::mutex> lock(lru_mtx_);
+        if (file.in_lru)
+        {
+            open_files_lru_.erase(file.lru_position);
+            file.in_lru = false;
+        }
+    }
+    close_time_index_file(file);
+    if (file.fd >= 0)
+    {
+        ::close(file.fd);
+        file.fd = -1;
+        --open_files_count_;
+    }
+    if (file.stream.is_open())
+    {
+        file.stream.close();
+        --open_files_count_;
+    }
+}
+
+std::int64_t FileSink::file_size(File& file) const
+{
+    if (file.fd >= 0)
+    {
+        // Other processes may be appending to the same file, so the real size is taken from the file itself
+        struct stat st = {};
+        return ::fstat(file.fd, &st) == 0 ? static_cast<std::int64_t>(st.st_size) : 0;
+    }
+    return file.stream.tellp();
+}
+
+void FileSink::write_record(File& file, std::string&& line)
+{
+    if (file.fd < 0)
+    {
+        file.stream << line;
+        file.stream << std::endl;
+        return;
+    }
+    // A single write of the whole record, O_APPEND makes it land at the end of the file as one unit even when other
+    // processes write to the same file
+    line += '\n';
+    char const* data = line.data();
+    std::size_t remaining = line.size();
+    while (remaining > 0)
+    {
+        ssize_t const written = ::write(file.fd, data, remaining);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;
+        }
+        data += written;
+        remaining -= static_cast<std::size_t>(written);
+    }
+}
+
+void FileSink::touch_open_file(File& file)
+{
+    if (max_open_files_ <= 0)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(lru_mtx_);
+    if (file.in_lru)
+    {
+        open_files_lru_.splice(open_files_lru_.begin(), open_files_lru_, file.lru_position);
+        return;
+    }
+    file.lru_position = open_files_lru_.insert(open_files_lru_.begin(), &file);
+    file.in_lru = true;
+    // The least recently used files are closed by evict_files, other threads may be writing to them
+    while (open_files_lru_.size() > static_cast<std::size_t>(max_open_files_))
+    {
+        File* const evicted = open_files_lru_.back();
+        open_files_lru_.pop_back();
+        evicted->in_lru = false;
+        evicted_files_.push_back(evicted);
+    }
+}
+
+void FileSink::evict_files()
+{
+    std::vector<File*> evicted;
+    {
+        std::lock_guard<std::mutex> lock(lru_mtx_);
+        evicted.swap(evicted_files_);
+    }
+    for (File* const file : evicted)
+    {
+        std::lock_guard<std::mutex> file_lock(file->mtx);
+        {
+            std::lock_guard<std::mutex> lock(lru_mtx_);
+            // Used again since it was taken out, or already closed by a rotation
+            if (file->in_lru || !file->is_open())
+            {
+                continue;
+            }
+        }
+        // Reopened in append mode on its next log
+        if (file->stream.is_open())
+        {
+            file->stream.flush();
+        }
+        close_stream(*file);
+        ++evictions_count_;
     }
-    file->stream.open(std::string(log_path_) + "/" + ss.str().data(), std::ofstream::out | std::ofstream::app);
+}
+
+void FileSink::start_preopen_thread()
+{
+    preopen_running_ = true;
+    preopen_pid_ = ::getpid();
+    preopen_cond_ = std::make_unique<std::condition_variable>();
+    preopen_thread_ = std::make_unique<std::thread>(&FileSink::preopen_thread, this);
+}
+
+void FileSink::stop_preopen_thread()
+{
+    if (!preopen_thread_)
+    {
+        return;
+    }
+    if (preopen_pid_ == ::getpid())
+    {
+        {
+            std::lock_guard<std::mutex> lock(preopen_mtx_);
+            preopen_running_ = false;
+        }
+        preopen_cond_->notify_all();
+        // The thread drains the queued tasks before exiting
+        preopen_thread_->join();
+        preopen_thread_.reset();
+        return;
+    }
+    // We are in a forked process, the thread only exists in the parent and may have held the mutex or waited on the
+    // condition variable while forking, so none of them can be released safely
+    preopen_thread_.release();
+    preopen_cond_.release();
+    preopen_cond_ = std::make_unique<std::condition_variable>();
+    preopen_mtx_.fork_reset();
+    preopen_running_ = false;
+    // Records are flushed as they are written, dropping the inherited streams does not write anything
+    preopen_tasks_.clear();
+}
+
+void FileSink::preopen_thread()
+{
+    std::unique_lock<std::mutex> lock(preopen_mtx_);
+    while (true)
+    {
+        preopen_cond_->wait(lock, [this]() { return !preopen_tasks_.empty() || !preopen_running_; });
+        if (preopen_tasks_.empty())
+        {
+            return;
+        }
+        auto task = std::move(preopen_tasks_.front());
+        preopen_tasks_.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+bool FileSink::preopen_available()
+{
+    if (!preopen_thread_)
+    {
+        return false;
+    }
+    if (preopen_pid_ != ::getpid())
+    {
+        // Forked since the thread was started, rotate inline until the sink is restarted
+        stop_preopen_thread();
+        return false;
+    }
+    return true;
+}
+
+void FileSink::enqueue_preopen_task(std::function<void()>&& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(preopen_mtx_);
+        preopen_tasks_.push_back(std::move(task));
+    }
+    preopen_cond_->notify_all();
+}
+
+void FileSink::request_next_segment(File& file, const std::string& channel)
+{
+    // Files are never removed from current_files_ while the thread runs, so the reference stays valid
+    std::string path = file_path(file_base_name(channel), file.index + 1);
+    file.next_requested = true;
+    enqueue_preopen_task([this, &file, path = std::move(path)]() { prepare_next_segment(file, path); });
+}
+
+void FileSink::prepare_next_segment(File& file, std::string const& path)
+{
+    preallocate_file(path, size_per_file_);
+    auto stream = std::make_unique<std::ofstream>(path, std::ofstream::out | std::ofstream::app);
+    if (stream->is_open())
+    {
+        ++open_files_count_;
+        ++opens_count_;
+    }
+    {
+        std::lock_guard<std::mutex> lock(preopen_mtx_);
+        file.next_stream = std::move(stream);
+        file.next_path = path;
+        file.next_pid = ::getpid();
+    }
+    preopen_cond_->notify_all();
+}
+
+bool FileSink::swap_to_next_segment(File& file)
+{
+    if (!file.next_requested)
+    {
+        return false;
+    }
+    file.next_requested = false;
+    bool const available = preopen_available();
+    std::unique_ptr<std::ofstream> next;
+    std::string next_path;
+    {
+        std::unique_lock<std::mutex> lock(preopen_mtx_);
+        if (available)
+        {
+            // Only waits when the file filled up from the fill ratio faster than the next segment could be opened
+            preopen_cond_->wait(lock, [this, &file]() { return file.next_stream != nullptr || !preopen_running_; });
+        }
+        next = std::move(file.next_stream);
+        next_path = std::move(file.next_path);
+    }
+    if (!next || !next->is_open())
+    {
+        return false;
+    }
+
+    auto previous = std::make_shared<std::ofstream>(std::move(file.stream));
+    std::shared_ptr<LogBloomFilter> previous_bloom;
+    if (file.bloom && file.bloom->items() > 0)
+    {
+        previous_bloom = std::move(file.bloom);
+    }
+    close_time_index(file);
+    std::string previous_path = std::move(file.path);
+    file.stream = std::move(*next);
+    file.path = std::move(next_path);
+    file.index++;
+    ++preopened_rotations_count_;
+    start_time_index(file);
+    if (!available)
+    {
+        previous->close();
+        --open_files_count_;
+        if (previous_bloom)
+        {
+            save_bloom_filter(previous_path, *previous_bloom);
+        }
+        return true;
+    }
+    enqueue_preopen_task([this, previous, previous_bloom, previous_path = std::move(previous_path)]() {
+        previous->close();
+        --open_files_count_;
+        sync_file(previous_path);
+        if (previous_bloom)
+        {
+            save_bloom_filter(previous_path, *previous_bloom);
+        }
+    });
+    return true;
+}
+
+void FileSink::discard_next_segment(File& file)
+{
+    if (!file.next_stream)
+    {
+        return;
+    }
+    if (file.next_stream->is_open())
+    {
+        file.next_stream->close();
+        --open_files_count_;
+        // Remove the unused segment, unless it was opened by the parent process which may still rotate into it
+        struct stat st = {};
+        if (file.next_pid == ::getpid() && ::stat(file.next_path.c_str(), &st) == 0 && st.st_size == 0)
+        {
+            ::unlink(file.next_path.c_str());
+        }
+    }
+    file.next_stream.reset();
+    file.next_requested = false;
+}
+
+bool FileSink::time_index_enabled() const
+{
+    return time_index_records_ > 0 || time_index_bytes_ > 0;
+}
+
+void FileSink::start_time_index(File& file)
+{
+    if (!time_index_enabled())
+    {
+        return;
+    }
+    // The segment may already have records when appending to an existing file
+    struct stat st = {};
+    file.index_offset = ::stat(file.path.c_str(), &st) == 0 ? static_cast<std::uint64_t>(st.st_size) : 0;
+    file.index_records = 0;
+    file.index_bytes = 0;
+    file.index_started = false;
+}
+
+void FileSink::update_time_index(File& file, Log const& log, std::size_t record_size)
+{
+    std::int64_t const timestamp =
+        std::chrono::duration_cast<std::chrono::milliseconds>(log.time_created().time_since_epoch()).count();
+    std::uint64_t offset = file.index_offset;
+    file.index_offset += record_size;
+    // The first record of a segment always starts a block
+    if (file.index_started && (time_index_records_ == 0 || file.index_records < time_index_records_) &&
+        (time_index_bytes_ == 0 || file.index_bytes < time_index_bytes_))
+    {
+        ++file.index_records;
+        file.index_bytes += record_size;
+        file.index_min_timestamp = std::min(file.index_min_timestamp, timestamp);
+        file.index_max_timestamp = std::max(file.index_max_timestamp, timestamp);
+        return;
+    }
+    if (file.fd >= 0)
+    {
+        // Other processes may append to the segment, the record ended where the O_APPEND write left the offset
+        off_t const end = ::lseek(file.fd, 0, SEEK_CUR);
+        if (end >= static_cast<off_t>(record_size))
+        {
+            offset = static_cast<std::uint64_t>(end) - record_size;
+        }
+    }
+    // The records of this writer in the previous block are all before this one, it is closed with the same write
+    LogTimeIndex::Entry const entries[] = {
+        {file.index_min_timestamp, file.index_max_timestamp, file.index_block_offset, offset},
+        {timestamp, timestamp, offset, 0},
+    };
+    bool const close_previous = file.index_started;
+    append_time_index_entries(file, close_previous ? entries : entries + 1, close_previous ? 2 : 1);
+    file.index_started = true;
+    file.index_records = 1;
+    file.index_bytes = record_size;
+    file.index_block_offset = offset;
+    file.index_min_timestamp = timestamp;
+    file.index_max_timestamp = timestamp;
+}
+
+void FileSink::close_time_index(File& file)
+{
+    if (!file.index_started || file.path.empty())
+    {
+        return;
+    }
+    std::uint64_t end = file.index_offset;
+    struct stat st = {};
+    if (file.fd >= 0 && ::fstat(file.fd, &st) == 0)
+    {
+        // Where this writer's last record ended is unknown when others append too, the file end is past it
+        end = static_cast<std::uint64_t>(st.st_size);
+    }
+    LogTimeIndex::Entry const entry{file.index_min_timestamp, file.index_max_timestamp, file.index_block_offset, end};
+    append_time_index_entries(file, &entry, 1);
+    close_time_index_file(file);
+    file.index_started = false;
+}
+
+void FileSink::append_time_index_entries(File& file, LogTimeIndex::Entry const* entries, std::size_t count)
+{
+    if (file.index_fd < 0)
+    {
+        file.index_fd =
+            ::open(LogTimeIndex::index_path(file.path).c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666);
+        if (file.index_fd < 0)
+        {
+            return;
+        }
+    }
+    while (::write(file.index_fd, entries, count * sizeof(entries[0])) < 0 && errno == EINTR)
+    {
+    }
+}
+
+void FileSink::close_time_index_file(File& file)
+{
+    if (file.index_fd >= 0)
+    {
+        ::close(file.index_fd);
+        file.index_fd = -1;
+    }
+}
+
+void FileSink::update_bloom_filter(File& file,
+                                   Log const& log,
+                                   ContextInfo const& context_info,
+                                   ContextInfo const& global_context_info)
+{
+    if (!file.bloom)
+    {
+        file.bloom = std::make_unique<LogBloomFilter>(bloom_bits_);
+    }
+    for (std::size_t i = 0; i < bloom_keys_.size(); ++i)
+    {
+        // The most local context_info has the highest precedence, the same as when the context is formatted
+        bool found = false;
+        for (auto const* ci : {&log.context_info(), &log.scoped_context(), &context_info, &global_context_info})
+        {
+            for (ContextInfo const* link = ci; link != nullptr && !found; link = link->parent())
+            {
+                if (auto const* entry = link->entry(bloom_key_ids_[i]))
+                {
+                    file.bloom->insert(bloom_keys_[i], entry->value.to_string());
+                    found = true;
+                }
+            }
+        }
+    }
+    if (!log.extra_identifier().empty())
+    {
+        file.bloom->insert(LogBloomFilter::EXTRA_IDENTIFIER_KEY, log.extra_identifier());
+    }
+}
+
+void FileSink::write_bloom_filter(File& file)
+{
+    if (!file.bloom || file.bloom->items() == 0 || file.path.empty())
+    {
+        return;
+    }
+    save_bloom_filter(file.path, *file.bloom);
+    file.bloom->clear();
 }
 
 FileSink::FileSink(const SinkConfig& config)
-    : Sink(config, "", extract_format_with_default(config, LineFormat::PLAINTEXT_LONG))
+    : Sink(config, "", extract_format_with_default(config, LineFormat::PLAINTEXT_LONG)),
+      opens_count_(0),
+      reopens_count_(0),
+      evictions_count_(0),
+      open_files_count_(0),
+      preopened_rotations_count_(0),
+      preopen_running_(false),
+      preopen_pid_(0),
+      time_index_records_(0),
+      time_index_bytes_(0),
+      bloom_enabled_(false),
+      bloom_bits_(LogBloomFilter::DEFAULT_BITS)
 {
     combined_channels_prefix_ = config.option_default(SinkConfig::SinkOption::FILE_COMBINED_CHANNEL_PREFIX, "ALL");
     prefix_folder_name_ = config.option_default(SinkConfig::SinkOption::FILE_LOG_FOLDER_PREFIX, "");
@@ -181,6 +908,26 @@ FileSink::FileSink(const SinkConfig& config)
     max_files_ = config.option_default<int>(SinkConfig::SinkOption::FILE_MAX_LOG_FILES, -1);
     separate_channels_to_files_ = config.option_default(SinkConfig::SinkOption::FILE_SEPARATE_CHANNEL_FILES, false);
     separate_logs_by_date_folder_ = !config.has_option(SinkConfig::SinkOption::FILE_LOG_FOLDER_NO_SEPARATE_BY_DATE);
+    max_open_files_ = config.option_default<int>(SinkConfig::SinkOption::FILE_MAX_OPEN_FILES, -1);
+    atomic_append_ = config.option_default(SinkConfig::SinkOption::FILE_ATOMIC_APPEND, false);
+    shard_per_thread_ = config.option_default(SinkConfig::SinkOption::FILE_SHARD_PER_THREAD, false);
+    preopen_fill_ratio_ = config.option_default(SinkConfig::SinkOption::FILE_PREOPEN_FILL_RATIO, 0.0);
+    time_index_records_ = config.option_default<std::uint64_t>(SinkConfig::SinkOption::FILE_TIME_INDEX_RECORDS, 0);
+    time_index_bytes_ = config.option_default<std::uint64_t>(SinkConfig::SinkOption::FILE_TIME_INDEX_BYTES, 0);
+    std::string bloom_keys;
+    bloom_enabled_ = config.option(SinkConfig::SinkOption::FILE_BLOOM_KEYS, bloom_keys);
+    std::stringstream bloom_keys_stream(bloom_keys);
+    std::string bloom_key;
+    while (std::getline(bloom_keys_stream, bloom_key, ','))
+    {
+        if (!bloom_key.empty())
+        {
+            bloom_keys_.push_back(bloom_key);
+            bloom_key_ids_.push_back(ContextInfo::intern(bloom_key));
+        }
+    }
+    bloom_bits_ = config.option_default<std::size_t>(SinkConfig::SinkOption::FILE_BLOOM_BITS,
+                                                     LogBloomFilter::DEFAULT_BITS);
     strftime_format_ = "";
     if (!config.has_option(SinkConfig::SinkOption::FILE_NO_DATE_ON_NAME))
     {
@@ -198,22 +945,80 @@ FileSink::FileSink(const SinkConfig& config)
     create_log_path();
     recursive_folder_creation(log_path_.c_str(), S_IRWXU | S_IRWXG);
 
-    if (!separate_channels_to_files_)
+    // Thread shards are only known once each thread logs
+    if (!separate_channels_to_files_ && !shard_per_thread_)
     {
-        switch_stream(combined_channels_prefix_);
+        switch_stream(*find_file(combined_channels_prefix_), combined_channels_prefix_, true);
     }
 
     disable_file_context_info_ = Sink::config().option_default(SinkConfig::SinkOption::FILE_DISABLE_CONTEXT_INFO, true);
+
+    // Shared segments are picked by whichever process rotates first, so they cannot be prepared ahead
+    if (preopen_fill_ratio_ > 0 && preopen_fill_ratio_ < 1 && !atomic_append_)
+    {
+        start_preopen_thread();
+    }
 }
 
 FileSink::~FileSink()
 {
+    stop_preopen_thread();
     for (auto&& file : current_files_)
     {
-        file.second->stream.close();
+        discard_next_segment(*file.second);
+        write_bloom_filter(*file.second);
+        close_time_index(*file.second);
+        close_stream(*file.second);
     }
 }
 
+void FileSink::stop_impl()
+{
+    stop_preopen_thread();
+}
+
+void FileSink::restart_sink() noexcept
+{
+    if (preopen_fill_ratio_ <= 0 || preopen_fill_ratio_ >= 1 || atomic_append_)
+    {
+        return;
+    }
+    try
+    {
+        stop_preopen_thread();
+        // Segments prepared by the parent are left to it, this process rotates into its own
+        std::lock_guard<std::mutex> lock(files_mtx_);
+        for (auto&& file : current_files_)
+        {
+            std::lock_guard<std::mutex> file_lock(file.second->mtx);
+            discard_next_segment(*file.second);
+        }
+        start_preopen_thread();
+    }
+    catch (const std::exception& e)
+    {
+        // Ignored, the sink keeps rotating inline
+    }
+}
+
+bool FileSink::thread_safe_dump() const noexcept
+{
+    return true;
+}
+
+void FileSink::child_on_fork() noexcept
+{
+    // Threads of the parent may have held any of the locks while forking
+    files_mtx_.fork_reset();
+    lru_mtx_.fork_reset();
+    for (auto&& file : current_files_)
+    {
+        file.second->mtx.fork_reset();
+    }
+    // Rotates inline until the sink is restarted, so concurrent records never find the parent's thread
+    stop_preopen_thread();
+}
+
 void FileSink::dump(const Log& log,
                     const Channel& channel,
                     ContextInfo const& context_info,
@@ -228,22 +1033,58 @@ void FileSink::dump(const Log& log,
     else
     {
         channel_name = channel.channel_name();
-        if (current_files_.find(channel_name) == current_files_.end())
-        {
-            current_files_[channel_name] = std::make_shared<File>();
-            switch_stream(channel_name);
-        }
     }
 
-    std::shared_ptr<File> const file = current_files_[channel_name];
-    if (max_files_ != -1 && file->index > static_cast<std::uint32_t>(max_files_))
+    std::shared_ptr<File> const file = find_file(file_key(channel_name));
+    {
+        std::lock_guard<std::mutex> lock(file->mtx);
+        dump_to_file(*file, channel_name, log, channel, context_info, global_context_info);
+    }
+    if (max_open_files_ > 0)
+    {
+        evict_files();
+    }
+}
+
+void FileSink::dump_to_file(File& file,
+                            const std::string& channel_name,
+                            const Log& log,
+                            const Channel& channel,
+                            ContextInfo const& context_info,
+                            ContextInfo const& global_context_info)
+{
+    if (file.path.empty())
+    {
+        // The first record of a channel or thread. Channel files start after index 0, as they always did
+        switch_stream(file, channel_name, shard_per_thread_);
+    }
+    if (max_files_ != -1 && file.index > static_cast<std::uint32_t>(max_files_))
     {
         return;
     }
 
-    if (file->stream.tellp() > size_per_file_)
+    if (!file.is_open())
+    {
+        // Evicted by the open files cap, continue appending to the same file
+        open_stream(file, true);
+    }
+    else
+    {
+        touch_open_file(file);
+    }
+
+    std::int64_t const size = file_size(file);
+    if (size > size_per_file_)
     {
-        switch_stream(channel_name);
+        if (!swap_to_next_segment(file))
+        {
+            switch_stream(file, channel_name, false);
+        }
+    }
+    else if (preopen_thread_ && !file.next_requested && size > preopen_fill_ratio_ * size_per_file_ &&
+             (max_files_ == -1 || file.index < static_cast<std::uint32_t>(max_files_)) && preopen_available())
+    {
+        request_next_segment(file, channel_name);
     }
 
     if (!log.has_stream())
@@ -251,8 +1092,26 @@ void FileSink::dump(const Log& log,
         return;
     }
 
-    file->stream << formatted_log(log, channel, context_info, global_context_info, disable_file_context_info_);
-    file->stream << std::endl;
+    std::string line = formatted_log(log, channel, context_info, global_context_info, disable_file_context_info_);
+    std::size_t const record_size = line.size() + 1;
+    write_record(file, std::move(line));
+    if (time_index_enabled())
+    {
+        update_time_index(file, log, record_size);
+    }
+    if (bloom_enabled_)
+    {
+        update_bloom_filter(file, log, context_info, global_context_info);
+    }
+}
+
+FileSink::OpenFilesStats FileSink::open_files_stats() const
+{
+    return OpenFilesStats{opens_count_.load(std::memory_order_relaxed),
+                          reopens_count_.load(std::memory_order_relaxed),
+                          evictions_count_.load(std::memory_order_relaxed),
+                          open_files_count_.load(std::memory_order_relaxed),
+                          preopened_rotations_count_.load(std::memory_order_relaxed)};
 }
 } // namespace octo::logger
 
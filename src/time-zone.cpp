@@ -0,0 +1,470 @@
+/**
+ * @file time-zone.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/time-zone.hpp"
+
+#include "octo-logger-cpp/compat.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+constexpr std::int64_t SECONDS_PER_DAY = 24 * 60 * 60;
+constexpr std::size_t TZIF_HEADER_SIZE = 44;
+constexpr char const* DEFAULT_ZONEINFO_DIR = "/usr/share/zoneinfo";
+constexpr char const* DEFAULT_LOCALTIME_PATH = "/etc/localtime";
+// Used by glibc when a POSIX TZ string has a DST name but no rule
+constexpr std::string_view DEFAULT_DST_RULE = ",M3.2.0,M11.1.0";
+
+struct TzifHeader
+{
+    char version;
+    std::uint32_t isutcnt;
+    std::uint32_t isstdcnt;
+    std::uint32_t leapcnt;
+    std::uint32_t timecnt;
+    std::uint32_t typecnt;
+    std::uint32_t charcnt;
+};
+
+std::uint32_t read_be32(char const* data)
+{
+    auto const* bytes = reinterpret_cast<unsigned char const*>(data);
+    return (static_cast<std::uint32_t>(bytes[0]) << 24) | (static_cast<std::uint32_t>(bytes[1]) << 16) |
+           (static_cast<std::uint32_t>(bytes[2]) << 8) | static_cast<std::uint32_t>(bytes[3]);
+}
+
+std::int64_t read_be64(char const* data)
+{
+    return static_cast<std::int64_t>((static_cast<std::uint64_t>(read_be32(data)) << 32) | read_be32(data + 4));
+}
+
+bool read_header(std::string_view data, std::size_t pos, TzifHeader& header)
+{
+    if (data.size() < pos + TZIF_HEADER_SIZE || data.substr(pos, 4) != "TZif")
+    {
+        return false;
+    }
+    char const* counts = data.data() + pos + 20;
+    header.version = data[pos + 4];
+    header.isutcnt = read_be32(counts);
+    header.isstdcnt = read_be32(counts + 4);
+    header.leapcnt = read_be32(counts + 8);
+    header.timecnt = read_be32(counts + 12);
+    header.typecnt = read_be32(counts + 16);
+    header.charcnt = read_be32(counts + 20);
+    return header.typecnt > 0;
+}
+
+std::size_t data_block_size(TzifHeader const& header, std::size_t time_size)
+{
+    return header.timecnt * time_size + header.timecnt + header.typecnt * 6 + header.charcnt +
+           header.leapcnt * (time_size + 4) + header.isstdcnt + header.isutcnt;
+}
+
+bool parse_number(std::string_view& text, int max_digits, int& value)
+{
+    int digits = 0;
+    value = 0;
+    while (!text.empty() && digits < max_digits && text.front() >= '0' && text.front() <= '9')
+    {
+        value = value * 10 + (text.front() - '0');
+        text.remove_prefix(1);
+        ++digits;
+    }
+    return digits > 0;
+}
+
+// [+|-]hh[:mm[:ss]], used both for zone offsets and for rule times
+bool parse_hms(std::string_view& text, std::int32_t& seconds)
+{
+    int sign = 1;
+    if (!text.empty() && (text.front() == '+' || text.front() == '-'))
+    {
+        sign = text.front() == '-' ? -1 : 1;
+        text.remove_prefix(1);
+    }
+    int hours = 0;
+    int minutes = 0;
+    int secs = 0;
+    if (!parse_number(text, 3, hours))
+    {
+        return false;
+    }
+    if (!text.empty() && text.front() == ':')
+    {
+        text.remove_prefix(1);
+        if (!parse_number(text, 2, minutes))
+        {
+            return false;
+        }
+        if (!text.empty() && text.front() == ':')
+        {
+            text.remove_prefix(1);
+            if (!parse_number(text, 2, secs))
+            {
+                return false;
+            }
+        }
+    }
+    seconds = sign * (hours * 60 * 60 + minutes * 60 + secs);
+    return true;
+}
+
+bool parse_name(std::string_view& text, std::string_view& name)
+{
+    if (!text.empty() && text.front() == '<')
+    {
+        std::size_t const end = text.find('>');
+        if (end == std::string_view::npos)
+        {
+            return false;
+        }
+        name = text.substr(1, end - 1);
+        text.remove_prefix(end + 1);
+        return !name.empty();
+    }
+    std::size_t length = 0;
+    while (length < text.size() && ((text[length] >= 'A' && text[length] <= 'Z') ||
+                                    (text[length] >= 'a' && text[length] <= 'z')))
+    {
+        ++length;
+    }
+    name = text.substr(0, length);
+    text.remove_prefix(length);
+    return length > 0;
+}
+
+bool is_leap_year(std::int64_t year)
+{
+    return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+} // namespace
+
+namespace octo::logger
+{
+TimeZone::TimeZone() : types_{{0, false, 0}}, abbreviations_(std::string("UTC") + '\0')
+{
+}
+
+std::uint32_t TimeZone::add_abbreviation(std::string_view abbreviation)
+{
+    auto const offset = static_cast<std::uint32_t>(abbreviations_.size());
+    abbreviations_.append(abbreviation);
+    abbreviations_ += '\0';
+    return offset;
+}
+
+bool TimeZone::parse_tzif(std::string_view data)
+{
+    TzifHeader header = {};
+    if (!read_header(data, 0, header))
+    {
+        return false;
+    }
+    std::size_t pos = TZIF_HEADER_SIZE;
+    std::size_t time_size = 4;
+    if (header.version >= '2')
+    {
+        // Version 2+ repeats the data with 64 bit times after the version 1 block, followed by the POSIX TZ footer
+        pos += data_block_size(header, 4);
+        if (!read_header(data, pos, header))
+        {
+            return false;
+        }
+        pos += TZIF_HEADER_SIZE;
+        time_size = 8;
+    }
+    if (data.size() < pos + data_block_size(header, time_size))
+    {
+        return false;
+    }
+
+    char const* cursor = data.data() + pos;
+    transitions_.resize(header.timecnt);
+    for (auto& transition : transitions_)
+    {
+        transition = time_size == 8 ? read_be64(cursor) : static_cast<std::int32_t>(read_be32(cursor));
+        cursor += time_size;
+    }
+    transition_types_.assign(cursor, cursor + header.timecnt);
+    cursor += header.timecnt;
+    types_.resize(header.typecnt);
+    for (auto& type : types_)
+    {
+        type.utc_offset = static_cast<std::int32_t>(read_be32(cursor));
+        type.is_dst = cursor[4] != 0;
+        type.abbreviation = static_cast<unsigned char>(cursor[5]);
+        cursor += 6;
+        if (type.abbreviation >= header.charcnt)
+        {
+            return false;
+        }
+    }
+    abbreviations_.assign(cursor, header.charcnt);
+    abbreviations_ += '\0';
+    cursor += header.charcnt + header.leapcnt * (time_size + 4) + header.isstdcnt + header.isutcnt;
+    if (std::any_of(transition_types_.begin(), transition_types_.end(), [&](std::uint8_t type) {
+            return type >= header.typecnt;
+        }))
+    {
+        return false;
+    }
+
+    if (time_size == 8)
+    {
+        std::string_view footer = data.substr(static_cast<std::size_t>(cursor - data.data()));
+        if (footer.size() >= 2 && footer.front() == '\n')
+        {
+            footer.remove_prefix(1);
+            std::size_t const end = footer.find('\n');
+            if (end != std::string_view::npos && end > 0 && !parse_rule(footer.substr(0, end)))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool TimeZone::parse_rule(std::string_view rule)
+{
+    PosixRule parsed;
+    std::string_view name;
+    std::int32_t offset = 0;
+    if (!parse_name(rule, name) || !parse_hms(rule, offset))
+    {
+        return false;
+    }
+    // POSIX offsets are positive west of Greenwich
+    parsed.standard = {-offset, false, add_abbreviation(name)};
+    if (!rule.empty())
+    {
+        if (!parse_name(rule, name))
+        {
+            return false;
+        }
+        parsed.has_dst = true;
+        parsed.dst = {parsed.standard.utc_offset + 60 * 60, true, add_abbreviation(name)};
+        if (!rule.empty() && rule.front() != ',')
+        {
+            if (!parse_hms(rule, offset))
+            {
+                return false;
+            }
+            parsed.dst.utc_offset = -offset;
+        }
+        if (rule.empty())
+        {
+            rule = DEFAULT_DST_RULE;
+        }
+        for (RuleDate* date : {&parsed.start, &parsed.end})
+        {
+            if (rule.empty() || rule.front() != ',')
+            {
+                return false;
+            }
+            rule.remove_prefix(1);
+            if (!rule.empty() && rule.front() == 'M')
+            {
+                rule.remove_prefix(1);
+                date->kind = RuleDate::Kind::MONTH_WEEK_DAY;
+                if (!parse_number(rule, 2, date->month) || rule.empty() || rule.front() != '.')
+                {
+                    return false;
+                }
+                rule.remove_prefix(1);
+                if (!parse_number(rule, 1, date->week) || rule.empty() || rule.front() != '.')
+                {
+                    return false;
+                }
+                rule.remove_prefix(1);
+                if (!parse_number(rule, 1, date->day) || date->month < 1 || date->month > 12 || date->week < 1 ||
+                    date->week > 5 || date->day > 6)
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                date->kind = RuleDate::Kind::JULIAN;
+                if (!rule.empty() && rule.front() == 'J')
+                {
+                    rule.remove_prefix(1);
+                    date->kind = RuleDate::Kind::JULIAN_NO_LEAP;
+                }
+                if (!parse_number(rule, 3, date->day) || date->day > 365 ||
+                    (date->kind == RuleDate::Kind::JULIAN_NO_LEAP && date->day < 1))
+                {
+                    return false;
+                }
+            }
+            if (!rule.empty() && rule.front() == '/')
+            {
+                rule.remove_prefix(1);
+                if (!parse_hms(rule, date->time))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    if (!rule.empty())
+    {
+        return false;
+    }
+    parsed.valid = true;
+    rule_ = parsed;
+    return true;
+}
+
+std::int64_t TimeZone::rule_transition(RuleDate const& date, std::int64_t year, std::int32_t utc_offset)
+{
+    std::int64_t days = compat::days_from_civil(year, 1, 1);
+    switch (date.kind)
+    {
+        case RuleDate::Kind::JULIAN_NO_LEAP:
+            days += date.day - 1 + (is_leap_year(year) && date.day >= 60 ? 1 : 0);
+            break;
+        case RuleDate::Kind::JULIAN:
+            days += date.day;
+            break;
+        case RuleDate::Kind::MONTH_WEEK_DAY:
+        {
+            auto const month = static_cast<unsigned>(date.month);
+            std::int64_t const first = compat::days_from_civil(year, month, 1);
+            std::int64_t const next_month =
+                month == 12 ? compat::days_from_civil(year + 1, 1, 1) : compat::days_from_civil(year, month + 1, 1);
+            // 1970-01-01 was a Thursday
+            std::int64_t const first_weekday = ((first + 4) % 7 + 7) % 7;
+            days = first + (date.day - first_weekday + 7) % 7 + 7 * (date.week - 1);
+            // Week 5 means the last such day of the month
+            while (days >= next_month)
+            {
+                days -= 7;
+            }
+            break;
+        }
+    }
+    // The rule time is local time, in the offset in effect before the switch
+    return days * SECONDS_PER_DAY + date.time - utc_offset;
+}
+
+TimeZone::LocalTimeType const& TimeZone::rule_type(std::int64_t time) const
+{
+    if (!rule_.has_dst)
+    {
+        return rule_.standard;
+    }
+    struct tm civil = {};
+    compat::civil_from_seconds(time + rule_.standard.utc_offset, &civil);
+    std::int64_t const year = static_cast<std::int64_t>(civil.tm_year) + 1900;
+    std::int64_t const start = rule_transition(rule_.start, year, rule_.standard.utc_offset);
+    std::int64_t const end = rule_transition(rule_.end, year, rule_.dst.utc_offset);
+    // In the southern hemisphere DST spans the new year, so it's everything outside [end, start)
+    bool const is_dst = start < end ? time >= start && time < end : !(time >= end && time < start);
+    return is_dst ? rule_.dst : rule_.standard;
+}
+
+TimeZone::LocalTimeType const& TimeZone::local_time_type(std::int64_t time) const
+{
+    if (rule_.valid && (transitions_.empty() || time >= transitions_.back()))
+    {
+        return rule_type(time);
+    }
+    if (transitions_.empty() || time < transitions_.front())
+    {
+        return types_.front();
+    }
+    auto const next = std::upper_bound(transitions_.begin(), transitions_.end(), time);
+    return types_[transition_types_[static_cast<std::size_t>(std::distance(transitions_.begin(), next)) - 1]];
+}
+
+char const* TimeZone::abbreviation(LocalTimeType const& type) const
+{
+    return abbreviations_.c_str() + type.abbreviation;
+}
+
+struct tm* TimeZone::to_local(std::int64_t time, struct tm* result) const
+{
+    LocalTimeType const& type = local_time_type(time);
+    compat::civil_from_seconds(time + type.utc_offset, result);
+    result->tm_isdst = type.is_dst ? 1 : 0;
+#ifndef _WIN32
+    result->tm_gmtoff = type.utc_offset;
+    result->tm_zone = const_cast<char*>(abbreviation(type));
+#endif
+    return result;
+}
+
+bool TimeZone::load_file(std::string const& path)
+{
+    std::ifstream in(path, std::ifstream::binary);
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    *this = TimeZone();
+    if (!in.is_open() || !parse_tzif(data))
+    {
+        *this = TimeZone();
+        return false;
+    }
+    return true;
+}
+
+bool TimeZone::load(std::string const& name)
+{
+    std::string spec = name;
+    if (spec.empty())
+    {
+        char const* tz = std::getenv("TZ");
+        if (tz == nullptr)
+        {
+            return load_file(DEFAULT_LOCALTIME_PATH);
+        }
+        spec = tz;
+    }
+    *this = TimeZone();
+    if (!spec.empty() && spec.front() == ':')
+    {
+        spec.erase(0, 1);
+    }
+    if (spec.empty())
+    {
+        // An empty TZ is UTC
+        return true;
+    }
+    if (spec.front() == '/')
+    {
+        return load_file(spec);
+    }
+    char const* tzdir = std::getenv("TZDIR");
+    if (load_file(std::string(tzdir != nullptr && *tzdir != '\0' ? tzdir : DEFAULT_ZONEINFO_DIR) + "/" + spec))
+    {
+        return true;
+    }
+    // Not a zone name, may be a POSIX TZ string such as EST5EDT,M3.2.0,M11.1.0
+    if (!parse_rule(spec))
+    {
+        *this = TimeZone();
+        return false;
+    }
+    return true;
+}
+
+TimeZone const& TimeZone::local()
+{
+    static TimeZone const zone = [] {
+        TimeZone local_zone;
+        local_zone.load("");
+        return local_zone;
+    }();
+    return zone;
+}
+} // namespace octo::logger
@@ -0,0 +1,129 @@
+/**
+ * @file log-lookup.cpp
+ * @brief Prints the records of FileSink segments which carry a context value, skipping the segments whose Bloom filter
+ * (.bloom) rules the value out
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/log-bloom-filter.hpp"
+#include "octo-logger-cpp/log-timestamp-parser.hpp"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+/**
+ * @brief Prints the records (a timestamped line and its continuation lines) which contain the value.
+ */
+bool print_matching_records(std::string const& segment_path, std::string const& value)
+{
+    std::ifstream in(segment_path);
+    if (!in.is_open())
+    {
+        return false;
+    }
+    octo::logger::LogTimestampParser parser;
+    std::string record;
+    bool matched = false;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (parser.parse(line))
+        {
+            if (matched)
+            {
+                std::cout << record;
+            }
+            record.clear();
+            matched = false;
+        }
+        matched = matched || line.find(value) != std::string::npos;
+        record += line;
+        record += '\n';
+    }
+    if (matched)
+    {
+        std::cout << record;
+    }
+    return true;
+}
+
+void print_usage(char const* name)
+{
+    std::cerr << "Usage: " << name << " [--key <key> | --extra-identifier] [--list] <value> <segment>...\n"
+              << "Prints the records of FileSink segments which contain the value of a context key indexed with\n"
+              << "FILE_BLOOM_KEYS. Segments without a .bloom file (e.g. still being written) are always searched.\n"
+              << "Records are matched by the value appearing in them, so the context info must be written to the\n"
+              << "files (JSON line format, or FILE_DISABLE_CONTEXT_INFO set to false).\n"
+              << "  --key               Context key of the value, defaults to session_id\n"
+              << "  --extra-identifier  The value is the extra identifier of the records instead\n"
+              << "  --list              Only list the segments which may contain the value\n";
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string key = "session_id";
+    bool list_only = false;
+    std::vector<std::string> arguments;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--key") == 0 && i + 1 < argc)
+        {
+            key = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--extra-identifier") == 0)
+        {
+            key = octo::logger::LogBloomFilter::EXTRA_IDENTIFIER_KEY;
+        }
+        else if (std::strcmp(argv[i], "--list") == 0)
+        {
+            list_only = true;
+        }
+        else if (std::strcmp(argv[i], "--help") == 0 || argv[i][0] == '-')
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            arguments.emplace_back(argv[i]);
+        }
+    }
+    if (arguments.size() < 2)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+    std::string const& value = arguments.front();
+
+    int result = 0;
+    std::size_t searched = 0;
+    for (auto itr = arguments.cbegin() + 1; itr != arguments.cend(); ++itr)
+    {
+        octo::logger::LogBloomFilter filter(0);
+        if (filter.load(octo::logger::LogBloomFilter::filter_path(*itr)) && !filter.may_contain(key, value))
+        {
+            continue;
+        }
+        ++searched;
+        if (list_only)
+        {
+            std::cout << *itr << "\n";
+        }
+        else if (!print_matching_records(*itr, value))
+        {
+            std::cerr << "Failed to open segment [" << *itr << "]" << std::endl;
+            result = 1;
+        }
+    }
+    std::cerr << "Searched " << searched << " of " << arguments.size() - 1 << " segments" << std::endl;
+    std::cout.flush();
+    return std::cout ? result : 1;
+}
@@ -0,0 +1,188 @@
+/**
+ * @file log-merge.cpp
+ * @brief Merges per-thread FileSink shards (FILE_SHARD_PER_THREAD) into one timestamp ordered stream
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/log-timestamp-parser.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace
+{
+class ShardReader
+{
+  private:
+    std::ifstream in_;
+    octo::logger::LogTimestampParser parser_;
+    std::string lookahead_;
+    std::int64_t lookahead_timestamp_;
+    bool has_lookahead_;
+
+    bool read_line(std::string& line)
+    {
+        return static_cast<bool>(std::getline(in_, line));
+    }
+
+  public:
+    ShardReader(std::string const& path, bool utc)
+        : in_(path), parser_(utc), lookahead_timestamp_(std::numeric_limits<std::int64_t>::min()), has_lookahead_(false)
+    {
+        has_lookahead_ = read_line(lookahead_);
+        if (has_lookahead_)
+        {
+            // Lines before the first record (e.g. a shard that starts mid-record) are emitted first
+            lookahead_timestamp_ = parser_.parse(lookahead_).value_or(std::numeric_limits<std::int64_t>::min());
+        }
+    }
+
+    [[nodiscard]] bool is_open() const
+    {
+        return in_.is_open();
+    }
+
+    /**
+     * @brief Reads the next record, which is a timestamped line followed by its continuation lines.
+     */
+    bool next(std::string& record, std::int64_t& timestamp)
+    {
+        if (!has_lookahead_)
+        {
+            return false;
+        }
+        record = std::move(lookahead_);
+        record += '\n';
+        timestamp = lookahead_timestamp_;
+        has_lookahead_ = false;
+        std::string line;
+        while (read_line(line))
+        {
+            if (auto const line_timestamp = parser_.parse(line))
+            {
+                lookahead_ = std::move(line);
+                lookahead_timestamp_ = *line_timestamp;
+                has_lookahead_ = true;
+                break;
+            }
+            record += line;
+            record += '\n';
+        }
+        return true;
+    }
+};
+
+struct PendingRecord
+{
+    std::int64_t timestamp;
+    std::size_t shard;
+    std::string record;
+};
+
+struct PendingRecordCmp
+{
+    bool operator()(PendingRecord const& lhs, PendingRecord const& rhs) const
+    {
+        // Min-heap on the timestamp, ties keep the order of the shards on the command line
+        if (lhs.timestamp != rhs.timestamp)
+        {
+            return lhs.timestamp > rhs.timestamp;
+        }
+        return lhs.shard > rhs.shard;
+    }
+};
+
+void print_usage(char const* name)
+{
+    std::cerr << "Usage: " << name << " [--utc] [--output <file>] <shard>...\n"
+              << "Merges FileSink shard files (PLAINTEXT_LONG or JSON) into one stream ordered by timestamp.\n"
+              << "  --utc     Plaintext timestamps were written in UTC (USE_SAFE_LOCALTIME_UTC)\n"
+              << "  --output  Write to a file instead of stdout\n";
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bool utc = false;
+    std::string output_path;
+    std::vector<std::string> shard_paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--utc") == 0)
+        {
+            utc = true;
+        }
+        else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+        {
+            output_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--help") == 0 || argv[i][0] == '-')
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            shard_paths.emplace_back(argv[i]);
+        }
+    }
+    if (shard_paths.empty())
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::ofstream output_file;
+    if (!output_path.empty())
+    {
+        output_file.open(output_path, std::ofstream::out | std::ofstream::trunc);
+        if (!output_file.is_open())
+        {
+            std::cerr << "Failed to open output file [" << output_path << "]" << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = output_path.empty() ? std::cout : output_file;
+
+    std::vector<std::unique_ptr<ShardReader>> shards;
+    std::priority_queue<PendingRecord, std::vector<PendingRecord>, PendingRecordCmp> pending;
+    for (auto const& path : shard_paths)
+    {
+        auto shard = std::make_unique<ShardReader>(path, utc);
+        if (!shard->is_open())
+        {
+            std::cerr << "Failed to open shard [" << path << "]" << std::endl;
+            return 1;
+        }
+        PendingRecord record{0, shards.size(), {}};
+        if (shard->next(record.record, record.timestamp))
+        {
+            pending.push(std::move(record));
+        }
+        shards.push_back(std::move(shard));
+    }
+
+    while (!pending.empty())
+    {
+        // priority_queue::top is const, the record is moved out before popping
+        auto& top = const_cast<PendingRecord&>(pending.top());
+        PendingRecord record{0, top.shard, std::move(top.record)};
+        pending.pop();
+        out << record.record;
+        if (shards[record.shard]->next(record.record, record.timestamp))
+        {
+            pending.push(std::move(record));
+        }
+    }
+    out.flush();
+    return out ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file log-seek.cpp
+ * @brief Prints the records of FileSink segments within a time range, seeking with their time index (.idx) sidecars
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/log-time-index.hpp"
+#include "octo-logger-cpp/log-timestamp-parser.hpp"
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+void print_usage(char const* name)
+{
+    std::cerr << "Usage: " << name << " [--utc] --from <time> --to <time> <segment>...\n"
+              << "Prints the records of FileSink segments (PLAINTEXT_LONG or JSON) within [from, to].\n"
+              << "Segments written with FILE_TIME_INDEX_RECORDS or FILE_TIME_INDEX_BYTES are read from the indexed\n"
+              << "offsets, the rest are scanned whole.\n"
+              << "  <time>  \"dd/mm/YYYY HH:MM:SS[.mmm]\", \"YYYY-MM-DDTHH:MM:SS.mmm+HHMM\" or epoch milliseconds\n"
+              << "  --utc   Plaintext timestamps were written in UTC (USE_SAFE_LOCALTIME_UTC)\n";
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bool utc = false;
+    std::string from_argument;
+    std::string to_argument;
+    std::vector<std::string> segment_paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--utc") == 0)
+        {
+            utc = true;
+        }
+        else if (std::strcmp(argv[i], "--from") == 0 && i + 1 < argc)
+        {
+            from_argument = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--to") == 0 && i + 1 < argc)
+        {
+            to_argument = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--help") == 0 || argv[i][0] == '-')
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            segment_paths.emplace_back(argv[i]);
+        }
+    }
+    if (from_argument.empty() || to_argument.empty() || segment_paths.empty())
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+    octo::logger::LogTimestampParser parser(utc);
+    auto const from = parser.parse_argument(from_argument);
+    auto const to = parser.parse_argument(to_argument);
+    if (!from || !to)
+    {
+        std::cerr << "Invalid time [" << (from ? to_argument : from_argument) << "]" << std::endl;
+        return 1;
+    }
+
+    int result = 0;
+    for (auto const& path : segment_paths)
+    {
+        if (!octo::logger::LogTimeIndex::read_range(
+                path, *from, *to, utc, [](std::string_view record) { std::cout << record; }))
+        {
+            std::cerr << "Failed to open segment [" << path << "]" << std::endl;
+            result = 1;
+        }
+    }
+    std::cout.flush();
+    return std::cout ? result : 1;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file logq.cpp
+ * @brief Filters FileSink segments by level, channel, time range and substring, scanning memory mapped segments in
+ * parallel
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "octo-logger-cpp/log-query.hpp"
+#include "octo-logger-cpp/log-timestamp-parser.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+void print_usage(char const* name)
+{
+    std::cerr << "Usage: " << name << " [options] <segment>...\n"
+              << "Prints the records of FileSink segments (PLAINTEXT_LONG, PLAINTEXT_SHORT or JSON) matching all the\n"
+              << "given filters, in the order of the segments on the command line.\n"
+              << "  --level <level>    Minimum level (trace, debug, info, notice, warning, error)\n"
+              << "  --channel <name>   Channel name\n"
+              << "  --from <time>      Records at or after the time, seeking with the .idx sidecar if present\n"
+              << "  --to <time>        Records at or before the time\n"
+              << "  --grep <text>      Records containing the text, including their context info lines\n"
+              << "  --utc              Plaintext timestamps were written in UTC (USE_SAFE_LOCALTIME_UTC)\n"
+              << "  --threads <count>  Segments scanned in parallel, defaults to the number of cores\n"
+              << "  --count            Only print the number of matching records\n"
+              << "  <time>  \"dd/mm/YYYY HH:MM:SS[.mmm]\", \"YYYY-MM-DDTHH:MM:SS.mmm+HHMM\" or epoch milliseconds\n";
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    octo::logger::LogQuery query;
+    std::string from_argument;
+    std::string to_argument;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> segment_paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        bool const has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--level") == 0 && has_value)
+        {
+            if (!query.set_min_level(argv[++i]))
+            {
+                std::cerr << "Invalid level [" << argv[i] << "]" << std::endl;
+                return 1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--channel") == 0 && has_value)
+        {
+            query.channel = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--from") == 0 && has_value)
+        {
+            from_argument = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--to") == 0 && has_value)
+        {
+            to_argument = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--grep") == 0 && has_value)
+        {
+            query.needle = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && has_value)
+        {
+            threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        }
+        else if (std::strcmp(argv[i], "--utc") == 0)
+        {
+            query.utc = true;
+        }
+        else if (std::strcmp(argv[i], "--count") == 0)
+        {
+            query.count_only = true;
+        }
+        else if (std::strcmp(argv[i], "--help") == 0 || argv[i][0] == '-')
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            segment_paths.emplace_back(argv[i]);
+        }
+    }
+    if (segment_paths.empty())
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+    octo::logger::LogTimestampParser parser(query.utc);
+    for (auto const& [argument, value] : {std::make_pair(&from_argument, &query.from),
+                                          std::make_pair(&to_argument, &query.to)})
+    {
+        if (argument->empty())
+        {
+            continue;
+        }
+        *value = parser.parse_argument(*argument);
+        if (!*value)
+        {
+            std::cerr << "Invalid time [" << *argument << "]" << std::endl;
+            return 1;
+        }
+    }
+
+    int exit_code = 0;
+    std::uint64_t matches = 0;
+    auto const finish_segment = [&](std::size_t segment, octo::logger::LogQuery::Result const& result) {
+        if (!result.opened)
+        {
+            std::cerr << "Failed to open segment [" << segment_paths[segment] << "]" << std::endl;
+            exit_code = 1;
+            return;
+        }
+        matches += result.matches;
+    };
+    auto const print_chunk = [](std::string const& chunk) { std::cout.write(chunk.data(), chunk.size()); };
+
+    threads = std::min<unsigned>(threads, static_cast<unsigned>(segment_paths.size()));
+    if (threads == 1)
+    {
+        // The records are printed as they are found
+        for (std::size_t segment = 0; segment < segment_paths.size(); ++segment)
+        {
+            finish_segment(segment, query.scan_segment(segment_paths[segment], print_chunk));
+        }
+    }
+    else
+    {
+        /*
+         * Segments are scanned in parallel, and their records printed in order as they are found. The scan of a
+         * segment waits while it has MAX_QUEUED_CHUNKS chunks not printed yet, so the memory used is bounded by the
+         * number of threads rather than by the size of the output.
+         */
+        std::size_t constexpr MAX_QUEUED_CHUNKS = 4;
+        struct SegmentOutput
+        {
+            std::deque<std::string> chunks;
+            octo::logger::LogQuery::Result result;
+            bool done = false;
+        };
+        std::vector<SegmentOutput> outputs(segment_paths.size());
+        std::mutex outputs_mtx;
+        std::condition_variable outputs_cond;
+        std::atomic<std::size_t> next_segment(0);
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < threads; ++i)
+        {
+            workers.emplace_back([&]() {
+                std::size_t segment;
+                while ((segment = next_segment++) < segment_paths.size())
+                {
+                    SegmentOutput& output = outputs[segment];
+                    auto result = query.scan_segment(segment_paths[segment], [&](std::string&& chunk) {
+                        {
+                            std::unique_lock<std::mutex> lock(outputs_mtx);
+                            outputs_cond.wait(lock, [&]() { return output.chunks.size() < MAX_QUEUED_CHUNKS; });
+                            output.chunks.push_back(std::move(chunk));
+                        }
+                        outputs_cond.notify_all();
+                    });
+                    {
+                        std::lock_guard<std::mutex> lock(outputs_mtx);
+                        output.result = std::move(result);
+                        output.done = true;
+                    }
+                    outputs_cond.notify_all();
+                }
+            });
+        }
+
+        // The segments are scanned in the order they are printed in, so the one printed always has a thread
+        for (std::size_t segment = 0; segment < segment_paths.size(); ++segment)
+        {
+            SegmentOutput& output = outputs[segment];
+            while (true)
+            {
+                std::unique_lock<std::mutex> lock(outputs_mtx);
+                outputs_cond.wait(lock, [&]() { return !output.chunks.empty() || output.done; });
+                if (output.chunks.empty())
+                {
+                    break;
+                }
+                std::string const chunk = std::move(output.chunks.front());
+                output.chunks.pop_front();
+                lock.unlock();
+                outputs_cond.notify_all();
+                print_chunk(chunk);
+            }
+            finish_segment(segment, output.result);
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+    if (query.count_only)
+    {
+        std::cout << matches << "\n";
+    }
+    std::cout.flush();
+    return std::cout ? exit_code : 1;
+}
@@ -9,6 +9,7 @@
 #include "octo-logger-cpp/logger.hpp"
 #include "octo-logger-cpp/sink-config.hpp"
 #include "octo-logger-cpp/sink.hpp"
+#include <chrono>
 #include <string>
 #include <deque>
 
@@ -21,12 +22,14 @@ class DummySink : public Sink
     {
         std::string message;
         ContextInfo log_context_info;
+        ContextInfo scoped_context;
         ContextInfo context_info;
         const ContextInfo* context_info_addr;
         ContextInfo global_context_info;
         const ContextInfo* global_context_info_addr;
         std::string channel_name;
         std::string log_level;
+        std::chrono::time_point<std::chrono::system_clock> time_created;
     };
 
   private:
@@ -59,12 +62,14 @@ class DummySink : public Sink
     {
         dumped_logs_.push_front(DumpedLog{.message = log.str(),
                                           .log_context_info = log.context_info(),
+                                          .scoped_context = log.scoped_context(),
                                           .context_info = context_info,
                                           .context_info_addr = &context_info,
                                           .global_context_info = global_context_info,
                                           .global_context_info_addr = &global_context_info,
                                           .channel_name = channel.channel_name(),
-                                          .log_level = LogLevelUtils::level_to_string(log.log_level())});
+                                          .log_level = LogLevelUtils::level_to_string(log.log_level()),
+                                          .time_created = log.time_created()});
     }
 };
 } // namespace octo::logger::unittests
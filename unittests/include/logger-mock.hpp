@@ -29,7 +29,7 @@ class Logger::LoggerMock : public Logger
 
     ContextInfo& context_info_getter()
     {
-        return Logger::context_info_;
+        return *Logger::context_info_;
     }
 
     ChannelView& channel_view_getter()
@@ -0,0 +1,102 @@
+/**
+ * @file clock-tests.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <catch2/catch_all.hpp>
+
+#include "dummy-sink.hpp"
+#include "octo-logger-cpp/clock.hpp"
+#include "octo-logger-cpp/logger.hpp"
+#include "octo-logger-cpp/manager.hpp"
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace
+{
+class ClockTestsFixture
+{
+  public:
+    std::shared_ptr<octo::logger::unittests::DummySink> dummy_sink_;
+
+    ClockTestsFixture() : dummy_sink_(std::make_shared<octo::logger::unittests::DummySink>())
+    {
+        octo::logger::ManagerConfigPtr manager_config = std::make_shared<octo::logger::ManagerConfig>();
+        manager_config->add_custom_sink(dummy_sink_);
+        octo::logger::Manager::instance().configure(manager_config);
+    }
+
+    ~ClockTestsFixture()
+    {
+        octo::logger::Manager::reset_manager();
+    }
+};
+
+std::chrono::milliseconds distance(octo::logger::Clock::TimePoint lhs, octo::logger::Clock::TimePoint rhs)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(lhs > rhs ? lhs - rhs : rhs - lhs);
+}
+} // namespace
+
+TEST_CASE_METHOD(ClockTestsFixture, "Records are timestamped by the fake clock when they are created", "[clock]")
+{
+    octo::logger::Clock::TimePoint const start(std::chrono::seconds(1760000000));
+    auto const fake_clock = std::make_shared<octo::logger::FakeClock>(start);
+    octo::logger::Manager::instance().set_clock(fake_clock);
+    octo::logger::Logger logger("clock-tests");
+
+    {
+        auto log = logger.info();
+        // Time spent formatting the record doesn't move its timestamp
+        fake_clock->advance(std::chrono::seconds(5));
+        log << "first";
+    }
+    logger.info() << "second";
+    REQUIRE(dummy_sink_->logs().size() == 2);
+    REQUIRE(dummy_sink_->logs()[1].time_created == start);
+    REQUIRE(dummy_sink_->logs()[0].time_created == start + std::chrono::seconds(5));
+
+    fake_clock->set_step(std::chrono::milliseconds(1));
+    logger.info() << "third";
+    logger.info() << "fourth";
+    REQUIRE(dummy_sink_->logs()[0].time_created - dummy_sink_->logs()[1].time_created == std::chrono::milliseconds(1));
+
+    octo::logger::Manager::instance().set_clock(nullptr);
+    logger.info() << "system";
+    REQUIRE(distance(dummy_sink_->last_log().time_created, std::chrono::system_clock::now()) <
+            std::chrono::seconds(1));
+}
+
+TEST_CASE_METHOD(ClockTestsFixture, "Configured clocks follow the system clock", "[clock]")
+{
+    for (auto const clock_type : {octo::logger::Clock::ClockType::SYSTEM,
+                                  octo::logger::Clock::ClockType::REALTIME_COARSE,
+                                  octo::logger::Clock::ClockType::TSC})
+    {
+        DYNAMIC_SECTION("clock " << static_cast<int>(clock_type))
+        {
+            auto manager_config = std::make_shared<octo::logger::ManagerConfig>();
+            manager_config->add_custom_sink(dummy_sink_);
+            manager_config->set_option(octo::logger::ManagerConfig::LoggerOption::CLOCK, clock_type);
+            octo::logger::Manager::instance().configure(manager_config);
+            octo::logger::Logger logger("clock-tests");
+
+            auto previous = octo::logger::Clock::TimePoint::min();
+            for (int i = 0; i < 20; ++i)
+            {
+                logger.info() << "record " << i;
+                auto const time_created = dummy_sink_->last_log().time_created;
+                // The coarse clock is a tick behind, the TSC clock is calibrated to a few microseconds
+                REQUIRE(distance(time_created, std::chrono::system_clock::now()) < std::chrono::milliseconds(50));
+                REQUIRE(time_created >= previous);
+                previous = time_created;
+                std::this_thread::sleep_for(std::chrono::milliseconds(60));
+            }
+        }
+    }
+}
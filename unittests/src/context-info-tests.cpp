@@ -0,0 +1,181 @@
+/**
+ * @file context-info-tests.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <catch2/catch_all.hpp>
+
+#include "octo-logger-cpp/context-info.hpp"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using octo::logger::ContextInfo;
+
+namespace
+{
+std::map<std::string, std::string> to_map(ContextInfo const& context_info)
+{
+    std::map<std::string, std::string> result;
+    for (auto const& [key, value] : context_info)
+    {
+        result.emplace(std::string(key), value.to_string());
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("ContextInfo keeps its entries sorted by key id", "[context_info]")
+{
+    ContextInfo context_info;
+    std::map<std::string, std::string> expected;
+    // Past the inline capacity, and back
+    for (int i = 0; i < 20; ++i)
+    {
+        std::string const key = "ctx_test_key_" + std::to_string((i * 7) % 20);
+        context_info.update(key, std::to_string(i));
+        expected[key] = std::to_string(i);
+        REQUIRE(to_map(context_info) == expected);
+    }
+    REQUIRE(context_info.size() == 20);
+    ContextInfo::ContextInfoKeyId previous = 0;
+    bool first = true;
+    for (auto itr = context_info.begin(); itr != context_info.end(); ++itr)
+    {
+        REQUIRE((first || itr.entry().id > previous));
+        previous = itr.entry().id;
+        first = false;
+    }
+    for (int i = 0; i < 20; i += 2)
+    {
+        std::string const key = "ctx_test_key_" + std::to_string(i);
+        context_info.erase(key);
+        expected.erase(key);
+        REQUIRE_FALSE(context_info.contains(key));
+    }
+    REQUIRE(to_map(context_info) == expected);
+    REQUIRE_THROWS_AS(context_info.at("ctx_test_key_0"), std::out_of_range);
+    REQUIRE(context_info.at("ctx_test_key_1") == expected["ctx_test_key_1"]);
+    context_info.clear();
+    REQUIRE(context_info.empty());
+    REQUIRE(context_info.begin() == context_info.end());
+}
+
+TEST_CASE("ContextInfo owns its keys", "[context_info]")
+{
+    ContextInfo context_info;
+    {
+        std::string key("ctx_test_temporary_key");
+        context_info.update(key, "value");
+        key.assign("overwritten key buffer");
+    }
+    REQUIRE(context_info.contains("ctx_test_temporary_key"));
+    REQUIRE(context_info.begin()->first == "ctx_test_temporary_key");
+}
+
+TEST_CASE("ContextInfo finds keys interned by other threads after a miss", "[context_info]")
+{
+    ContextInfo context_info{{"ctx_test_present", "1"}};
+    REQUIRE_FALSE(context_info.contains("ctx_test_interned_later"));
+    ContextInfo::ContextInfoKeyId id = 0;
+    std::thread([&context_info, &id]() {
+        context_info.update("ctx_test_interned_later", "2");
+        id = ContextInfo::intern("ctx_test_interned_later");
+    }).join();
+    REQUIRE(context_info.contains("ctx_test_interned_later"));
+    REQUIRE(context_info.at("ctx_test_interned_later") == "2");
+    REQUIRE(context_info.entry(id) != nullptr);
+    REQUIRE(context_info.entry(id)->key == "ctx_test_interned_later");
+    REQUIRE(context_info.entry(ContextInfo::intern("ctx_test_never_set")) == nullptr);
+}
+
+TEST_CASE("ContextInfo equality and initialization follow map semantics", "[context_info]")
+{
+    ContextInfo const first{{"ctx_test_a", "1"}, {"ctx_test_b", "2"}, {"ctx_test_a", "ignored"}};
+    ContextInfo const second{{"ctx_test_b", "2"}, {"ctx_test_a", "1"}};
+    REQUIRE(first == second);
+    REQUIRE(first.at("ctx_test_a") == "1");
+    ContextInfo updated(first);
+    updated.update(ContextInfo{{"ctx_test_b", "3"}, {"ctx_test_c", "4"}});
+    REQUIRE(to_map(updated) ==
+            std::map<std::string, std::string>{{"ctx_test_a", "1"}, {"ctx_test_b", "3"}, {"ctx_test_c", "4"}});
+    REQUIRE_FALSE(updated == first);
+}
+
+TEST_CASE("ContextInfo merge yields each key once from the highest precedence context", "[context_info]")
+{
+    ContextInfo const log{{"ctx_merge_shared", "log"}, {"ctx_merge_log", "log"}};
+    ContextInfo const logger{{"ctx_merge_shared", "logger"}, {"ctx_merge_logger", "logger"}};
+    ContextInfo global{{"ctx_merge_shared", "global"}, {"ctx_merge_logger", "global"}};
+    for (int i = 0; i < 10; ++i)
+    {
+        global.update("ctx_merge_global_" + std::to_string(i), "global");
+    }
+    std::map<std::string, std::string> merged;
+    std::vector<ContextInfo::ContextInfoKeyId> ids;
+    ContextInfo::merge({&log, &logger, &global}, [&](ContextInfo::Entry const& entry) {
+        REQUIRE(merged.emplace(std::string(entry.key), entry.value.to_string()).second);
+        ids.push_back(entry.id);
+    });
+    REQUIRE(std::is_sorted(ids.begin(), ids.end()));
+    REQUIRE(merged.size() == 13);
+    REQUIRE(merged["ctx_merge_shared"] == "log");
+    REQUIRE(merged["ctx_merge_logger"] == "logger");
+    REQUIRE(merged["ctx_merge_global_3"] == "global");
+}
+
+TEST_CASE("ContextInfo values keep their type until they are formatted", "[context_info]")
+{
+    ContextInfo const context_info{{"ctx_typed_int", -42},
+                                   {"ctx_typed_uint", 42U},
+                                   {"ctx_typed_double", 0.5},
+                                   {"ctx_typed_bool", true},
+                                   {"ctx_typed_string", std::string("text")}};
+    REQUIRE(context_info.at("ctx_typed_int").type() == octo::logger::ContextValue::Type::INT64);
+    REQUIRE(context_info.at("ctx_typed_uint").type() == octo::logger::ContextValue::Type::UINT64);
+    REQUIRE(context_info.at("ctx_typed_double").type() == octo::logger::ContextValue::Type::DOUBLE);
+    REQUIRE(context_info.at("ctx_typed_bool").type() == octo::logger::ContextValue::Type::BOOL);
+    REQUIRE(context_info.at("ctx_typed_string").type() == octo::logger::ContextValue::Type::STRING);
+    REQUIRE(to_map(context_info) == std::map<std::string, std::string>{{"ctx_typed_int", "-42"},
+                                                                       {"ctx_typed_uint", "42"},
+                                                                       {"ctx_typed_double", "0.5"},
+                                                                       {"ctx_typed_bool", "true"},
+                                                                       {"ctx_typed_string", "text"}});
+    // Values of different types are different, even when they read the same
+    REQUIRE_FALSE(ContextInfo{{"ctx_typed_int", 1}} == ContextInfo{{"ctx_typed_int", "1"}});
+    REQUIRE(context_info.at("ctx_typed_int") == "-42");
+}
+
+TEST_CASE("ContextInfo fragments are rendered once and dropped on modification", "[context_info]")
+{
+    ContextInfo context_info{{"ctx_fragment_a", "1"}, {"ctx_fragment_b", 2}};
+    auto const* fragments = &context_info.fragments();
+    REQUIRE(fragments->plaintext == "[ctx_fragment_a:1][ctx_fragment_b:2]");
+    REQUIRE(&context_info.fragments() == fragments);
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+    REQUIRE(fragments->json_valid);
+    REQUIRE(fragments->json_keys == std::vector<std::string>{"\"ctx_fragment_a\"", "\"ctx_fragment_b\""});
+    REQUIRE(fragments->json_values == std::vector<std::string>{"\"1\"", "2"});
+#endif
+
+    context_info.update("ctx_fragment_a", "3");
+    REQUIRE(context_info.fragments().plaintext == "[ctx_fragment_a:3][ctx_fragment_b:2]");
+    context_info.erase("ctx_fragment_b");
+    REQUIRE(context_info.fragments().plaintext == "[ctx_fragment_a:3]");
+
+    ContextInfo copy(context_info);
+    copy.update("ctx_fragment_c", true);
+    REQUIRE(copy.fragments().plaintext == "[ctx_fragment_a:3][ctx_fragment_c:true]");
+    REQUIRE(context_info.fragments().plaintext == "[ctx_fragment_a:3]");
+    context_info = copy;
+    REQUIRE(context_info.fragments().plaintext == copy.fragments().plaintext);
+    context_info.clear();
+    REQUIRE(context_info.fragments().plaintext.empty());
+}
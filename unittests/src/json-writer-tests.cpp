@@ -0,0 +1,317 @@
+/**
+ * @file json-writer-tests.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <catch2/catch_all.hpp>
+
+#include "log-mock.hpp"
+#include "logger-mock.hpp"
+#include "octo-logger-cpp/json-writer.hpp"
+#include "octo-logger-cpp/sink.hpp"
+#include <nlohmann/json.hpp>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+class JsonTestSink : public octo::logger::Sink
+{
+  public:
+    explicit JsonTestSink(std::string const& origin)
+        : Sink(octo::logger::SinkConfig("json_test_sink", octo::logger::SinkConfig::SinkType::CONSOLE_JSON_SINK),
+               origin,
+               LineFormat::JSON)
+    {
+    }
+
+    void dump(octo::logger::Log const&,
+              octo::logger::Channel const&,
+              octo::logger::ContextInfo const&,
+              octo::logger::ContextInfo const&) override
+    {
+    }
+
+    std::optional<std::string> streamed(octo::logger::Log const& log,
+                                        octo::logger::Channel const& channel,
+                                        octo::logger::ContextInfo const& context_info,
+                                        octo::logger::ContextInfo const& global_context_info,
+                                        int indent,
+                                        std::string const& host,
+                                        std::string const& service,
+                                        std::string const& thread_id) const
+    {
+        std::string out;
+        if (!write_log_json(out,
+                            log,
+                            channel,
+                            context_info,
+                            global_context_info,
+                            indent,
+                            octo::logger::JsonWriter::encode_string(host),
+                            octo::logger::JsonWriter::encode_string(service),
+                            thread_id))
+        {
+            return std::nullopt;
+        }
+        return out;
+    }
+
+    // The document ConsoleJSONSink used to build
+    std::string dom(octo::logger::Log const& log,
+                    octo::logger::Channel const& channel,
+                    octo::logger::ContextInfo const& context_info,
+                    octo::logger::ContextInfo const& global_context_info,
+                    int indent,
+                    std::string const& host,
+                    std::string const& service,
+                    std::string const& thread_id) const
+    {
+        nlohmann::json log_json(construct_log_json(log, channel, context_info, global_context_info));
+        log_json["host"] = host;
+        log_json["service"] = service;
+        if (!thread_id.empty())
+        {
+            log_json["context_info"]["thread_id"] = thread_id;
+        }
+        return log_json.dump(indent);
+    }
+};
+
+std::optional<std::string> nlohmann_string(std::string const& value)
+{
+    try
+    {
+        return nlohmann::json(value).dump();
+    }
+    catch (nlohmann::json::exception const&)
+    {
+        return std::nullopt;
+    }
+}
+
+std::optional<std::string> writer_string(std::string const& value, octo::logger::JsonWriter::ScanKernel kernel)
+{
+    std::string out;
+    if (!octo::logger::JsonWriter::append_string(out, value, kernel))
+    {
+        return std::nullopt;
+    }
+    return out;
+}
+
+std::vector<octo::logger::JsonWriter::ScanKernel> supported_kernels()
+{
+    std::vector<octo::logger::JsonWriter::ScanKernel> kernels;
+    for (auto const kernel : {octo::logger::JsonWriter::ScanKernel::SCALAR,
+                              octo::logger::JsonWriter::ScanKernel::SSE2,
+                              octo::logger::JsonWriter::ScanKernel::AVX2})
+    {
+        if (octo::logger::JsonWriter::scan_kernel_supported(kernel))
+        {
+            kernels.push_back(kernel);
+        }
+    }
+    return kernels;
+}
+} // namespace
+
+TEST_CASE("JSON writer escapes strings like nlohmann::json", "[json-writer]")
+{
+    std::vector<std::string> values{
+        "",
+        "plain",
+        "quote \" backslash \\ slash /",
+        "\b\f\n\r\t",
+        std::string("nul \0 byte", 10),
+        "\x01\x1f\x7f",
+        "two \xc3\xa9 three \xe2\x82\xac four \xf0\x9f\x98\x80",
+        "\xef\xbf\xbf \xf4\x8f\xbf\xbf",
+        // Invalid: overlong, surrogate, above U+10FFFF, truncated, stray continuation and lead bytes
+        "\xc0\x80",
+        "\xe0\x80\x80",
+        "\xed\xa0\x80",
+        "\xf4\x90\x80\x80",
+        "\xe2\x82",
+        "\x80",
+        "\xff",
+    };
+    for (int c = 0; c < 0x80; ++c)
+    {
+        values.emplace_back(1, static_cast<char>(c));
+    }
+    // Values long enough to go through the vector loops, with the special byte at every position of a block
+    std::string const clean(70, 'a');
+    for (std::size_t pos = 0; pos < clean.size(); ++pos)
+    {
+        for (std::string const special : {"\"", "\\", "\n", "\x1f", "\xc3\xa9", "\xff"})
+        {
+            values.push_back(clean.substr(0, pos) + special + clean.substr(pos));
+        }
+    }
+
+    // Random bytes biased towards clean runs and the bytes around the escaping and UTF-8 boundaries
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> length_dist(0, 100);
+    std::uniform_int_distribution<int> byte_dist(0, 255);
+    std::vector<unsigned char> const interesting{0x00, 0x1f, 0x20, 0x22, 0x5c, 0x7e, 0x7f, 0x80,
+                                                 0xbf, 0xc2, 0xdf, 0xe0, 0xed, 0xef, 0xf0, 0xf4};
+    for (int i = 0; i < 20000; ++i)
+    {
+        std::string value;
+        int const length = length_dist(rng);
+        for (int j = 0; j < length; ++j)
+        {
+            int const byte = byte_dist(rng);
+            if (byte < 224)
+            {
+                value += static_cast<char>('a' + byte % 26);
+            }
+            else
+            {
+                value += static_cast<char>(byte < 240 ? interesting[byte % interesting.size()] : byte);
+            }
+        }
+        values.push_back(std::move(value));
+    }
+
+    for (auto const kernel : supported_kernels())
+    {
+        DYNAMIC_SECTION("kernel " << static_cast<int>(kernel))
+        {
+            for (auto const& value : values)
+            {
+                CAPTURE(value);
+                REQUIRE(writer_string(value, kernel) == nlohmann_string(value));
+            }
+        }
+    }
+}
+
+TEST_CASE("Streamed log JSON matches the nlohmann::json document", "[json-writer]")
+{
+    octo::logger::ContextInfo const context_info{{"shared", "logger"}, {"logger_key", "logger \"value\""}};
+    octo::logger::ContextInfo const global_context_info{
+        {"shared", "global"}, {"global_key", "global\tvalue"}, {"session_id", "global session"}};
+    for (int indent : {-1, 0, 4})
+    {
+        for (bool const with_extra_id : {false, true})
+        {
+            for (bool const with_context : {false, true})
+            {
+                DYNAMIC_SECTION("indent " << indent << " extra id " << with_extra_id << " context " << with_context)
+                {
+                    octo::logger::unittests::LoggerMock logger_mock;
+                    octo::logger::unittests::LogMock log_mock(octo::logger::LogLevel::WARNING,
+                                                              with_extra_id ? "session \xe2\x82\xac" : "",
+                                                              {{"shared", "log"}, {"log_key", "log\nvalue"}},
+                                                              logger_mock);
+                    log_mock << "message with \"quotes\", \\ and \x01 control";
+                    JsonTestSink const sink("origin/\xc3\xa9");
+                    auto const& channel = logger_mock.logger_channel();
+                    octo::logger::ContextInfo const empty;
+                    auto const& ci = with_context ? context_info : empty;
+                    auto const& gci = with_context ? global_context_info : empty;
+                    for (std::string const thread_id : {"", "140234"})
+                    {
+                        CAPTURE(thread_id);
+                        auto const streamed = sink.streamed(log_mock, channel, ci, gci, indent, "host", "svc", thread_id);
+                        REQUIRE(streamed.has_value());
+                        REQUIRE(*streamed == sink.dom(log_mock, channel, ci, gci, indent, "host", "svc", thread_id));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Streamed log JSON rejects invalid UTF-8", "[json-writer]")
+{
+    octo::logger::unittests::LoggerMock logger_mock;
+    octo::logger::unittests::LogMock log_mock(octo::logger::LogLevel::INFO, "", {}, logger_mock);
+    log_mock << "bad \xff byte";
+    JsonTestSink const sink("origin");
+    REQUIRE_FALSE(sink.streamed(log_mock, logger_mock.logger_channel(), {}, {}, -1, "", "", "").has_value());
+    REQUIRE_THROWS_AS(sink.dom(log_mock, logger_mock.logger_channel(), {}, {}, -1, "", "", ""),
+                      nlohmann::json::exception);
+}
+
+TEST_CASE("JSON writer formats doubles like nlohmann::json", "[json-writer]")
+{
+    std::vector<double> values{0.0,
+                               -0.0,
+                               1.0,
+                               -1.5,
+                               0.1,
+                               1e-4,
+                               1e-5,
+                               123456789012345.0,
+                               1234567890123456.0,
+                               1e15,
+                               1e16,
+                               1e21,
+                               1.7976931348623157e308,
+                               4.9406564584124654e-324,
+                               2.2250738585072014e-308,
+                               3.14159,
+                               std::numeric_limits<double>::infinity(),
+                               -std::numeric_limits<double>::infinity(),
+                               std::numeric_limits<double>::quiet_NaN()};
+    std::mt19937_64 rng(4321);
+    std::uniform_real_distribution<double> real_dist(-1e6, 1e6);
+    std::uniform_int_distribution<int> exponent_dist(-30, 30);
+    for (int i = 0; i < 20000; ++i)
+    {
+        values.push_back(real_dist(rng) * std::pow(10.0, exponent_dist(rng)));
+        std::uint64_t const bits = rng();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        values.push_back(value);
+    }
+    for (double const value : values)
+    {
+        CAPTURE(value);
+        std::string out;
+        octo::logger::JsonWriter::append_number(out, value);
+        REQUIRE(out == nlohmann::json(value).dump());
+    }
+}
+
+TEST_CASE("Streamed log JSON writes typed context values natively", "[json-writer]")
+{
+    octo::logger::unittests::LoggerMock logger_mock;
+    octo::logger::unittests::LogMock log_mock(octo::logger::LogLevel::INFO,
+                                              "",
+                                              {{"count", 42},
+                                               {"negative", -7},
+                                               {"big", std::uint64_t(18446744073709551615ULL)},
+                                               {"ratio", 0.25},
+                                               {"enabled", true},
+                                               {"name", "text"}},
+                                              logger_mock);
+    log_mock << "typed";
+    JsonTestSink const sink("origin");
+    auto const& channel = logger_mock.logger_channel();
+    octo::logger::ContextInfo const global_context_info{{"count", "shadowed"}, {"global_flag", false}};
+    for (int indent : {-1, 4})
+    {
+        auto const streamed = sink.streamed(log_mock, channel, {}, global_context_info, indent, "", "", "");
+        REQUIRE(streamed.has_value());
+        REQUIRE(*streamed == sink.dom(log_mock, channel, {}, global_context_info, indent, "", "", ""));
+    }
+    auto const document = nlohmann::json::parse(*sink.streamed(log_mock, channel, {}, global_context_info, -1, "", "", ""));
+    REQUIRE(document["context_info"]["count"] == 42);
+    REQUIRE(document["context_info"]["big"].is_number_unsigned());
+    REQUIRE(document["context_info"]["enabled"] == true);
+    REQUIRE(document["context_info"]["global_flag"] == false);
+    REQUIRE(document["context_info"]["ratio"] == 0.25);
+}
@@ -0,0 +1,130 @@
+/**
+ * @file line-layout-tests.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <catch2/catch_all.hpp>
+
+#include "log-mock.hpp"
+#include "logger-mock.hpp"
+#include "octo-logger-cpp/line-layout.hpp"
+#include "octo-logger-cpp/sink.hpp"
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+namespace layout = octo::logger::layout;
+
+using LongLayout = layout::Layout<layout::Timestamp<layout::Millis>,
+                                  layout::Level<layout::Short>,
+                                  layout::ChannelName,
+                                  layout::Pid,
+                                  layout::Tid,
+                                  layout::ExtraId,
+                                  layout::Message,
+                                  layout::Context>;
+using HotLayout = layout::Layout<layout::Timestamp<layout::Nanos>,
+                                 layout::Level<layout::Long>,
+                                 layout::ChannelName,
+                                 layout::Tid,
+                                 layout::Message>;
+
+static_assert(LongLayout::USES_TIME && LongLayout::USES_CONTEXT_INFO);
+static_assert(!layout::Layout<layout::Level<>, layout::Message>::USES_TIME);
+static_assert(HotLayout::MAX_FIXED_SIZE == 31 + 9 + 2 + 7 + 2);
+
+class LayoutTestSink : public octo::logger::Sink
+{
+  private:
+    static octo::logger::SinkConfig make_config(std::string const& layout_name)
+    {
+        octo::logger::SinkConfig config("layout_test_sink", octo::logger::SinkConfig::SinkType::CONSOLE_SINK);
+        config.set_option(octo::logger::SinkConfig::SinkOption::USE_SAFE_LOCALTIME_UTC, true);
+        if (!layout_name.empty())
+        {
+            config.set_option(octo::logger::SinkConfig::SinkOption::LINE_LAYOUT, layout_name);
+        }
+        return config;
+    }
+
+  public:
+    explicit LayoutTestSink(std::string const& layout_name = "")
+        : Sink(make_config(layout_name), "origin", LineFormat::PLAINTEXT_LONG)
+    {
+    }
+
+    void dump(octo::logger::Log const&,
+              octo::logger::Channel const&,
+              octo::logger::ContextInfo const&,
+              octo::logger::ContextInfo const&) override
+    {
+    }
+
+    std::string line(octo::logger::Log const& log,
+                     octo::logger::Channel const& channel,
+                     octo::logger::ContextInfo const& context_info,
+                     octo::logger::ContextInfo const& global_context_info,
+                     bool disable_context_info) const
+    {
+        return formatted_log(log, channel, context_info, global_context_info, disable_context_info);
+    }
+};
+} // namespace
+
+TEST_CASE("Line layouts match the plaintext format they spell out", "[line-layout]")
+{
+    octo::logger::LineLayout::register_layout("long", std::make_shared<LongLayout>());
+    LayoutTestSink const plaintext_sink;
+    LayoutTestSink const layout_sink("long");
+    octo::logger::ContextInfo const context_info{{"logger_key", "logger value"}};
+    octo::logger::ContextInfo const empty;
+    for (bool const with_extra_id : {false, true})
+    {
+        for (bool const with_context : {false, true})
+        {
+            for (bool const disable_context_info : {false, true})
+            {
+                DYNAMIC_SECTION("extra id " << with_extra_id << " context " << with_context << " disabled "
+                                            << disable_context_info)
+                {
+                    octo::logger::unittests::LoggerMock logger_mock;
+                    octo::logger::unittests::LogMock log_mock(
+                        octo::logger::LogLevel::ERROR, with_extra_id ? "session" : "", {}, logger_mock);
+                    log_mock << "message";
+                    auto const& channel = logger_mock.logger_channel();
+                    auto const& ci = with_context ? context_info : empty;
+                    REQUIRE(layout_sink.line(log_mock, channel, ci, empty, disable_context_info) ==
+                            plaintext_sink.line(log_mock, channel, ci, empty, disable_context_info));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Line layouts reserve the whole line up front", "[line-layout]")
+{
+    octo::logger::unittests::LoggerMock logger_mock;
+    octo::logger::unittests::LogMock log_mock(octo::logger::LogLevel::WARNING, "", {}, logger_mock);
+    log_mock << "some message";
+    struct tm const timeinfo = {};
+    octo::logger::LayoutRecord const record{
+        log_mock, logger_mock.logger_channel(), &timeinfo, 123456789, "4321", "140000", {}};
+    std::string line;
+    HotLayout::format(line, record);
+    REQUIRE(line.rfind("[00/01/1900 00:00:00.123456789][warning][", 0) == 0);
+    REQUIRE(line.size() <= line.capacity());
+    REQUIRE(line.size() <= HotLayout::MAX_FIXED_SIZE + logger_mock.logger_channel().channel_name().size() +
+                               record.thread_id.size() + log_mock.str().size());
+}
+
+TEST_CASE("Unknown line layouts are rejected", "[line-layout]")
+{
+    REQUIRE(octo::logger::LineLayout::find_layout("no such layout") == nullptr);
+    REQUIRE_THROWS_AS(LayoutTestSink("no such layout"), std::runtime_error);
+}
@@ -0,0 +1,208 @@
+/**
+ * @file line-pattern-tests.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <catch2/catch_all.hpp>
+
+#include "log-mock.hpp"
+#include "logger-mock.hpp"
+#include "octo-logger-cpp/compat.hpp"
+#include "octo-logger-cpp/line-pattern.hpp"
+#include "octo-logger-cpp/log-level.hpp"
+#include "octo-logger-cpp/sink.hpp"
+#include <iomanip>
+#include <pthread.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+class PatternTestSink : public octo::logger::Sink
+{
+  private:
+    static octo::logger::SinkConfig make_config(std::string const& pattern)
+    {
+        octo::logger::SinkConfig config("pattern_test_sink", octo::logger::SinkConfig::SinkType::CONSOLE_SINK);
+        config.set_option(octo::logger::SinkConfig::SinkOption::USE_SAFE_LOCALTIME_UTC, true);
+        if (!pattern.empty())
+        {
+            config.set_option(octo::logger::SinkConfig::SinkOption::LINE_PATTERN, pattern);
+        }
+        return config;
+    }
+
+  public:
+    explicit PatternTestSink(LineFormat format, std::string const& pattern = "")
+        : Sink(make_config(pattern), "origin", format)
+    {
+    }
+
+    void dump(octo::logger::Log const&,
+              octo::logger::Channel const&,
+              octo::logger::ContextInfo const&,
+              octo::logger::ContextInfo const&) override
+    {
+    }
+
+    std::string line(octo::logger::Log const& log,
+                     octo::logger::Channel const& channel,
+                     octo::logger::ContextInfo const& context_info,
+                     octo::logger::ContextInfo const& global_context_info,
+                     bool disable_context_info) const
+    {
+        return formatted_log(log, channel, context_info, global_context_info, disable_context_info);
+    }
+
+    // The stringstream layouts the predefined patterns replace
+    std::string reference(octo::logger::Log const& log,
+                          octo::logger::Channel const& channel,
+                          octo::logger::ContextInfo const& context_info,
+                          octo::logger::ContextInfo const& global_context_info,
+                          bool disable_context_info) const
+    {
+        std::stringstream ss;
+        auto const ms = std::chrono::duration_cast<std::chrono::milliseconds>(log.time_created().time_since_epoch());
+        std::string extra_id;
+        if (!log.extra_identifier().empty())
+        {
+            extra_id = "[" + log.extra_identifier() + "]";
+        }
+        if (line_format_ == LineFormat::PLAINTEXT_SHORT)
+        {
+            ss << "[MS(" << std::setfill('0') << std::setw(3) << ms.count() % 1000 << ")]["
+               << octo::logger::LogLevelUtils::level_to_string_short(log.log_level()) << "][" << channel.channel_name()
+               << "][TID(" << std::this_thread::get_id() << ")]" << extra_id << ": " << log.str();
+            return ss.str();
+        }
+        std::time_t const time = std::chrono::duration_cast<std::chrono::seconds>(ms).count();
+        struct tm timeinfo = {};
+        gmtime_r(&time, &timeinfo);
+        char date[32];
+        std::strftime(date, sizeof(date), "[%d/%m/%Y %H:%M:%S", &timeinfo);
+        ss << date << "." << std::setfill('0') << std::setw(3) << ms.count() % 1000 << "]["
+           << octo::logger::LogLevelUtils::level_to_string_short(log.log_level()) << "][" << channel.channel_name()
+           << "][PID(" << getpid() << ")][TID(" << std::this_thread::get_id() << ")]" << extra_id << ": " << log.str();
+        if (!disable_context_info &&
+            !(context_info.empty() && log.context_info().empty() && global_context_info.empty()))
+        {
+            ss << "\n" << formatted_context_info(log, channel, context_info, global_context_info);
+        }
+        return ss.str();
+    }
+};
+} // namespace
+
+TEST_CASE("Predefined line patterns match the plaintext formats", "[line-pattern]")
+{
+    octo::logger::ContextInfo const context_info{{"logger_key", "logger value"}};
+    octo::logger::ContextInfo const global_context_info{{"global_key", "global value"}};
+    octo::logger::ContextInfo const empty;
+    for (auto const format : {octo::logger::Sink::LineFormat::PLAINTEXT_LONG,
+                              octo::logger::Sink::LineFormat::PLAINTEXT_SHORT})
+    {
+        for (bool const with_extra_id : {false, true})
+        {
+            for (bool const with_context : {false, true})
+            {
+                for (bool const disable_context_info : {false, true})
+                {
+                    DYNAMIC_SECTION("format " << static_cast<int>(format) << " extra id " << with_extra_id
+                                              << " context " << with_context << " disabled "
+                                              << disable_context_info)
+                    {
+                        octo::logger::unittests::LoggerMock logger_mock;
+                        octo::logger::unittests::LogMock log_mock(octo::logger::LogLevel::NOTICE,
+                                                                  with_extra_id ? "session" : "",
+                                                                  {},
+                                                                  logger_mock);
+                        log_mock << "message with 100% of the text";
+                        PatternTestSink const sink(format);
+                        auto const& channel = logger_mock.logger_channel();
+                        auto const& ci = with_context ? context_info : empty;
+                        auto const& gci = with_context ? global_context_info : empty;
+                        REQUIRE(sink.line(log_mock, channel, ci, gci, disable_context_info) ==
+                                sink.reference(log_mock, channel, ci, gci, disable_context_info));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Line patterns compile flags and literals", "[line-pattern]")
+{
+    using OpType = octo::logger::LinePattern::OpType;
+    octo::logger::LinePattern const pattern("%T 100%% %q %l: %v%");
+    std::vector<OpType> types;
+    for (auto const& op : pattern.ops())
+    {
+        types.push_back(op.type);
+    }
+    REQUIRE(types == std::vector<OpType>{OpType::HOURS,
+                                         OpType::LITERAL,
+                                         OpType::MINUTES,
+                                         OpType::LITERAL,
+                                         OpType::SECONDS,
+                                         OpType::LITERAL,
+                                         OpType::LEVEL,
+                                         OpType::LITERAL,
+                                         OpType::MESSAGE,
+                                         OpType::LITERAL});
+    // "%%" and the unknown "%q" are merged into the surrounding literal
+    REQUIRE(pattern.literal(pattern.ops()[5]) == " 100% %q ");
+    REQUIRE(pattern.literal(pattern.ops()[9]) == "%");
+    REQUIRE(pattern.uses_time());
+    REQUIRE_FALSE(octo::logger::LinePattern("%l %v").uses_time());
+}
+
+TEST_CASE("Custom line patterns format every flag", "[line-pattern]")
+{
+    octo::logger::unittests::LoggerMock logger_mock;
+    octo::logger::unittests::LogMock log_mock(octo::logger::LogLevel::WARNING, "id", {}, logger_mock);
+    log_mock << "text";
+    auto const& channel = logger_mock.logger_channel();
+    PatternTestSink const sink(octo::logger::Sink::LineFormat::PLAINTEXT_LONG,
+                               "%Y-%m-%dT%H:%M:%S.%F%z|%e|%f|%L|%l|%n|%i|%I|%P|%v%c");
+    std::string const line = sink.line(log_mock, channel, {}, {}, false);
+
+    auto const ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(log_mock.time_created().time_since_epoch()).count();
+    std::time_t const time = ns / 1000000000;
+    struct tm timeinfo = {};
+    gmtime_r(&time, &timeinfo);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &timeinfo);
+    std::ostringstream expected;
+    expected << date << "." << std::setfill('0') << std::setw(9) << ns % 1000000000 << "+0000|" << std::setw(3)
+             << ns % 1000000000 / 1000000 << "|" << std::setw(6) << ns % 1000000000 / 1000 << "|W|warning|"
+             << channel.channel_name() << "|id|[id]|" << getpid() << "|text";
+    REQUIRE(line == expected.str());
+}
+
+TEST_CASE("Thread and process ids are cached per thread and process", "[line-pattern]")
+{
+    octo::logger::unittests::LoggerMock logger_mock;
+    PatternTestSink const sink(octo::logger::Sink::LineFormat::PLAINTEXT_LONG, "%P|%t|%N");
+    std::string line;
+    std::string expected;
+    std::thread thread([&] {
+        pthread_setname_np(pthread_self(), "pattern-worker");
+        octo::logger::unittests::LogMock log_mock(octo::logger::LogLevel::INFO, "", {}, logger_mock);
+        line = sink.line(log_mock, logger_mock.logger_channel(), {}, {}, false);
+        std::ostringstream oss;
+        oss << getpid() << "|" << std::this_thread::get_id() << "|pattern-worker";
+        expected = oss.str();
+    });
+    thread.join();
+    REQUIRE(line == expected);
+
+    octo::logger::compat::refresh_process_id();
+    REQUIRE(octo::logger::compat::process_id_string() == std::to_string(getpid()));
+}
@@ -1,11 +1,16 @@
 #include <catch2/catch_all.hpp>
 #include "octo-logger-cpp/compat.hpp"
+#include "octo-logger-cpp/time-zone.hpp"
+#include <cstring>
 #include <ctime>
 #include <cstdlib>
 #include <chrono>
 #include <iomanip>
 #include <thread>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
 
 TEST_CASE("gmtime_safe matches std::gmtime", "[compat][gmtime]") {
     using namespace std::chrono;
@@ -104,6 +109,117 @@ TEST_CASE_METHOD(SetUTCTimezoneFixture, "Stringify compat::localtime with std::p
     }
 }
 
+// Sets TZ for the scope of a test, restoring the original value after it
+struct ScopedTimezone {
+    std::optional<std::string> old_tz;
+
+    explicit ScopedTimezone(std::string const& tz) {
+        const char* current = getenv("TZ");
+        if (current) {
+            old_tz = current;
+        }
+        setenv("TZ", tz.c_str(), 1);
+        tzset();
+    }
+
+    ~ScopedTimezone() {
+        if (old_tz) {
+            setenv("TZ", old_tz->c_str(), 1);
+        } else {
+            unsetenv("TZ");
+        }
+        tzset();
+    }
+};
+
+void require_same_local_time(octo::logger::TimeZone const& zone, std::time_t t) {
+    std::tm expected = {};
+    REQUIRE(localtime_r(&t, &expected) != nullptr);
+    std::tm actual = {};
+    zone.to_local(t, &actual);
+    CAPTURE(t);
+    REQUIRE(actual.tm_sec == expected.tm_sec);
+    REQUIRE(actual.tm_min == expected.tm_min);
+    REQUIRE(actual.tm_hour == expected.tm_hour);
+    REQUIRE(actual.tm_mday == expected.tm_mday);
+    REQUIRE(actual.tm_mon == expected.tm_mon);
+    REQUIRE(actual.tm_year == expected.tm_year);
+    REQUIRE(actual.tm_wday == expected.tm_wday);
+    REQUIRE(actual.tm_yday == expected.tm_yday);
+    REQUIRE(actual.tm_isdst == expected.tm_isdst);
+    REQUIRE(actual.tm_gmtoff == expected.tm_gmtoff);
+    REQUIRE(std::strcmp(actual.tm_zone, expected.tm_zone) == 0);
+}
+
+TEST_CASE("TimeZone matches localtime_r over decades", "[compat][localtime][time-zone]") {
+    std::vector<std::string> const zones{
+        "UTC",
+        "Europe/Berlin",
+        "America/New_York",
+        "America/Sao_Paulo",
+        "Australia/Lord_Howe",
+        "Asia/Kolkata",
+        "Pacific/Chatham",
+        // POSIX TZ strings, which have no zoneinfo file
+        "EST5EDT,M3.2.0/2,M11.1.0/2",
+        "<-03>3",
+        "NZST-12NZDT,M9.5.0,M4.1.0/3",
+        "CST6CDT",
+    };
+    std::time_t constexpr BEGIN = 0;               // 1970-01-01
+    std::time_t constexpr END = 4102444800;        // 2100-01-01, well past the last transition in the files
+    // A day and a bit, which drifts through every time of day over the years and can't skip over a DST period
+    std::time_t constexpr STEP = 24 * 60 * 60 + 7;
+    for (auto const& name : zones) {
+        DYNAMIC_SECTION(name) {
+            ScopedTimezone const scoped_tz(name);
+            octo::logger::TimeZone zone;
+            REQUIRE(zone.load(name));
+
+            std::tm previous = {};
+            std::time_t previous_t = BEGIN;
+            localtime_r(&previous_t, &previous);
+            for (std::time_t t = BEGIN; t < END; t += STEP) {
+                require_same_local_time(zone, t);
+                std::tm current = {};
+                localtime_r(&t, &current);
+                if (current.tm_gmtoff != previous.tm_gmtoff || current.tm_isdst != previous.tm_isdst) {
+                    // Find the exact transition and check both sides of it
+                    std::time_t low = previous_t;
+                    std::time_t high = t;
+                    while (high - low > 1) {
+                        std::time_t const mid = low + (high - low) / 2;
+                        std::tm mid_tm = {};
+                        localtime_r(&mid, &mid_tm);
+                        if (mid_tm.tm_gmtoff == previous.tm_gmtoff && mid_tm.tm_isdst == previous.tm_isdst) {
+                            low = mid;
+                        } else {
+                            high = mid;
+                        }
+                    }
+                    require_same_local_time(zone, low);
+                    require_same_local_time(zone, high);
+                }
+                previous = current;
+                previous_t = t;
+            }
+        }
+    }
+}
+
+TEST_CASE("TimeZone falls back to UTC for unknown zones", "[compat][localtime][time-zone]") {
+    octo::logger::TimeZone zone;
+    REQUIRE_FALSE(zone.load("No/Such_Zone"));
+    std::tm tm_time = {};
+    zone.to_local(86400 + 3661, &tm_time);
+    REQUIRE(tm_time.tm_year == 70);
+    REQUIRE(tm_time.tm_mday == 2);
+    REQUIRE(tm_time.tm_hour == 1);
+    REQUIRE(tm_time.tm_min == 1);
+    REQUIRE(tm_time.tm_sec == 1);
+    REQUIRE(tm_time.tm_gmtoff == 0);
+}
+
 TEST_CASE("Performance: gmtime_safe vs localtime_safe", "[compat][gmtime][localtime][performance]") {
     constexpr int N = 1'000'000;
     std::time_t const now = std::time(nullptr);
@@ -128,7 +244,15 @@ TEST_CASE("Performance: gmtime_safe vs localtime_safe", "[compat][gmtime][localt
     t2 = std::chrono::high_resolution_clock::now();
     auto const localtime_duration = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
 
-    std::cout << "gmtime_safe: " << gmtime_duration << " ms, localtime_safe: " << localtime_duration << " ms" << std::endl;
+    t1 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < N; ++i) {
+        octo::logger::compat::localtime(&times[i], &tm_buf, octo::logger::compat::LocaltimeMode::SAFE_LOCAL);
+    }
+    t2 = std::chrono::high_resolution_clock::now();
+    auto const time_zone_duration = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+
+    std::cout << "gmtime_safe: " << gmtime_duration << " ms, localtime_safe: " << localtime_duration
+              << " ms, time zone: " << time_zone_duration << " ms" << std::endl;
     // Not a correctness test, just for timing
     REQUIRE(true);
 }
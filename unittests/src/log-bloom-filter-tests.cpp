@@ -0,0 +1,70 @@
+/**
+ * @file log-bloom-filter-tests.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <catch2/catch_all.hpp>
+
+#include "octo-logger-cpp/log-bloom-filter.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+TEST_CASE("Bloom filter has no false negatives and few false positives", "[log-bloom-filter]")
+{
+    int constexpr ITEMS = 5000;
+    octo::logger::LogBloomFilter filter(64 * 1024);
+    for (int i = 0; i < ITEMS; ++i)
+    {
+        filter.insert("session_id", "present-" + std::to_string(i));
+    }
+    REQUIRE(filter.items() == ITEMS);
+    for (int i = 0; i < ITEMS; ++i)
+    {
+        REQUIRE(filter.may_contain("session_id", "present-" + std::to_string(i)));
+    }
+    int false_positives = 0;
+    for (int i = 0; i < ITEMS; ++i)
+    {
+        false_positives += filter.may_contain("session_id", "absent-" + std::to_string(i)) ? 1 : 0;
+    }
+    // ~13 bits per item with 7 hashes is well under 1%
+    REQUIRE(false_positives < ITEMS / 100);
+}
+
+TEST_CASE("Bloom filter round trips through its file and merges", "[log-bloom-filter]")
+{
+    char path_template[] = "/tmp/octo-bloom-tests-XXXXXX";
+    int const fd = mkstemp(path_template);
+    REQUIRE(fd >= 0);
+    close(fd);
+    std::string const path = path_template;
+
+    octo::logger::LogBloomFilter first(1024);
+    first.insert("tenant_id", "first");
+    REQUIRE(first.save(path));
+
+    octo::logger::LogBloomFilter loaded(0);
+    REQUIRE(loaded.load(path));
+    REQUIRE(loaded.bits() == 1024);
+    REQUIRE(loaded.items() == 1);
+    REQUIRE(loaded.may_contain("tenant_id", "first"));
+    REQUIRE_FALSE(loaded.may_contain("tenant_id", "second"));
+
+    octo::logger::LogBloomFilter second(1024);
+    second.insert("tenant_id", "second");
+    REQUIRE(second.merge(loaded));
+    REQUIRE(second.may_contain("tenant_id", "first"));
+    REQUIRE(second.may_contain("tenant_id", "second"));
+    REQUIRE_FALSE(second.merge(octo::logger::LogBloomFilter(2048)));
+
+    // A filter which is not (or not yet fully) written is rejected
+    truncate(path.c_str(), 40);
+    REQUIRE_FALSE(loaded.load(path));
+    std::remove(path.c_str());
+}
@@ -0,0 +1,180 @@
+/**
+ * @file log-limiter-tests.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <catch2/catch_all.hpp>
+
+#include "octo-logger-cpp/clock.hpp"
+#include "octo-logger-cpp/log-limiter.hpp"
+#include "octo-logger-cpp/logger.hpp"
+#include "octo-logger-cpp/manager.hpp"
+#include "octo-logger-cpp/sink.hpp"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Keeps the message and the suppressed count of every record
+class LimitedCaptureSink : public octo::logger::Sink
+{
+  private:
+    static octo::logger::SinkConfig make_config()
+    {
+        octo::logger::SinkConfig config("limited_capture_sink", octo::logger::SinkConfig::SinkType::CUSTOM_SINK);
+        config.set_option(octo::logger::SinkConfig::SinkOption::LINE_PATTERN, std::string("%v"));
+        return config;
+    }
+
+  public:
+    std::vector<std::string> lines;
+    std::vector<std::string> suppressed;
+
+    LimitedCaptureSink() : Sink(make_config(), "origin", LineFormat::PLAINTEXT_LONG)
+    {
+    }
+
+    void dump(octo::logger::Log const& log,
+              octo::logger::Channel const& channel,
+              octo::logger::ContextInfo const& context_info,
+              octo::logger::ContextInfo const& global_context_info) override
+    {
+        lines.push_back(formatted_log(log, channel, context_info, global_context_info, true));
+        auto const& record_context = log.context_info();
+        suppressed.push_back(record_context.contains(octo::logger::SUPPRESSED_CONTEXT_KEY)
+                                 ? record_context.at(octo::logger::SUPPRESSED_CONTEXT_KEY).to_string()
+                                 : "");
+    }
+};
+
+class LogLimiterTestsFixture
+{
+  public:
+    std::shared_ptr<LimitedCaptureSink> sink_;
+    std::shared_ptr<octo::logger::FakeClock> clock_;
+
+    LogLimiterTestsFixture()
+        : sink_(std::make_shared<LimitedCaptureSink>()),
+          clock_(std::make_shared<octo::logger::FakeClock>(octo::logger::Clock::TimePoint(std::chrono::hours(1))))
+    {
+        auto manager_config = std::make_shared<octo::logger::ManagerConfig>();
+        manager_config->add_custom_sink(sink_);
+        auto& manager = octo::logger::Manager::instance();
+        manager.configure(manager_config);
+        manager.set_log_level(octo::logger::LogLevel::INFO);
+        manager.set_clock(clock_);
+    }
+    ~LogLimiterTestsFixture()
+    {
+        octo::logger::Manager::reset_manager();
+    }
+};
+
+// Counts the calls, to check that suppressed records don't format their arguments
+struct Counted
+{
+    int* formatted;
+};
+} // namespace
+
+template <>
+struct fmt::formatter<Counted> : fmt::formatter<int>
+{
+    template <typename FormatContext>
+    auto format(Counted const& counted, FormatContext& ctx) const
+    {
+        return fmt::formatter<int>::format(++*counted.formatted, ctx);
+    }
+};
+
+TEST_CASE_METHOD(LogLimiterTestsFixture, "Every N logs the first of every N records", "[log-limiter]")
+{
+    octo::logger::Logger const logger("log-limiter-tests");
+    int formatted = 0;
+    for (int i = 0; i < 25; ++i)
+    {
+        OCTO_LOG_ERROR_EVERY_N(logger, 10, "record {} formatted {}", i, Counted{&formatted});
+    }
+    REQUIRE(sink_->lines == std::vector<std::string>{"record 0 formatted 1", "record 10 formatted 2",
+                                                     "record 20 formatted 3"});
+    REQUIRE(sink_->suppressed == std::vector<std::string>{"", "9", "9"});
+    REQUIRE(formatted == 3);
+
+    // Filtered records don't count
+    for (int i = 0; i < 5; ++i)
+    {
+        OCTO_LOG_DEBUG_EVERY_N(logger, 2, "debug {}", i);
+    }
+    REQUIRE(sink_->lines.size() == 3);
+}
+
+TEST_CASE_METHOD(LogLimiterTestsFixture, "Every ms logs one record per interval", "[log-limiter]")
+{
+    octo::logger::Logger const logger("log-limiter-tests");
+    auto const log = [&logger](int i) { OCTO_LOG_WARNING_EVERY_MS(logger, 1000, "record {}", i); };
+    log(0);
+    log(1);
+    clock_->advance(std::chrono::milliseconds(500));
+    log(2);
+    clock_->advance(std::chrono::milliseconds(500));
+    log(3);
+    log(4);
+    clock_->advance(std::chrono::seconds(5));
+    log(5);
+    REQUIRE(sink_->lines == std::vector<std::string>{"record 0", "record 3", "record 5"});
+    REQUIRE(sink_->suppressed == std::vector<std::string>{"", "2", "1"});
+}
+
+TEST_CASE_METHOD(LogLimiterTestsFixture, "Rate limits to a token bucket", "[log-limiter]")
+{
+    octo::logger::Logger const logger("log-limiter-tests");
+    auto const log = [&logger](int i) { OCTO_LOG_INFO_RATE(logger, 5/s, "record {}", i); };
+    // A burst of up to 5 records, then one every 200ms
+    for (int i = 0; i < 8; ++i)
+    {
+        log(i);
+    }
+    REQUIRE(sink_->lines.size() == 5);
+    clock_->advance(std::chrono::milliseconds(200));
+    log(8);
+    log(9);
+    REQUIRE(sink_->lines.size() == 6);
+    REQUIRE(sink_->lines.back() == "record 8");
+    REQUIRE(sink_->suppressed.back() == "3");
+    // Refilled after a second
+    clock_->advance(std::chrono::seconds(1));
+    for (int i = 10; i < 20; ++i)
+    {
+        log(i);
+    }
+    REQUIRE(sink_->lines.size() == 11);
+    REQUIRE(sink_->suppressed[6] == "1");
+}
+
+TEST_CASE_METHOD(LogLimiterTestsFixture, "Limiters are shared by the threads of a statement", "[log-limiter]")
+{
+    octo::logger::Logger const logger("log-limiter-tests");
+    auto const log = [&logger]() { OCTO_LOG_INFO_EVERY_N(logger, 100, "threaded"); };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&log]() {
+            for (int i = 0; i < 1000; ++i)
+            {
+                log();
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    REQUIRE(sink_->lines.size() == 40);
+}
@@ -0,0 +1,209 @@
+/**
+ * @file log-profiler-tests.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <catch2/catch_all.hpp>
+
+#include "octo-logger-cpp/log-profiler.hpp"
+#include "octo-logger-cpp/logger.hpp"
+#include "octo-logger-cpp/manager.hpp"
+#include "octo-logger-cpp/sink.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+#include <nlohmann/json.hpp>
+#endif
+
+namespace
+{
+class MessageSink : public octo::logger::Sink
+{
+  private:
+    static octo::logger::SinkConfig make_config()
+    {
+        octo::logger::SinkConfig config("message_sink", octo::logger::SinkConfig::SinkType::CUSTOM_SINK);
+        config.set_option(octo::logger::SinkConfig::SinkOption::LINE_PATTERN, std::string("%v"));
+        return config;
+    }
+
+  public:
+    std::vector<std::string> lines;
+
+    MessageSink() : Sink(make_config(), "origin", LineFormat::PLAINTEXT_LONG)
+    {
+    }
+
+    void dump(octo::logger::Log const& log,
+              octo::logger::Channel const& channel,
+              octo::logger::ContextInfo const& context_info,
+              octo::logger::ContextInfo const& global_context_info) override
+    {
+        lines.push_back(formatted_log(log, channel, context_info, global_context_info, true));
+    }
+};
+
+class LogProfilerTestsFixture
+{
+  public:
+    std::shared_ptr<MessageSink> sink_;
+
+    LogProfilerTestsFixture() : sink_(std::make_shared<MessageSink>())
+    {
+        auto manager_config = std::make_shared<octo::logger::ManagerConfig>();
+        manager_config->add_custom_sink(sink_);
+        auto& manager = octo::logger::Manager::instance();
+        manager.configure(manager_config);
+        manager.set_log_level(octo::logger::LogLevel::INFO);
+        manager.reset_log_profile();
+        manager.set_log_profiling(true);
+    }
+    ~LogProfilerTestsFixture()
+    {
+        octo::logger::Manager::instance().set_log_profiling(false);
+        octo::logger::Manager::reset_manager();
+    }
+};
+
+void noisy(octo::logger::Logger const& logger, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        OCTO_LOG_INFO(logger, "a noisy line number {}", i);
+    }
+}
+
+void quiet(octo::logger::Logger const& logger)
+{
+    OCTO_LOG_DEBUG(logger, "filtered");
+    OCTO_LOG_INFO(logger, "short");
+}
+
+octo::logger::LogProfiler::Entry const* find_entry(std::vector<octo::logger::LogProfiler::Entry> const& report,
+                                                   std::string_view function,
+                                                   std::string_view format)
+{
+    auto const itr = std::find_if(report.begin(), report.end(), [&](octo::logger::LogProfiler::Entry const& entry) {
+        return entry.site != nullptr && entry.site->function() == function && entry.site->format() == format;
+    });
+    return itr == report.end() ? nullptr : &*itr;
+}
+} // namespace
+
+TEST_CASE_METHOD(LogProfilerTestsFixture, "The profiler counts records and bytes per site", "[log-profiler]")
+{
+    auto& manager = octo::logger::Manager::instance();
+    octo::logger::Logger const logger("profiler-tests");
+    noisy(logger, 10);
+    quiet(logger);
+    quiet(logger);
+    logger.info() << "plain";
+
+    auto const report = manager.log_profile();
+    auto const* noisy_entry = find_entry(report, "noisy", "a noisy line number {}");
+    REQUIRE(noisy_entry != nullptr);
+    REQUIRE(noisy_entry == &report.front());
+    REQUIRE(noisy_entry->channel == "profiler-tests");
+    REQUIRE(noisy_entry->emitted == 10);
+    REQUIRE(noisy_entry->filtered == 0);
+    std::size_t noisy_bytes = 0;
+    for (std::size_t i = 0; i < 10; ++i)
+    {
+        noisy_bytes += sink_->lines[i].size();
+    }
+    REQUIRE(noisy_entry->bytes == noisy_bytes);
+    REQUIRE(noisy_entry->sink_bytes.size() == 1);
+    REQUIRE(noisy_entry->sink_bytes[0].first == "message_sink");
+    REQUIRE(noisy_entry->sink_bytes[0].second == noisy_bytes);
+
+    auto const* filtered_entry = find_entry(report, "quiet", "filtered");
+    REQUIRE(filtered_entry != nullptr);
+    REQUIRE(filtered_entry->emitted == 0);
+    REQUIRE(filtered_entry->filtered == 2);
+    REQUIRE(filtered_entry->bytes == 0);
+    REQUIRE(find_entry(report, "quiet", "short")->bytes == 2 * std::string("short").size());
+
+    // Records logged without the macros are counted per channel
+    auto const plain = std::find_if(report.begin(), report.end(), [](octo::logger::LogProfiler::Entry const& entry) {
+        return entry.site == nullptr && entry.channel == "profiler-tests";
+    });
+    REQUIRE(plain != report.end());
+    REQUIRE(plain->emitted == 1);
+    REQUIRE(plain->bytes == 5);
+
+    auto const top = manager.log_profile(2);
+    REQUIRE(top.size() == 2);
+    REQUIRE(top[0].site == noisy_entry->site);
+
+    manager.reset_log_profile();
+    REQUIRE(find_entry(manager.log_profile(), "noisy", "a noisy line number {}")->emitted == 0);
+}
+
+TEST_CASE_METHOD(LogProfilerTestsFixture, "The profiler keeps the counts of exited threads", "[log-profiler]")
+{
+    auto& manager = octo::logger::Manager::instance();
+    octo::logger::Logger const logger("profiler-tests");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&logger]() { quiet(logger); });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    quiet(logger);
+
+    auto const report = manager.log_profile();
+    REQUIRE(find_entry(report, "quiet", "filtered")->filtered == 5);
+    REQUIRE(find_entry(report, "quiet", "short")->emitted == 5);
+
+    // Disabled, nothing is counted
+    manager.set_log_profiling(false);
+    quiet(logger);
+    REQUIRE(find_entry(manager.log_profile(), "quiet", "short")->emitted == 5);
+}
+
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+TEST_CASE_METHOD(LogProfilerTestsFixture, "The profiler report is written periodically", "[log-profiler]")
+{
+    auto& manager = octo::logger::Manager::instance();
+    octo::logger::Logger const logger("profiler-tests");
+    std::string const path =
+        (std::filesystem::temp_directory_path() / "octo-logger-log-profiler-tests.json").string();
+    std::remove(path.c_str());
+
+    manager.start_log_profile_file(path, std::chrono::milliseconds(10), 1);
+    noisy(logger, 3);
+    quiet(logger);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE(std::filesystem::exists(path));
+    manager.stop_log_profile_file();
+
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    auto const report = nlohmann::json::parse(content.str());
+    REQUIRE(report["entries"].size() == 1);
+    auto const& entry = report["entries"][0];
+    REQUIRE(entry["function"] == "noisy");
+    REQUIRE(entry["format"] == "a noisy line number {}");
+    REQUIRE(entry["file"] == "log-profiler-tests.cpp");
+    REQUIRE(entry["channel"] == "profiler-tests");
+    REQUIRE(entry["emitted"] == 3);
+    REQUIRE(entry["sinks"]["message_sink"] == entry["bytes"]);
+    std::remove(path.c_str());
+}
+#endif
@@ -0,0 +1,242 @@
+/**
+ * @file log-query-tests.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <catch2/catch_all.hpp>
+
+#include "octo-logger-cpp/log-query.hpp"
+#include "octo-logger-cpp/log-time-index.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+using LineKind = octo::logger::LogQuery::LineKind;
+
+// 2024-02-29T13:45:07.089Z
+std::int64_t constexpr TEST_TIME_MS = 1709214307089;
+
+std::string long_line(std::string const& time, char level, std::string const& channel, std::string const& message)
+{
+    return "[29/02/2024 " + time + "][" + level + "][" + channel + "][PID(1)][TID(2)]: " + message + "\n";
+}
+
+std::size_t find(std::string const& haystack, std::string_view needle)
+{
+    char const* const begin = haystack.data();
+    char const* const end = begin + haystack.size();
+    return static_cast<std::size_t>(octo::logger::LogQuery::find_substring(begin, end, needle) - begin);
+}
+
+class TempSegment
+{
+  public:
+    std::string path_;
+
+    TempSegment()
+    {
+        char path_template[] = "/tmp/octo-log-query-tests-XXXXXX";
+        int const fd = mkstemp(path_template);
+        close(fd);
+        path_ = path_template;
+    }
+    ~TempSegment()
+    {
+        std::remove(path_.c_str());
+        std::remove(octo::logger::LogTimeIndex::index_path(path_).c_str());
+    }
+};
+} // namespace
+
+TEST_CASE("Substrings are found across and at the edges of 16 byte blocks", "[log-query]")
+{
+    for (std::size_t size : {2, 3, 15, 16, 17, 31, 40})
+    {
+        std::string needle;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            needle += static_cast<char>('a' + i % 26);
+        }
+        for (std::size_t haystack_size = size; haystack_size < 80; ++haystack_size)
+        {
+            for (std::size_t pos = 0; pos + size <= haystack_size; ++pos)
+            {
+                CAPTURE(size, haystack_size, pos);
+                std::string haystack(haystack_size, '.');
+                haystack.replace(pos, size, needle);
+                REQUIRE(find(haystack, needle) == pos);
+            }
+            // First and last bytes matching but not the middle, and a needle cut by the end of the buffer
+            std::string haystack(haystack_size, '.');
+            haystack.front() = needle.front();
+            haystack.back() = needle.back();
+            haystack.replace(haystack_size - size + 1, size - 1, needle.substr(0, size - 1));
+            CAPTURE(size, haystack_size, haystack);
+            REQUIRE(find(haystack, needle) == haystack_size);
+        }
+    }
+    std::string const haystack = "0123456789abcdefghij";
+    REQUIRE(find(haystack, "") == 0);
+    REQUIRE(find(haystack, "j") == haystack.size() - 1);
+    REQUIRE(find(haystack, "ij") == haystack.size() - 2);
+    REQUIRE(find(haystack, "0123456789abcdefghijk") == haystack.size());
+}
+
+TEST_CASE("Header lines are classified and their level and channel extracted", "[log-query]")
+{
+    std::string const long_header = "[29/02/2024 13:45:07.089][W][payments][PID(1)][TID(2)]: message";
+    REQUIRE(octo::logger::LogQuery::classify(long_header) == LineKind::PLAINTEXT_LONG);
+    REQUIRE(octo::logger::LogQuery::level(long_header, LineKind::PLAINTEXT_LONG) == 'W');
+    REQUIRE(octo::logger::LogQuery::channel_name(long_header, LineKind::PLAINTEXT_LONG) == "payments");
+
+    std::string const short_header = "[MS(089)][E][db][TID(2)]: short";
+    REQUIRE(octo::logger::LogQuery::classify(short_header) == LineKind::PLAINTEXT_SHORT);
+    REQUIRE(octo::logger::LogQuery::level(short_header, LineKind::PLAINTEXT_SHORT) == 'E');
+    REQUIRE(octo::logger::LogQuery::channel_name(short_header, LineKind::PLAINTEXT_SHORT) == "db");
+
+    std::string const json = R"({"log_level":"NOTICE","message":"m","origin_service_name":"api","timestamp":"x"})";
+    REQUIRE(octo::logger::LogQuery::classify(json) == LineKind::JSON);
+    REQUIRE(octo::logger::LogQuery::level(json, LineKind::JSON) == 'N');
+    REQUIRE(octo::logger::LogQuery::channel_name(json, LineKind::JSON) == "api");
+    REQUIRE(octo::logger::LogQuery::level(R"({"message":"m"})", LineKind::JSON) == 0);
+    REQUIRE(octo::logger::LogQuery::channel_name(R"({"message":"m"})", LineKind::JSON).empty());
+
+    REQUIRE(octo::logger::LogQuery::classify("context_info: [key:value]") == LineKind::CONTINUATION);
+    REQUIRE(octo::logger::LogQuery::classify("") == LineKind::CONTINUATION);
+    // Too short to hold the channel
+    REQUIRE(octo::logger::LogQuery::classify("[29/02/2024 13:45:07.089][W][") == LineKind::CONTINUATION);
+    REQUIRE(octo::logger::LogQuery::classify("[MS(089)][E][") == LineKind::CONTINUATION);
+}
+
+TEST_CASE("Records are filtered with their continuation lines", "[log-query]")
+{
+    std::string const data = "continued from the previous segment\n" + long_line("13:45:07.089", 'I', "api", "one") +
+                             "context_info: [tenant:a]\n" + long_line("13:45:08.000", 'E', "db", "two") +
+                             R"({"log_level":"ERROR","origin_service_name":"api","message":"three",)"
+                             R"("timestamp":"2024-02-29T13:45:09.000+0000"})" +
+                             "\n" + "[MS(089)][W][api][TID(2)]: four\n";
+
+    octo::logger::LogQuery query;
+    query.utc = true;
+    auto result = query.scan(data);
+    REQUIRE(result.matches == 5);
+    REQUIRE(result.output == data);
+
+    REQUIRE(query.set_min_level("error"));
+    query.count_only = true;
+    REQUIRE(query.scan(data).matches == 2);
+    query.count_only = false;
+    query.channel = "api";
+    result = query.scan(data);
+    REQUIRE(result.matches == 1);
+    REQUIRE(result.output.find("three") != std::string::npos);
+
+    octo::logger::LogQuery text_query;
+    text_query.needle = "tenant:a";
+    result = text_query.scan(data);
+    REQUIRE(result.matches == 1);
+    REQUIRE(result.output == long_line("13:45:07.089", 'I', "api", "one") + "context_info: [tenant:a]\n");
+    // The last record has no trailing new line
+    text_query.needle = "four";
+    REQUIRE(text_query.scan(data.substr(0, data.size() - 1)).output == "[MS(089)][W][api][TID(2)]: four\n");
+
+    octo::logger::LogQuery time_query;
+    time_query.utc = true;
+    time_query.from = TEST_TIME_MS + 500;
+    time_query.to = TEST_TIME_MS + 2000;
+    result = time_query.scan(data);
+    // PLAINTEXT_SHORT has no date
+    REQUIRE(result.matches == 2);
+    REQUIRE_FALSE(octo::logger::LogQuery().set_min_level("loud"));
+}
+
+TEST_CASE("Matching records are handed over in bounded chunks", "[log-query]")
+{
+    std::string data;
+    for (int record = 0; data.size() < 4 * octo::logger::LogQuery::OUTPUT_CHUNK_SIZE; ++record)
+    {
+        data += long_line("13:45:07.089", record % 2 == 0 ? 'I' : 'E', "api", "record " + std::to_string(record));
+    }
+
+    for (std::string const needle : {"", "api"})
+    {
+        CAPTURE(needle);
+        octo::logger::LogQuery query;
+        query.needle = needle;
+        REQUIRE(query.set_min_level("error"));
+        auto const expected = query.scan(data);
+
+        std::vector<std::string> chunks;
+        auto const result = query.scan(data, [&chunks](std::string&& chunk) { chunks.push_back(std::move(chunk)); });
+        REQUIRE(result.output.empty());
+        REQUIRE(result.matches == expected.matches);
+        REQUIRE(chunks.size() > 1);
+        std::string output;
+        for (auto const& chunk : chunks)
+        {
+            REQUIRE_FALSE(chunk.empty());
+            REQUIRE(chunk.size() < octo::logger::LogQuery::OUTPUT_CHUNK_SIZE + 100);
+            output += chunk;
+        }
+        REQUIRE(output == expected.output);
+    }
+}
+
+TEST_CASE("Segments are sought with their time index", "[log-query]")
+{
+    TempSegment const segment;
+    std::vector<std::string> lines;
+    std::string data;
+    for (int second = 0; second < 6; ++second)
+    {
+        lines.push_back(long_line("13:45:0" + std::to_string(second) + ".000", 'I', "api", std::to_string(second)));
+        data += lines.back();
+    }
+    {
+        std::ofstream out(segment.path_);
+        out << data;
+    }
+
+    octo::logger::LogQuery query;
+    query.utc = true;
+    query.from = TEST_TIME_MS - 7089 + 2000;
+    query.to = TEST_TIME_MS - 7089 + 3000;
+    // Without an index the whole segment is scanned
+    auto result = query.scan_segment(segment.path_);
+    REQUIRE(result.opened);
+    REQUIRE(result.output == lines[2] + lines[3]);
+
+    // The index is trusted, the records it leaves out of the blocks it describes are never read
+    std::uint64_t const block_size = lines[0].size() + lines[1].size();
+    std::int64_t const base = TEST_TIME_MS - 7089;
+    std::vector<octo::logger::LogTimeIndex::Entry> const entries = {
+        {base + 0, base + 500, 0, lines[0].size()},
+        {base + 2000, base + 3000, block_size, 2 * block_size},
+        {base + 4000, base + 5000, 2 * block_size, data.size()},
+    };
+    {
+        std::ofstream out(octo::logger::LogTimeIndex::index_path(segment.path_), std::ofstream::binary);
+        out.write(reinterpret_cast<char const*>(entries.data()),
+                  static_cast<std::streamsize>(entries.size() * sizeof(entries[0])));
+    }
+    query.from = base + 1000;
+    query.to = base + 5000;
+    result = query.scan_segment(segment.path_);
+    REQUIRE(result.output == lines[2] + lines[3] + lines[4] + lines[5]);
+    query.from = base;
+    query.to = base + 1500;
+    result = query.scan_segment(segment.path_);
+    REQUIRE(result.output == lines[0]);
+
+    REQUIRE_FALSE(query.scan_segment(segment.path_ + ".missing").opened);
+}
@@ -0,0 +1,183 @@
+/**
+ * @file log-site-tests.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <catch2/catch_all.hpp>
+
+#include "octo-logger-cpp/log-site.hpp"
+#include "octo-logger-cpp/logger.hpp"
+#include "octo-logger-cpp/manager.hpp"
+#include "octo-logger-cpp/sink.hpp"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+#include <nlohmann/json.hpp>
+#endif
+
+namespace
+{
+class SiteCaptureSink : public octo::logger::Sink
+{
+  private:
+    static octo::logger::SinkConfig make_config()
+    {
+        octo::logger::SinkConfig config("site_capture_sink", octo::logger::SinkConfig::SinkType::CUSTOM_SINK);
+        config.set_option(octo::logger::SinkConfig::SinkOption::LINE_PATTERN, std::string("%s:%#:%!|%L|%v"));
+        return config;
+    }
+
+  public:
+    std::vector<std::string> lines;
+    std::vector<std::string> json_lines;
+
+    SiteCaptureSink() : Sink(make_config(), "origin", LineFormat::PLAINTEXT_LONG)
+    {
+    }
+
+    void dump(octo::logger::Log const& log,
+              octo::logger::Channel const& channel,
+              octo::logger::ContextInfo const& context_info,
+              octo::logger::ContextInfo const& global_context_info) override
+    {
+        lines.push_back(formatted_log(log, channel, context_info, global_context_info, true));
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+        json_lines.push_back(formatted_log_json(log, channel, context_info, global_context_info));
+#endif
+    }
+};
+
+class LogSiteTestsFixture
+{
+  public:
+    std::shared_ptr<SiteCaptureSink> sink_;
+
+    LogSiteTestsFixture() : sink_(std::make_shared<SiteCaptureSink>())
+    {
+        auto manager_config = std::make_shared<octo::logger::ManagerConfig>();
+        manager_config->add_custom_sink(sink_);
+        octo::logger::Manager::instance().configure(manager_config);
+    }
+    ~LogSiteTestsFixture()
+    {
+        octo::logger::Manager::instance().clear_log_site_modes();
+        octo::logger::Manager::reset_manager();
+    }
+};
+
+void log_from_function(octo::logger::Logger const& logger, int value)
+{
+    OCTO_LOG_WARNING(logger, "value is {}", value);
+}
+
+void trace_from_function(octo::logger::Logger const& logger, int value)
+{
+    OCTO_LOG_TRACE(logger, "tracing {}", value);
+}
+
+void debug_from_function(octo::logger::Logger const& logger)
+{
+    OCTO_LOG_DEBUG(logger, "debugging");
+}
+} // namespace
+
+static_assert(octo::logger::LogSite::basename("/a/b/file.cpp") == "file.cpp");
+static_assert(octo::logger::LogSite::basename("C:\\a\\file.cpp") == "file.cpp");
+static_assert(octo::logger::LogSite::basename("file.cpp") == "file.cpp");
+static_assert(octo::logger::LogSite::make_id("a.cpp", 1) != octo::logger::LogSite::make_id("a.cpp", 2));
+
+TEST_CASE_METHOD(LogSiteTestsFixture, "Call sites carry their source location", "[log-site]")
+{
+    octo::logger::Logger const logger("log-site-tests");
+    int const line = __LINE__ + 1;
+    OCTO_LOG_INFO(logger, "hello {}", "world");
+    log_from_function(logger, 7);
+
+    REQUIRE(sink_->lines.size() == 2);
+    std::string const prefix = "log-site-tests.cpp:" + std::to_string(line) + ":";
+    REQUIRE(sink_->lines[0].compare(0, prefix.size(), prefix) == 0);
+    REQUIRE(sink_->lines[0].find("|I|hello world") != std::string::npos);
+    REQUIRE(sink_->lines[1].find("log-site-tests.cpp:") == 0);
+    REQUIRE(sink_->lines[1].find(":log_from_function|W|value is 7") != std::string::npos);
+
+    // Records logged without the macros have no location
+    logger.info() << "plain";
+    REQUIRE(sink_->lines[2] == "::|I|plain");
+
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+    auto const json = nlohmann::json::parse(sink_->json_lines[1]);
+    REQUIRE(json["origin_file"] == "log-site-tests.cpp");
+    REQUIRE(json["origin_func_name"] == "log_from_function");
+    REQUIRE(json["origin_line"].is_number_unsigned());
+    auto const plain_json = nlohmann::json::parse(sink_->json_lines[2]);
+    REQUIRE(plain_json["origin_func_name"] == "");
+    REQUIRE_FALSE(plain_json.contains("origin_file"));
+#endif
+}
+
+TEST_CASE_METHOD(LogSiteTestsFixture, "Call sites register once", "[log-site]")
+{
+    octo::logger::Logger const logger("log-site-tests");
+    for (int i = 0; i < 3; ++i)
+    {
+        log_from_function(logger, i);
+    }
+    auto const sites = octo::logger::LogSiteState::registered_sites();
+    auto const count = std::count_if(sites.begin(), sites.end(), [](octo::logger::LogSite const* site) {
+        return site->function() == "log_from_function";
+    });
+    REQUIRE(count == 1);
+    auto const site = *std::find_if(sites.begin(), sites.end(), [](octo::logger::LogSite const* site) {
+        return site->function() == "log_from_function";
+    });
+    REQUIRE(site->level() == octo::logger::LogLevel::WARNING);
+    REQUIRE(site->format() == "value is {}");
+}
+
+TEST_CASE_METHOD(LogSiteTestsFixture, "Call sites are enabled and disabled at runtime", "[log-site]")
+{
+    using octo::logger::LogSiteState;
+    auto& manager = octo::logger::Manager::instance();
+    manager.set_log_level(octo::logger::LogLevel::INFO);
+    octo::logger::Logger const logger("log-site-tests");
+
+    // A rule set before the site first runs applies when it registers
+    REQUIRE(manager.set_log_site_mode(LogSiteState::Match::FUNCTION, "trace_from_*", LogSiteState::Mode::ENABLED) ==
+            0);
+    trace_from_function(logger, 1);
+    debug_from_function(logger);
+    REQUIRE(sink_->lines.size() == 1);
+    REQUIRE(sink_->lines[0].find("|T|tracing 1") != std::string::npos);
+
+    // Rules apply to the registered sites, the channel level is untouched
+    auto const sites = LogSiteState::registered_sites();
+    auto const debug_site = *std::find_if(sites.begin(), sites.end(), [](octo::logger::LogSite const* site) {
+        return site->function() == "debug_from_function";
+    });
+    std::string const location = std::string(debug_site->file()) + ":" + std::to_string(debug_site->line());
+    REQUIRE(manager.set_log_site_mode(LogSiteState::Match::LOCATION, location, LogSiteState::Mode::ENABLED) == 1);
+    debug_from_function(logger);
+    logger.debug() << "still filtered";
+    REQUIRE(sink_->lines.size() == 2);
+    REQUIRE(sink_->lines[1].find("|D|debugging") != std::string::npos);
+
+    // The last matching rule wins, a disabled site is dropped whatever the channel level
+    REQUIRE(manager.set_log_site_mode(LogSiteState::Match::FORMAT, "tracing ?*", LogSiteState::Mode::DISABLED) == 1);
+    manager.set_log_site_mode(LogSiteState::Match::FORMAT, "value is {}", LogSiteState::Mode::DISABLED);
+    trace_from_function(logger, 2);
+    log_from_function(logger, 3);
+    REQUIRE(sink_->lines.size() == 2);
+
+    manager.clear_log_site_modes();
+    trace_from_function(logger, 4);
+    debug_from_function(logger);
+    log_from_function(logger, 5);
+    REQUIRE(sink_->lines.size() == 3);
+    REQUIRE(sink_->lines[2].find("|W|value is 5") != std::string::npos);
+}
@@ -0,0 +1,92 @@
+#include "octo-logger-cpp/log-timestamp-parser.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <optional>
+#include <string>
+
+namespace
+{
+// 2024-02-29T13:45:07.089Z
+std::int64_t constexpr TEST_TIME_MS = 1709214307089;
+
+class ScopedTimezone
+{
+  private:
+    std::optional<std::string> old_tz_;
+
+  public:
+    explicit ScopedTimezone(char const* tz)
+    {
+        if (char const* old_tz = std::getenv("TZ"))
+        {
+            old_tz_ = old_tz;
+        }
+        setenv("TZ", tz, 1);
+        tzset();
+    }
+    ~ScopedTimezone()
+    {
+        if (old_tz_)
+        {
+            setenv("TZ", old_tz_->c_str(), 1);
+        }
+        else
+        {
+            unsetenv("TZ");
+        }
+        tzset();
+    }
+};
+} // namespace
+
+TEST_CASE("Parse PLAINTEXT_LONG timestamps", "[log-timestamp-parser]")
+{
+    octo::logger::LogTimestampParser parser(true);
+
+    REQUIRE(parser.parse("[29/02/2024 13:45:07.089][I][channel][PID(1)][TID(2)]: message") == TEST_TIME_MS);
+    REQUIRE(parser.parse("[01/01/1970 00:00:00.000][E][c][PID(1)][TID(2)]: ") == 0);
+    REQUIRE_FALSE(parser.parse("context_info: [key:value]").has_value());
+    REQUIRE_FALSE(parser.parse("[MS(089)][I][channel][TID(2)]: short format").has_value());
+    REQUIRE_FALSE(parser.parse("[29/02/2024 13:45:07]").has_value());
+    REQUIRE_FALSE(parser.parse("").has_value());
+}
+
+TEST_CASE("Parse JSON timestamps", "[log-timestamp-parser]")
+{
+    octo::logger::LogTimestampParser parser;
+
+    REQUIRE(parser.parse(R"({"log_level":"INFO","message":"m","timestamp":"2024-02-29T13:45:07.089+0000"})") ==
+            TEST_TIME_MS);
+    REQUIRE(parser.parse(R"({"message":"m","timestamp":"2024-02-29T15:45:07.089+0200"})") == TEST_TIME_MS);
+    REQUIRE(parser.parse(R"({"message":"m","timestamp":"2024-02-29T08:15:07.089-0530"})") == TEST_TIME_MS);
+    REQUIRE_FALSE(parser.parse(R"({"message":"no timestamp"})").has_value());
+    REQUIRE_FALSE(parser.parse(R"({"timestamp":"2024-02-29 13:45:07"})").has_value());
+}
+
+TEST_CASE("Parse command line time arguments", "[log-timestamp-parser]")
+{
+    octo::logger::LogTimestampParser parser(true);
+
+    REQUIRE(parser.parse_argument("1709214307089") == TEST_TIME_MS);
+    REQUIRE(parser.parse_argument("29/02/2024 13:45:07.089") == TEST_TIME_MS);
+    REQUIRE(parser.parse_argument("29/02/2024 13:45:07") == TEST_TIME_MS - 89);
+    REQUIRE(parser.parse_argument("2024-02-29T15:45:07.089+0200") == TEST_TIME_MS);
+    REQUIRE_FALSE(parser.parse_argument("yesterday").has_value());
+    REQUIRE_FALSE(parser.parse_argument("").has_value());
+}
+
+TEST_CASE("Parse local timestamps around transitions which are not on whole hours", "[log-timestamp-parser]")
+{
+    // Chatham daylight saving time starts at 02:45 (+1245) and jumps to 03:45 (+1345)
+    ScopedTimezone const timezone("Pacific/Chatham");
+    octo::logger::LogTimestampParser parser;
+
+    // 2024-09-28T13:40:00Z
+    REQUIRE(parser.parse("[29/09/2024 02:25:00.000][I][channel][PID(1)][TID(2)]: before") == 1727530800000);
+    // 2024-09-28T14:05:00Z
+    REQUIRE(parser.parse("[29/09/2024 03:50:00.000][I][channel][PID(1)][TID(2)]: after") == 1727532300000);
+    REQUIRE(parser.parse("[29/09/2024 03:55:00.000][I][channel][PID(1)][TID(2)]: after") ==
+            1727532300000 + 5 * 60 * 1000);
+}
@@ -1,10 +1,13 @@
 #include "octo-logger-cpp/logger.hpp"
 #include "catch2-matchers.hpp"
 #include "octo-logger-cpp/manager.hpp"
+#include "octo-logger-cpp/scoped-context.hpp"
 #include "dummy-sink.hpp"
 #include <catch2/catch_all.hpp>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace
 {
@@ -183,3 +186,113 @@ TEST_CASE_METHOD(LoggingTestsFixture, "Logger Manager Global Context Info Tests"
         REQUIRE(dummy_sink_->last_log().global_context_info.contains("key5"));
     }
 }
+
+TEST_CASE_METHOD(LoggingTestsFixture, "Scoped Context Tests", "[logger]")
+{
+    using octo::logger::ScopedContext;
+    Logger logger("logging-tests");
+
+    SECTION("Records carry the scopes of their thread")
+    {
+        {
+            ScopedContext const outer{{"request_id", "outer"}, {"tenant", "tenant1"}};
+            {
+                ScopedContext const inner{{"request_id", "inner"}};
+                logger.info("inner");
+                REQUIRE(dummy_sink_->last_log().scoped_context.at("request_id") == "inner");
+                REQUIRE(dummy_sink_->last_log().scoped_context.at("tenant") == "tenant1");
+            }
+            logger.info("outer");
+            REQUIRE(dummy_sink_->last_log().scoped_context.at("request_id") == "outer");
+            std::thread([&logger] { logger.info("other thread"); }).join();
+            REQUIRE(dummy_sink_->last_log().scoped_context.empty());
+        }
+        logger.info("no scope");
+        REQUIRE(dummy_sink_->last_log().scoped_context.empty());
+        REQUIRE(ScopedContext::current().empty());
+    }
+}
+
+TEST_CASE_METHOD(LoggingTestsFixture, "Child Logger Tests", "[logger]")
+{
+    Logger parent("logging-tests");
+    parent.add_context_keys({{"key1", "value1"}, {"key2", "value2"}});
+    Logger child = parent.with({{"key2", "child2"}, {"key3", "value3"}});
+
+    SECTION("Children share the parent's context and channel")
+    {
+        REQUIRE(&child.logger_channel() == &parent.logger_channel());
+        REQUIRE(child.context_info().parent() == &parent.context_info());
+        REQUIRE(child.has_context_key("key1"));
+        child.info("Test log");
+        REQUIRE(dummy_sink_->last_log().context_info.flattened() ==
+                ContextInfo{{"key1", "value1"}, {"key2", "child2"}, {"key3", "value3"}});
+    }
+
+    SECTION("Changing the parent copies its context")
+    {
+        ContextInfo const* const shared = &parent.context_info();
+        parent.add_context_key("key1", "new_value1");
+        REQUIRE(&parent.context_info() != shared);
+        REQUIRE(child.context_info().parent() == shared);
+        REQUIRE(child.context_info().flattened().at("key1") == "value1");
+    }
+
+    SECTION("Removing an inherited key")
+    {
+        child.remove_context_key("key1");
+        REQUIRE_FALSE(child.has_context_key("key1"));
+        REQUIRE(child.context_info().parent() == nullptr);
+        REQUIRE(child.context_info() == ContextInfo{{"key2", "child2"}, {"key3", "value3"}});
+        REQUIRE(parent.has_context_key("key1"));
+    }
+
+    SECTION("Deep chains are flattened")
+    {
+        Logger descendant = child;
+        for (int i = 0; i < 10; ++i)
+        {
+            descendant = descendant.with({{"depth", i}});
+            REQUIRE(descendant.context_info().chain_depth() <= ContextInfo::MAX_CHAIN_DEPTH);
+        }
+        REQUIRE(descendant.context_info().flattened() ==
+                ContextInfo{{"key1", "value1"}, {"key2", "child2"}, {"key3", "value3"}, {"depth", 9}});
+    }
+
+    SECTION("Updates take the inherited entries")
+    {
+        ContextInfo const expected{{"key1", "value1"}, {"key2", "child2"}, {"key3", "value3"}};
+        ContextInfo copy;
+        copy.update(child.context_info());
+        REQUIRE(copy == expected);
+        // The parent's own context is one of the child's parents
+        parent.add_context_keys(child.context_info());
+        REQUIRE(parent.context_info() == expected);
+
+        auto& manager = octo::logger::Manager::instance();
+        manager.update_global_context_info(child.context_info());
+        REQUIRE(*manager.global_context_info() == expected);
+        manager.replace_global_context_info(child.context_info());
+        REQUIRE(manager.global_context_info()->parent() == nullptr);
+        REQUIRE(*manager.global_context_info() == expected);
+        manager.replace_global_context_info({});
+    }
+
+    SECTION("Records merge the chains of a child logger's context passed as their own")
+    {
+        Logger descendant = child;
+        Logger other_descendant = parent.with({{"other", "value"}});
+        for (int i = 0; i < 3; ++i)
+        {
+            descendant = descendant.with({{"depth" + std::to_string(i), i}});
+            other_descendant = other_descendant.with({{"other_depth" + std::to_string(i), i}});
+        }
+        // 10 links in all, beyond the 8 merged without allocating
+        REQUIRE(descendant.context_info().chain_depth() == ContextInfo::MAX_CHAIN_DEPTH);
+        REQUIRE(other_descendant.context_info().chain_depth() == ContextInfo::MAX_CHAIN_DEPTH);
+        std::vector<std::string> keys;
+        ContextInfo::merge({&descendant.context_info(), &other_descendant.context_info()},
+                           [&keys](ContextInfo::Entry const& entry) { keys.emplace_back(entry.key); });
+        REQUIRE(keys.size() == 10);
+    }
+}
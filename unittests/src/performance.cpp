@@ -1,5 +1,6 @@
 #include "octo-logger-cpp/logger.hpp"
 #include "octo-logger-cpp/manager.hpp"
+#include "octo-logger-cpp/json-writer.hpp"
 #include "logger-mock.hpp"
 #include <catch2/catch_all.hpp>
 #include <sys/types.h>
@@ -96,3 +97,28 @@ TEST_CASE_METHOD(LoggerPerformanceFixture, "Logger fork performance test: child
     }
 
 }
+
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+TEST_CASE("JSON string escaping throughput", "[json-writer][performance]")
+{
+    // A long mostly clean message, with the odd quote, newline and non-ASCII character
+    std::string message;
+    while (message.size() < 4096) {
+        message += "request handled for user \"octo\" in 12ms, payload size 2048 bytes\n";
+        message += "r\xc3\xa9sum\xc3\xa9 uploaded to the bucket without errors, continuing with the next item. ";
+    }
+    std::string out;
+    out.reserve(message.size() * 2);
+    for (auto const kernel : {octo::logger::JsonWriter::ScanKernel::SCALAR,
+                              octo::logger::JsonWriter::ScanKernel::SSE2,
+                              octo::logger::JsonWriter::ScanKernel::AVX2}) {
+        if (!octo::logger::JsonWriter::scan_kernel_supported(kernel)) {
+            continue;
+        }
+        BENCHMARK("escape 4KB message, kernel " + std::to_string(static_cast<int>(kernel))) {
+            out.clear();
+            return octo::logger::JsonWriter::append_string(out, message, kernel);
+        };
+    }
+}
+#endif // OCTO_LOGGER_WITH_JSON_FORMATTING
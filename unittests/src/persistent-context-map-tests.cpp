@@ -0,0 +1,78 @@
+/**
+ * @file persistent-context-map-tests.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <catch2/catch_all.hpp>
+
+#include "octo-logger-cpp/manager.hpp"
+#include "octo-logger-cpp/persistent-context-map.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+using octo::logger::ContextInfo;
+using octo::logger::PersistentContextMap;
+
+TEST_CASE("PersistentContextMap updates leave the previous versions untouched", "[persistent_context_map]")
+{
+    PersistentContextMap base;
+    for (int i = 0; i < 200; ++i)
+    {
+        base = base.set("pcm_key_" + std::to_string(i), i);
+    }
+    REQUIRE(base.size() == 200);
+
+    PersistentContextMap const updated = base.set("pcm_key_7", "seven").set("pcm_key_new", true);
+    REQUIRE(updated.size() == 201);
+    REQUIRE(base.size() == 200);
+    REQUIRE(base.find(ContextInfo::intern("pcm_key_7"))->value == 7);
+    REQUIRE(updated.find(ContextInfo::intern("pcm_key_7"))->value == "seven");
+    REQUIRE(base.find(ContextInfo::intern("pcm_key_new")) == nullptr);
+    // Setting values the map already has returns the same map
+    REQUIRE(updated.set("pcm_key_7", "seven").same_as(updated));
+    REQUIRE(updated.update(ContextInfo{{"pcm_key_8", 8}}).same_as(updated));
+    // The untouched entries are shared, not copied
+    REQUIRE(updated.find(ContextInfo::intern("pcm_key_8")) == base.find(ContextInfo::intern("pcm_key_8")));
+
+    ContextInfo expected;
+    for (int i = 0; i < 200; ++i)
+    {
+        expected.update("pcm_key_" + std::to_string(i), i == 7 ? ContextInfo::ContextInfoValue("seven")
+                                                               : ContextInfo::ContextInfoValue(i));
+    }
+    expected.update("pcm_key_new", true);
+    REQUIRE(updated.to_context_info() == expected);
+    REQUIRE(PersistentContextMap(expected).to_context_info() == expected);
+}
+
+TEST_CASE("Concurrent global context updates are never lost", "[persistent_context_map]")
+{
+    auto& manager = octo::logger::Manager::instance();
+    manager.replace_global_context_info({{"pcm_base", "base"}});
+    constexpr int THREADS = 4;
+    constexpr int UPDATES = 200;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&manager, t] {
+            for (int i = 0; i < UPDATES; ++i)
+            {
+                manager.update_global_context_info(
+                    {{"pcm_thread_" + std::to_string(t) + "_" + std::to_string(i), i}});
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    auto const global_context_info = manager.global_context_info();
+    REQUIRE(global_context_info->size() == THREADS * UPDATES + 1);
+    REQUIRE(global_context_info->at("pcm_thread_3_199") == 199);
+    octo::logger::Manager::reset_manager();
+}
@@ -17,6 +17,7 @@
 #include "octo-logger-cpp/context-info.hpp"
 #include "octo-logger-cpp/log-level.hpp"
 #include "octo-logger-cpp/log.hpp"
+#include "octo-logger-cpp/scoped-context.hpp"
 #include "octo-logger-cpp/sink-config.hpp"
 #include "octo-logger-cpp/sinks/console-json-sink.hpp"
 #include <nlohmann/json.hpp>
@@ -196,7 +197,7 @@ TEST_CASE("Test with properties", "[console-json-sink]")
                 CAPTURE(key.data());
                 REQUIRE(log_json["context_info"].contains(key));
                 REQUIRE(log_json["context_info"][key].is_string());
-                REQUIRE_THAT(log_json["context_info"][key].get<std::string>(), Catch::Matchers::Equals(value));
+                REQUIRE_THAT(log_json["context_info"][key].get<std::string>(), Catch::Matchers::Equals(value.to_string()));
             }
             for (auto const& [key, value] : global_context_info)
             {
@@ -208,7 +209,7 @@ TEST_CASE("Test with properties", "[console-json-sink]")
                 CAPTURE(key.data());
                 REQUIRE(log_json["context_info"].contains(key));
                 REQUIRE(log_json["context_info"][key].is_string());
-                REQUIRE_THAT(log_json["context_info"][key].get<std::string>(), Catch::Matchers::Equals(value));
+                REQUIRE_THAT(log_json["context_info"][key].get<std::string>(), Catch::Matchers::Equals(value.to_string()));
             }
             for (auto const& [key, value] :
                  log_json["context_info"].get<std::unordered_map<std::string, std::string>>())
@@ -269,3 +270,48 @@ TEST_CASE("Test log_thread_id configuration adds thread id to context_info", "[c
     REQUIRE(log_json["context_info"].contains("global_key"));
     REQUIRE(log_json["context_info"]["global_key"].get<std::string>() == "global_value");
 }
+
+TEST_CASE("Scoped context sits between the record and the logger context", "[console-json-sink][scoped-context]")
+{
+    octo::logger::ContextInfo const context_info = {{"scoped_vs_logger", "logger"}, {"logger_only", "logger"}};
+    octo::logger::ContextInfo const global_context_info = {{"scoped_vs_global", "global"}};
+    octo::logger::unittests::LoggerMock logger_mock;
+    octo::logger::ScopedContext const scope{{"scoped_vs_logger", "scoped"},
+                                            {"scoped_vs_global", "scoped"},
+                                            {"scoped_vs_log", "scoped"}};
+    octo::logger::unittests::LogMock log_mock(
+        octo::logger::LogLevel::INFO, "", {{"scoped_vs_log", "log"}}, logger_mock);
+    log_mock << "message";
+
+    octo::logger::SinkConfig sink_config("console_json_sink",
+                                         octo::logger::SinkConfig::SinkType::CONSOLE_JSON_SINK);
+    octo::logger::ConsoleJSONSink sink(sink_config);
+    std::string log_stdout;
+    CAPTURE_STDOUT(log_stdout, sink.dump(log_mock, logger_mock.logger_channel(), context_info, global_context_info));
+
+    nlohmann::json const log_json(nlohmann::json::parse(log_stdout));
+    REQUIRE(log_json["context_info"]["scoped_vs_log"] == "log");
+    REQUIRE(log_json["context_info"]["scoped_vs_logger"] == "scoped");
+    REQUIRE(log_json["context_info"]["scoped_vs_global"] == "scoped");
+    REQUIRE(log_json["context_info"]["logger_only"] == "logger");
+}
+
+TEST_CASE("Logger context chains are rendered with the nearest value of each key", "[console-json-sink]")
+{
+    auto const parent = std::make_shared<octo::logger::ContextInfo const>(
+        octo::logger::ContextInfo{{"chain_shared", "parent"}, {"chain_parent", 1}});
+    octo::logger::ContextInfo context_info = {{"chain_shared", "child"}};
+    context_info.set_parent(parent);
+    octo::logger::unittests::LoggerMock logger_mock;
+    octo::logger::unittests::LogMock log_mock(octo::logger::LogLevel::INFO, "", {}, logger_mock);
+    log_mock << "message";
+
+    octo::logger::SinkConfig sink_config("console_json_sink",
+                                         octo::logger::SinkConfig::SinkType::CONSOLE_JSON_SINK);
+    octo::logger::ConsoleJSONSink sink(sink_config);
+    std::string log_stdout;
+    CAPTURE_STDOUT(log_stdout, sink.dump(log_mock, logger_mock.logger_channel(), context_info, {}));
+
+    nlohmann::json const log_json(nlohmann::json::parse(log_stdout));
+    REQUIRE(log_json["context_info"] == nlohmann::json{{"chain_shared", "child"}, {"chain_parent", 1}});
+}
@@ -0,0 +1,805 @@
+/**
+ * @file file-sink-tests.cpp
+ * @brief
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <catch2/catch_all.hpp>
+
+#include "log-mock.hpp"
+#include "logger-mock.hpp"
+#include "octo-logger-cpp/log-bloom-filter.hpp"
+#include "octo-logger-cpp/log-level.hpp"
+#include "octo-logger-cpp/log-time-index.hpp"
+#include "octo-logger-cpp/log-timestamp-parser.hpp"
+#include "octo-logger-cpp/logger.hpp"
+#include "octo-logger-cpp/manager.hpp"
+#include "octo-logger-cpp/sink-config.hpp"
+#include "octo-logger-cpp/sinks/file-sink.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <regex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace
+{
+class FileSinkTestsFixture
+{
+  public:
+    std::string log_dir_;
+
+    FileSinkTestsFixture()
+    {
+        char dir_template[] = "/tmp/octo-file-sink-tests-XXXXXX";
+        log_dir_ = mkdtemp(dir_template);
+    }
+    ~FileSinkTestsFixture()
+    {
+        for (auto const& name : list_files())
+        {
+            unlink((log_dir_ + "/" + name).c_str());
+        }
+        rmdir(log_dir_.c_str());
+        octo::logger::Manager::reset_manager();
+    }
+
+    octo::logger::SinkConfig sink_config() const
+    {
+        octo::logger::SinkConfig config("file_sink", octo::logger::SinkConfig::SinkType::FILE_SINK);
+        config.set_option(octo::logger::SinkConfig::SinkOption::FILE_LOG_FILES_PATH, log_dir_);
+        config.set_option(octo::logger::SinkConfig::SinkOption::FILE_LOG_FOLDER_NO_SEPARATE_BY_DATE, true);
+        config.set_option(octo::logger::SinkConfig::SinkOption::FILE_NO_DATE_ON_NAME, true);
+        config.set_option(octo::logger::SinkConfig::SinkOption::FILE_NO_TIME_ON_NAME, true);
+        return config;
+    }
+
+    std::vector<std::string> list_files() const
+    {
+        std::vector<std::string> names;
+        std::unique_ptr<DIR, int (*)(DIR*)> dir{opendir(log_dir_.c_str()), closedir};
+        if (dir)
+        {
+            struct dirent* dir_entry;
+            while ((dir_entry = readdir(dir.get())) != nullptr)
+            {
+                std::string const name = dir_entry->d_name;
+                if (name != "." && name != "..")
+                {
+                    names.push_back(name);
+                }
+            }
+        }
+        return names;
+    }
+
+    std::vector<std::string> read_lines(std::string const& name) const
+    {
+        std::vector<std::string> lines;
+        std::ifstream file(log_dir_ + "/" + name);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+};
+
+void dump_message(octo::logger::Sink& sink, octo::logger::unittests::LoggerMock const& logger, std::string const& text)
+{
+    octo::logger::unittests::LogMock log(octo::logger::LogLevel::INFO, "", {}, logger);
+    log << text;
+    sink.dump(log, logger.logger_channel(), {}, {});
+}
+
+void dump_message_at(octo::logger::Sink& sink,
+                     octo::logger::unittests::LoggerMock const& logger,
+                     std::string const& text,
+                     std::int64_t timestamp_ms)
+{
+    octo::logger::unittests::LogMock log(octo::logger::LogLevel::INFO, "", {}, logger);
+    log.time_created() = std::chrono::system_clock::time_point(std::chrono::milliseconds(timestamp_ms));
+    log << text;
+    sink.dump(log, logger.logger_channel(), {}, {});
+}
+} // namespace
+
+TEST_CASE_METHOD(FileSinkTestsFixture, "Open files cap evicts and reopens channel files", "[file-sink]")
+{
+    std::size_t constexpr CHANNELS = 5;
+    std::size_t constexpr ROUNDS = 4;
+    auto config = sink_config();
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_SEPARATE_CHANNEL_FILES, true);
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_MAX_OPEN_FILES, 2);
+
+    std::vector<std::unique_ptr<octo::logger::unittests::LoggerMock>> loggers;
+    for (std::size_t i = 0; i < CHANNELS; ++i)
+    {
+        loggers.push_back(std::make_unique<octo::logger::unittests::LoggerMock>("channel" + std::to_string(i)));
+    }
+
+    {
+        octo::logger::FileSink sink(config);
+        for (std::size_t round = 0; round < ROUNDS; ++round)
+        {
+            for (std::size_t i = 0; i < CHANNELS; ++i)
+            {
+                dump_message(sink, *loggers[i], "round " + std::to_string(round));
+                REQUIRE(sink.open_files_stats().open_files <= 2);
+            }
+        }
+
+        auto const stats = sink.open_files_stats();
+        REQUIRE(stats.opens == CHANNELS);
+        // Round robin over more channels than the cap reopens every channel on every round but the first
+        REQUIRE(stats.reopens == CHANNELS * (ROUNDS - 1));
+        REQUIRE(stats.evictions == stats.opens + stats.reopens - 2);
+    }
+
+    auto const files = list_files();
+    REQUIRE(files.size() == CHANNELS);
+    for (auto const& name : files)
+    {
+        CAPTURE(name);
+        auto const lines = read_lines(name);
+        REQUIRE(lines.size() == ROUNDS);
+        for (std::size_t round = 0; round < ROUNDS; ++round)
+        {
+            REQUIRE(lines[round].find("round " + std::to_string(round)) != std::string::npos);
+        }
+    }
+}
+
+TEST_CASE_METHOD(FileSinkTestsFixture, "Open files cap evicts the files of concurrent threads", "[file-sink]")
+{
+    std::size_t constexpr CHANNELS = 16;
+    std::size_t constexpr THREADS = 8;
+    std::size_t constexpr ROUNDS = 200;
+    auto config = sink_config();
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_SEPARATE_CHANNEL_FILES, true);
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_MAX_OPEN_FILES, 4);
+
+    std::vector<std::unique_ptr<octo::logger::unittests::LoggerMock>> loggers;
+    for (std::size_t i = 0; i < CHANNELS; ++i)
+    {
+        loggers.push_back(std::make_unique<octo::logger::unittests::LoggerMock>("channel" + std::to_string(i)));
+    }
+
+    {
+        octo::logger::FileSink sink(config);
+        std::atomic<std::size_t> ready{0};
+        std::vector<std::thread> threads;
+        for (std::size_t thread_index = 0; thread_index < THREADS; ++thread_index)
+        {
+            threads.emplace_back([&, thread_index]() {
+                ++ready;
+                while (ready < THREADS)
+                {
+                    std::this_thread::yield();
+                }
+                // Each thread walks the channels from a different one, so files are evicted while others write them
+                for (std::size_t round = 0; round < ROUNDS; ++round)
+                {
+                    for (std::size_t i = 0; i < CHANNELS; ++i)
+                    {
+                        dump_message(sink, *loggers[(thread_index + i) % CHANNELS], "round " + std::to_string(round));
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        auto const stats = sink.open_files_stats();
+        REQUIRE(stats.open_files <= 4);
+        REQUIRE(stats.opens == CHANNELS);
+        REQUIRE(stats.evictions > 0);
+        REQUIRE(stats.opens + stats.reopens - stats.evictions == stats.open_files);
+    }
+
+    auto const files = list_files();
+    REQUIRE(files.size() == CHANNELS);
+    for (auto const& name : files)
+    {
+        CAPTURE(name);
+        REQUIRE(read_lines(name).size() == THREADS * ROUNDS);
+    }
+}
+
+TEST_CASE_METHOD(FileSinkTestsFixture, "Open files are not evicted without a cap", "[file-sink]")
+{
+    auto config = sink_config();
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_SEPARATE_CHANNEL_FILES, true);
+
+    octo::logger::unittests::LoggerMock logger_a("channel_a");
+    octo::logger::unittests::LoggerMock logger_b("channel_b");
+    octo::logger::unittests::LoggerMock logger_c("channel_c");
+    octo::logger::FileSink sink(config);
+    for (int round = 0; round < 3; ++round)
+    {
+        dump_message(sink, logger_a, "a");
+        dump_message(sink, logger_b, "b");
+        dump_message(sink, logger_c, "c");
+    }
+
+    auto const stats = sink.open_files_stats();
+    REQUIRE(stats.opens == 3);
+    REQUIRE(stats.reopens == 0);
+    REQUIRE(stats.evictions == 0);
+    REQUIRE(stats.open_files == 3);
+}
+
+TEST_CASE_METHOD(FileSinkTestsFixture, "Atomic append keeps records whole across forked writers", "[file-sink][fork]")
+{
+    int constexpr WRITERS = 8;
+    int constexpr RECORDS_PER_WRITER = 2000;
+    std::string const payload(200, 'x');
+    auto config = sink_config();
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_ATOMIC_APPEND, true);
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_SIZE_PER_LOG_FILE, 256 * 1024);
+
+    octo::logger::unittests::LoggerMock logger("atomic_append");
+    octo::logger::FileSink sink(config);
+    std::vector<pid_t> children;
+    for (int writer = 0; writer < WRITERS; ++writer)
+    {
+        pid_t const pid = fork();
+        if (pid == 0)
+        {
+            for (int record = 0; record < RECORDS_PER_WRITER; ++record)
+            {
+                dump_message(sink,
+                             logger,
+                             "writer " + std::to_string(writer) + " record " + std::to_string(record) + " " + payload +
+                                 " end");
+            }
+            _exit(0);
+        }
+        REQUIRE(pid > 0);
+        children.push_back(pid);
+    }
+    for (pid_t const pid : children)
+    {
+        int status = 0;
+        REQUIRE(waitpid(pid, &status, 0) == pid);
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) == 0);
+    }
+
+    std::regex const record_regex("^\\[.*\\]: writer (\\d+) record (\\d+) (x+) end$");
+    std::set<std::pair<int, int>> seen;
+    std::size_t log_files = 0;
+    for (auto const& name : list_files())
+    {
+        if (name.size() < 4 || name.compare(name.size() - 4, 4, ".log") != 0)
+        {
+            continue;
+        }
+        ++log_files;
+        for (auto const& line : read_lines(name))
+        {
+            std::smatch match;
+            CAPTURE(name, line);
+            REQUIRE(std::regex_match(line, match, record_regex));
+            REQUIRE(match[3].length() == static_cast<long>(payload.size()));
+            REQUIRE(seen.emplace(std::stoi(match[1]), std::stoi(match[2])).second);
+        }
+    }
+    REQUIRE(seen.size() == static_cast<std::size_t>(WRITERS * RECORDS_PER_WRITER));
+    // The writers rotated the shared files together instead of each process keeping its own segment
+    REQUIRE(log_files > 1);
+}
+
+TEST_CASE_METHOD(FileSinkTestsFixture,
+                 "Atomic append shares segments with the date and time in the file names",
+                 "[file-sink][fork]")
+{
+    int constexpr WRITERS = 8;
+    int constexpr RECORDS_PER_WRITER = 500;
+    long constexpr SIZE_PER_FILE = 64 * 1024;
+    std::string const payload(200, 'x');
+    auto config = sink_config();
+    config.remove_option(octo::logger::SinkConfig::SinkOption::FILE_NO_DATE_ON_NAME);
+    config.remove_option(octo::logger::SinkConfig::SinkOption::FILE_NO_TIME_ON_NAME);
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_ATOMIC_APPEND, true);
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_SIZE_PER_LOG_FILE, SIZE_PER_FILE);
+
+    octo::logger::unittests::LoggerMock logger("atomic_append");
+    std::vector<pid_t> children;
+    for (int writer = 0; writer < WRITERS; ++writer)
+    {
+        pid_t const pid = fork();
+        if (pid == 0)
+        {
+            // Each process opens its sink at a different time, the names of their first segments differ
+            std::this_thread::sleep_for(std::chrono::milliseconds(150 * writer));
+            octo::logger::FileSink sink(config);
+            for (int record = 0; record < RECORDS_PER_WRITER; ++record)
+            {
+                dump_message(sink,
+                             logger,
+                             "writer " + std::to_string(writer) + " record " + std::to_string(record) + " " + payload +
+                                 " end");
+            }
+            _exit(0);
+        }
+        REQUIRE(pid > 0);
+        children.push_back(pid);
+    }
+    for (pid_t const pid : children)
+    {
+        int status = 0;
+        REQUIRE(waitpid(pid, &status, 0) == pid);
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) == 0);
+    }
+
+    std::size_t records = 0;
+    std::size_t log_files = 0;
+    std::size_t partial_files = 0;
+    for (auto const& name : list_files())
+    {
+        if (name.size() < 4 || name.compare(name.size() - 4, 4, ".log") != 0)
+        {
+            continue;
+        }
+        ++log_files;
+        struct stat st = {};
+        REQUIRE(stat((log_dir_ + "/" + name).c_str(), &st) == 0);
+        if (st.st_size <= SIZE_PER_FILE)
+        {
+            ++partial_files;
+        }
+        records += read_lines(name).size();
+    }
+    REQUIRE(records == static_cast<std::size_t>(WRITERS * RECORDS_PER_WRITER));
+    REQUIRE(log_files > 1);
+    // Every segment but the current one was filled by all the writers together
+    REQUIRE(partial_files <= 1);
+}
+
+TEST_CASE_METHOD(FileSinkTestsFixture, "Records of concurrent threads are all written to the shared file", "[file-sink]")
+{
+    int constexpr THREADS = 8;
+    int constexpr RECORDS_PER_THREAD = 5000;
+    auto config = sink_config();
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_SIZE_PER_LOG_FILE, 64 * 1024);
+
+    auto manager_config = std::make_shared<octo::logger::ManagerConfig>();
+    manager_config->add_sink(config);
+    octo::logger::Manager::instance().configure(manager_config);
+    {
+        octo::logger::Logger const logger("concurrent");
+        std::atomic<int> ready{0};
+        std::vector<std::thread> threads;
+        for (int thread_index = 0; thread_index < THREADS; ++thread_index)
+        {
+            threads.emplace_back([&]() {
+                ++ready;
+                while (ready < THREADS)
+                {
+                    std::this_thread::yield();
+                }
+                for (int record = 0; record < RECORDS_PER_THREAD; ++record)
+                {
+                    logger.info() << "record " << record;
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+    octo::logger::Manager::reset_manager();
+
+    auto const files = list_files();
+    REQUIRE(files.size() > 1);
+    std::size_t records = 0;
+    octo::logger::LogTimestampParser parser;
+    for (auto const& name : files)
+    {
+        CAPTURE(name);
+        for (auto const& line : read_lines(name))
+        {
+            REQUIRE(parser.parse(line).has_value());
+            ++records;
+        }
+    }
+    REQUIRE(records == static_cast<std::size_t>(THREADS * RECORDS_PER_THREAD));
+}
+
+TEST_CASE_METHOD(FileSinkTestsFixture, "Thread shards write each thread to its own file", "[file-sink]")
+{
+    int constexpr THREADS = 8;
+    int constexpr RECORDS_PER_THREAD = 2000;
+    auto config = sink_config();
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_SHARD_PER_THREAD, true);
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_SIZE_PER_LOG_FILE, 16 * 1024);
+
+    auto manager_config = std::make_shared<octo::logger::ManagerConfig>();
+    manager_config->add_sink(config);
+    octo::logger::Manager::instance().configure(manager_config);
+    REQUIRE(list_files().empty());
+    {
+        octo::logger::Logger const logger("sharded");
+        // All the threads log at once, through the manager which leaves the locking to the sink
+        std::atomic<int> ready{0};
+        std::vector<std::thread> threads;
+        for (int thread_index = 0; thread_index < THREADS; ++thread_index)
+        {
+            threads.emplace_back([&, thread_index]() {
+                ++ready;
+                while (ready < THREADS)
+                {
+                    std::this_thread::yield();
+                }
+                for (int record = 0; record < RECORDS_PER_THREAD; ++record)
+                {
+                    logger.info() << "thread " << thread_index;
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+    octo::logger::Manager::reset_manager();
+
+    // ALL.t<tid>.log, ALL.t<tid>.1.log...
+    std::map<std::string, std::size_t> thread_records;
+    std::set<std::string> thread_messages;
+    octo::logger::LogTimestampParser parser;
+    for (auto const& name : list_files())
+    {
+        CAPTURE(name);
+        REQUIRE(name.rfind("ALL.t", 0) == 0);
+        std::string const thread_id = name.substr(5, name.find('.', 5) - 5);
+        auto const lines = read_lines(name);
+        REQUIRE_FALSE(lines.empty());
+        std::string const message = lines.front().substr(lines.front().rfind(": ") + 2);
+        for (auto const& line : lines)
+        {
+            REQUIRE(parser.parse(line).has_value());
+            REQUIRE(line.substr(line.rfind(": ") + 2) == message);
+        }
+        thread_records[thread_id] += lines.size();
+        thread_messages.insert(thread_id + " " + message);
+    }
+    REQUIRE(thread_records.size() == THREADS);
+    REQUIRE(thread_messages.size() == THREADS);
+    for (auto const& [thread_id, records] : thread_records)
+    {
+        CAPTURE(thread_id);
+        REQUIRE(records == RECORDS_PER_THREAD);
+    }
+}
+
+TEST_CASE_METHOD(FileSinkTestsFixture, "Thread shards of a forked child are its own", "[file-sink][fork]")
+{
+    auto config = sink_config();
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_SHARD_PER_THREAD, true);
+
+    octo::logger::unittests::LoggerMock logger("sharded");
+    {
+        octo::logger::FileSink sink(config);
+        dump_message(sink, logger, "parent");
+        pid_t const pid = fork();
+        if (pid == 0)
+        {
+            octo::logger::Manager::instance().child_on_fork();
+            dump_message(sink, logger, "child");
+            _exit(0);
+        }
+        REQUIRE(pid > 0);
+        int status = 0;
+        REQUIRE(waitpid(pid, &status, 0) == pid);
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) == 0);
+    }
+
+    auto const files = list_files();
+    REQUIRE(files.size() == 2);
+    std::set<std::string> messages;
+    for (auto const& name : files)
+    {
+        auto const lines = read_lines(name);
+        REQUIRE(lines.size() == 1);
+        messages.insert(lines.front().substr(lines.front().rfind(": ") + 2));
+    }
+    REQUIRE(messages == std::set<std::string>{"parent", "child"});
+}
+
+TEST_CASE_METHOD(FileSinkTestsFixture, "Pre-opened segments are swapped in on rotation", "[file-sink]")
+{
+    int constexpr RECORDS = 500;
+    auto config = sink_config();
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_SIZE_PER_LOG_FILE, 4 * 1024);
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_PREOPEN_FILL_RATIO, 0.5);
+
+    octo::logger::unittests::LoggerMock logger("preopen");
+    octo::logger::FileSink::OpenFilesStats stats{};
+    {
+        octo::logger::FileSink sink(config);
+        for (int record = 0; record < RECORDS; ++record)
+        {
+            dump_message(sink, logger, "record " + std::to_string(record));
+        }
+        stats = sink.open_files_stats();
+    }
+
+    auto files = list_files();
+    REQUIRE(files.size() > 2);
+    // Every rotation was served by a prepared segment, and the one prepared after the last rotation was removed
+    REQUIRE(stats.preopened_rotations == files.size() - 1);
+    // ALL.log, ALL.1.log, ALL.2.log...
+    auto const file_index = [](std::string const& name) { return name == "ALL.log" ? 0 : std::stoi(name.substr(4)); };
+    std::sort(files.begin(), files.end(), [&](std::string const& lhs, std::string const& rhs) {
+        return file_index(lhs) < file_index(rhs);
+    });
+    int next_record = 0;
+    for (auto const& name : files)
+    {
+        CAPTURE(name);
+        auto const lines = read_lines(name);
+        REQUIRE_FALSE(lines.empty());
+        for (auto const& line : lines)
+        {
+            REQUIRE(line.substr(line.rfind(": ") + 2) == "record " + std::to_string(next_record++));
+        }
+    }
+    REQUIRE(next_record == RECORDS);
+}
+
+TEST_CASE_METHOD(FileSinkTestsFixture, "Time index seeks to the records of a time range", "[file-sink]")
+{
+    int constexpr RECORDS = 1000;
+    std::int64_t constexpr BASE_MS = 1760000000000;
+    auto config = sink_config();
+    config.set_option(octo::logger::SinkConfig::SinkOption::USE_SAFE_LOCALTIME_UTC, true);
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_TIME_INDEX_RECORDS, 50);
+
+    octo::logger::unittests::LoggerMock logger("time_index");
+    {
+        octo::logger::FileSink sink(config);
+        for (int record = 0; record < RECORDS; ++record)
+        {
+            // One record per second, the third one is logged late
+            std::int64_t const timestamp = BASE_MS + (record == 2 ? 0 : record * 1000);
+            dump_message_at(sink, logger, "record " + std::to_string(record), timestamp);
+        }
+    }
+
+    std::string const segment = log_dir_ + "/ALL.log";
+    octo::logger::LogTimeIndex index;
+    REQUIRE(index.load(segment));
+    auto const& entries = index.entries();
+    REQUIRE(entries.size() == RECORDS / 50);
+    REQUIRE(entries.front().offset == 0);
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        REQUIRE_FALSE(entries[i].is_open());
+        REQUIRE(entries[i].min_timestamp_ms == BASE_MS + static_cast<std::int64_t>(i) * 50 * 1000);
+        REQUIRE(entries[i].max_timestamp_ms == BASE_MS + static_cast<std::int64_t>(i * 50 + 49) * 1000);
+        if (i > 0)
+        {
+            REQUIRE(entries[i].offset == entries[i - 1].end_offset);
+        }
+    }
+
+    std::int64_t const from = BASE_MS + 500 * 1000;
+    std::int64_t const to = BASE_MS + 619 * 1000;
+    REQUIRE(index.start_offset(from) == entries[10].offset);
+    REQUIRE(index.end_offset(to) == entries[13].offset);
+    REQUIRE(index.start_offset(BASE_MS) == 0);
+    REQUIRE(index.end_offset(BASE_MS + RECORDS * 1000) == entries.back().end_offset);
+
+    std::vector<std::string> records;
+    REQUIRE(octo::logger::LogTimeIndex::read_range(
+        segment, from, to, true, [&](std::string_view record) { records.emplace_back(record); }));
+    REQUIRE(records.size() == 120);
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        REQUIRE(records[i].find(": record " + std::to_string(500 + i) + "\n") != std::string::npos);
+    }
+
+    records.clear();
+    REQUIRE(octo::logger::LogTimeIndex::read_range(
+        segment, BASE_MS, BASE_MS, true, [&](std::string_view record) { records.emplace_back(record); }));
+    REQUIRE(records.size() == 2);
+}
+
+TEST_CASE_METHOD(FileSinkTestsFixture, "Time index keeps late records after a block boundary", "[file-sink]")
+{
+    int constexpr RECORDS = 40;
+    std::int64_t constexpr BASE_MS = 1760000000000;
+    auto config = sink_config();
+    config.set_option(octo::logger::SinkConfig::SinkOption::USE_SAFE_LOCALTIME_UTC, true);
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_TIME_INDEX_RECORDS, 10);
+
+    octo::logger::unittests::LoggerMock logger("time_index");
+    octo::logger::FileSink sink(config);
+    for (int record = 0; record < RECORDS; ++record)
+    {
+        // One record per second, the second record of the second block is logged 8 seconds late
+        std::int64_t const timestamp = BASE_MS + (record == 11 ? 3 : record) * 1000;
+        dump_message_at(sink, logger, "record " + std::to_string(record), timestamp);
+    }
+
+    std::string const segment = log_dir_ + "/ALL.log";
+    octo::logger::LogTimeIndex index;
+    REQUIRE(index.load(segment));
+    // The last block is still open, it may have records of any time
+    REQUIRE(index.entries().size() == RECORDS / 10);
+    REQUIRE(index.entries().back().is_open());
+    REQUIRE_FALSE(index.end_offset(BASE_MS).has_value());
+
+    auto const read = [&segment](std::int64_t from, std::int64_t to) {
+        std::vector<std::string> records;
+        REQUIRE(octo::logger::LogTimeIndex::read_range(
+            segment, from, to, true, [&](std::string_view record) { records.emplace_back(record); }));
+        return records;
+    };
+    auto records = read(BASE_MS + 3000, BASE_MS + 5000);
+    REQUIRE(records.size() == 4);
+    REQUIRE(records.back().find(": record 11\n") != std::string::npos);
+    REQUIRE(read(BASE_MS + 10000, BASE_MS + 12000).size() == 2);
+    REQUIRE(read(BASE_MS + 35000, BASE_MS + 50000).size() == 5);
+}
+
+TEST_CASE_METHOD(FileSinkTestsFixture, "Time index follows files reopened by the open files cap", "[file-sink]")
+{
+    int constexpr RECORDS = 20;
+    auto config = sink_config();
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_SEPARATE_CHANNEL_FILES, true);
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_MAX_OPEN_FILES, 1);
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_TIME_INDEX_RECORDS, 5);
+
+    octo::logger::unittests::LoggerMock logger_a("channel_a");
+    octo::logger::unittests::LoggerMock logger_b("channel_b");
+    {
+        octo::logger::FileSink sink(config);
+        // Every record evicts the other channel's segment, and its index with it
+        for (int record = 0; record < RECORDS; ++record)
+        {
+            dump_message(sink, logger_a, "a " + std::to_string(record));
+            dump_message(sink, logger_b, "b " + std::to_string(record));
+        }
+        REQUIRE(sink.open_files_stats().reopens == 2 * RECORDS - 2);
+    }
+
+    for (std::string const name : {"channel_a.1.log", "channel_b.1.log"})
+    {
+        CAPTURE(name);
+        octo::logger::LogTimeIndex index;
+        REQUIRE(index.load(log_dir_ + "/" + name));
+        auto const& entries = index.entries();
+        REQUIRE(entries.size() == RECORDS / 5);
+        REQUIRE(entries.front().offset == 0);
+        for (std::size_t i = 0; i + 1 < entries.size(); ++i)
+        {
+            REQUIRE(entries[i].end_offset == entries[i + 1].offset);
+        }
+        struct stat st = {};
+        REQUIRE(stat((log_dir_ + "/" + name).c_str(), &st) == 0);
+        REQUIRE(entries.back().end_offset == static_cast<std::uint64_t>(st.st_size));
+    }
+}
+
+TEST_CASE_METHOD(FileSinkTestsFixture, "Bloom filters are written for closed segments", "[file-sink]")
+{
+    int constexpr RECORDS = 600;
+    int constexpr SESSIONS = 12;
+    auto config = sink_config();
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_SIZE_PER_LOG_FILE, 8 * 1024);
+    config.set_option(octo::logger::SinkConfig::SinkOption::FILE_BLOOM_KEYS, "tenant_id,session_id");
+
+    octo::logger::unittests::LoggerMock logger("bloom");
+    {
+        octo::logger::FileSink sink(config);
+        for (int record = 0; record < RECORDS; ++record)
+        {
+            std::string const session = "session-" + std::to_string(record * SESSIONS / RECORDS);
+            octo::logger::unittests::LogMock log(octo::logger::LogLevel::INFO, session, {}, logger);
+            log << "record " << record;
+            sink.dump(log, logger.logger_channel(), {}, {{octo::logger::Logger::TenantID, "tenant-global"}});
+        }
+    }
+
+    std::size_t segments = 0;
+    for (auto const& name : list_files())
+    {
+        if (name.size() < 4 || name.compare(name.size() - 4, 4, ".log") != 0)
+        {
+            continue;
+        }
+        CAPTURE(name);
+        ++segments;
+        octo::logger::LogBloomFilter filter(0);
+        REQUIRE(filter.load(octo::logger::LogBloomFilter::filter_path(log_dir_ + "/" + name)));
+        REQUIRE(filter.may_contain(octo::logger::Logger::TenantID, "tenant-global"));
+        REQUIRE_FALSE(filter.may_contain(octo::logger::Logger::TenantID, "tenant-other"));
+        // Values are indexed under their key, the extra identifiers under their own
+        REQUIRE_FALSE(filter.may_contain(octo::logger::Logger::SessionID, "tenant-global"));
+        REQUIRE_FALSE(filter.may_contain(octo::logger::Logger::SessionID, "session-0"));
+
+        std::set<std::string> sessions;
+        for (auto const& line : read_lines(name))
+        {
+            auto const start = line.find("][session-");
+            REQUIRE(start != std::string::npos);
+            sessions.insert(line.substr(start + 2, line.find(']', start + 2) - start - 2));
+        }
+        for (int session = 0; session < SESSIONS; ++session)
+        {
+            std::string const session_id = "session-" + std::to_string(session);
+            bool const present =
+                filter.may_contain(octo::logger::LogBloomFilter::EXTRA_IDENTIFIER_KEY, session_id);
+            REQUIRE(present == (sessions.count(session_id) != 0));
+        }
+    }
+    REQUIRE(segments > 2);
+}
+
+TEST_CASE_METHOD(FileSinkTestsFixture, "Cached timestamp prefixes follow second boundaries", "[file-sink]")
+{
+    std::int64_t constexpr BASE_MS = 1760000000000;
+    std::vector<std::int64_t> const timestamps{BASE_MS + 998,
+                                               BASE_MS + 999,
+                                               BASE_MS + 1000,
+                                               BASE_MS + 1001,
+                                               BASE_MS + 1001,
+                                               BASE_MS + 59999,
+                                               BASE_MS + 60000,
+                                               BASE_MS + 86400000,
+                                               BASE_MS + 5};
+    std::vector<octo::logger::Sink::LineFormat> formats{octo::logger::Sink::LineFormat::PLAINTEXT_LONG};
+#ifdef OCTO_LOGGER_WITH_JSON_FORMATTING
+    formats.push_back(octo::logger::Sink::LineFormat::JSON);
+#endif
+    for (auto const format : formats)
+    {
+        DYNAMIC_SECTION("format " << static_cast<int>(format))
+        {
+            auto config = sink_config();
+            config.set_option(octo::logger::SinkConfig::SinkOption::USE_SAFE_LOCALTIME_UTC, true);
+            config.set_option(octo::logger::SinkConfig::SinkOption::LINE_FORMAT, static_cast<int>(format));
+            octo::logger::unittests::LoggerMock logger("timestamps");
+            {
+                octo::logger::FileSink sink(config);
+                for (auto const timestamp : timestamps)
+                {
+                    dump_message_at(sink, logger, "record", timestamp);
+                }
+            }
+
+            octo::logger::LogTimestampParser parser(true);
+            auto const lines = read_lines("ALL.log");
+            REQUIRE(lines.size() == timestamps.size());
+            for (std::size_t i = 0; i < lines.size(); ++i)
+            {
+                CAPTURE(lines[i]);
+                REQUIRE(parser.parse(lines[i]) == timestamps[i]);
+            }
+        }
+    }
+}